@@ -0,0 +1,199 @@
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+#include "consumer.h"
+#include "cv_based_threading.h"
+#include "deterministic_pipeline.h"
+#include "lock_free_queue.h"
+#include "number_storage.h"
+#include "output_sink.h"
+#include "producer.h"
+#include "random_source.h"
+#include "thread_safe_queue.h"
+
+namespace
+{
+
+constexpr size_t kQueueCapacity = 1000;
+constexpr size_t kProducersNr = 2;
+constexpr size_t kConsumersNr = 2;
+
+/**
+ * @class NullBuffer
+ * @brief A stream buffer that drops everything, to keep the workers' status lines quiet.
+ */
+class NullBuffer : public std::streambuf
+{
+   protected:
+    int overflow(int c) override { return c; }
+};
+
+/**
+ * @class SilencedOutput
+ * @brief Redirects std::cout to a NullBuffer for its lifetime.
+ */
+class SilencedOutput
+{
+   public:
+    SilencedOutput() : m_previous(std::cout.rdbuf(&m_buffer)) {}
+    ~SilencedOutput() { std::cout.rdbuf(m_previous); }
+
+    SilencedOutput(const SilencedOutput&) = delete;
+    SilencedOutput& operator=(const SilencedOutput&) = delete;
+
+   private:
+    NullBuffer m_buffer;         ///< Receives the silenced output.
+    std::streambuf* m_previous;  ///< The buffer restored on destruction.
+};
+
+/**
+ * @brief Complete generations of state.range(0) numbers with the Producer and Consumer classes.
+ *
+ * Two producers and two consumers share one queue, as in a default run of
+ * the application with --format=quiet. One item is one generated number.
+ */
+template <typename Queue>
+void BM_Pipeline(benchmark::State& state)
+{
+    const auto elementsNr = static_cast<int>(state.range(0));
+    SilencedOutput silenced;
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+    for (auto _ : state)
+    {
+        Queue queue(kQueueCapacity);
+        core::NumberStorage storage(static_cast<size_t>(elementsNr));
+        std::atomic_bool complete(false);
+
+        Consumer<Queue>::setStartTime();
+        std::vector<Producer<Queue>> producers;
+        std::vector<Consumer<Queue>> consumers;
+        for (size_t i = 0; i < kProducersNr; ++i)
+        {
+            producers.emplace_back(
+                queue, core::RandomSource(core::RandomEngine::Standard, elementsNr, 1, i),
+                complete);
+        }
+        for (size_t i = 0; i < kConsumersNr; ++i)
+        {
+            consumers.emplace_back(queue, storage, sink, elementsNr, complete);
+        }
+
+        std::vector<std::thread> threads;
+        for (auto& producer : producers)
+        {
+            threads.emplace_back([&producer]() { producer.produce(); });
+        }
+        for (auto& consumer : consumers)
+        {
+            threads.emplace_back([&consumer]() { consumer.consume(); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Complete generations of state.range(0) numbers with the condition variable approach.
+ *
+ * Two producers and two consumers share one ThreadSafeQueue, as in a run
+ * of the application with --cv --format=quiet. One item is one generated number.
+ */
+void BM_PipelineCv(benchmark::State& state)
+{
+    const auto elementsNr = static_cast<int>(state.range(0));
+    SilencedOutput silenced;
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+    for (auto _ : state)
+    {
+        core::ThreadSafeQueue<int> queue(kQueueCapacity);
+        core::NumberStorage storage(static_cast<size_t>(elementsNr));
+        std::atomic_bool complete(false);
+
+        initializeStartTime();
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < kProducersNr; ++i)
+        {
+            core::RandomSource random(core::RandomEngine::Standard, elementsNr, 1, i);
+            threads.emplace_back([&queue, random, &complete]()
+                                 { produce(queue, random, complete); });
+        }
+        for (size_t i = 0; i < kConsumersNr; ++i)
+        {
+            threads.emplace_back([&]() { consume(queue, storage, sink, elementsNr, complete); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Complete generations of state.range(0) numbers with the deterministic pipeline.
+ *
+ * Two producers feed the merger, as in a run of the application with
+ * --deterministic --format=quiet. Compared with BM_Pipeline, this is the
+ * cost of a reproducible sequence. One item is one generated number.
+ */
+void BM_PipelineDeterministic(benchmark::State& state)
+{
+    const auto elementsNr = static_cast<int>(state.range(0));
+    SilencedOutput silenced;
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+    for (auto _ : state)
+    {
+        core::NumberStorage storage(static_cast<size_t>(elementsNr));
+        DeterministicPipeline pipeline(storage, sink, elementsNr, core::RandomEngine::Standard, 1,
+                                       kProducersNr);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < kProducersNr; ++i)
+        {
+            threads.emplace_back([&pipeline, i]() { pipeline.produce(i); });
+        }
+        threads.emplace_back([&pipeline]() { pipeline.merge(); });
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Pipeline, core::ThreadSafeQueue<int>)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000)
+    ->ArgName("elements")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Pipeline, core::LockFreeQueue<int>)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000)
+    ->ArgName("elements")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_PipelineCv)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000)
+    ->ArgName("elements")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_PipelineDeterministic)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000)
+    ->ArgName("elements")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
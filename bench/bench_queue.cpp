@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "blocking_queue.h"
+#include "lock_free_queue.h"
+#include "thread_safe_queue.h"
+
+namespace
+{
+
+constexpr size_t kQueueCapacity = 1024;
+
+/**
+ * @brief Throughput of a shared queue under contention.
+ *
+ * Every thread alternates one push and one pop on the same queue, so the
+ * queue stays around half full and both ends are contended by all threads.
+ * state.range(0) is the capacity of the queue. One iteration is one
+ * push/pop pair.
+ */
+template <typename Queue>
+void BM_QueuePushPop(benchmark::State& state)
+{
+    static std::unique_ptr<Queue> queue;
+    if (state.thread_index() == 0)
+    {
+        queue = std::make_unique<Queue>(static_cast<size_t>(state.range(0)));
+    }
+
+    int value = 0;
+    for (auto _ : state)
+    {
+        while (!queue->tryPush(value))
+        {
+        }
+        while (!queue->tryPop(value))
+        {
+        }
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+    {
+        queue.reset();
+    }
+}
+
+/**
+ * @brief Throughput of a shared queue with bulk operations.
+ *
+ * Every thread alternates pushing and popping a batch of state.range(0)
+ * values. The queue is sized to hold one batch per thread, so a thread
+ * never waits on a push that only its own pops could unblock. One item
+ * is one value moved through the queue.
+ */
+template <typename Queue>
+void BM_QueueBulkPushPop(benchmark::State& state)
+{
+    const auto batchSize = static_cast<size_t>(state.range(0));
+    static std::unique_ptr<Queue> queue;
+    if (state.thread_index() == 0)
+    {
+        queue = std::make_unique<Queue>(batchSize * static_cast<size_t>(state.threads()));
+    }
+
+    std::vector<int> batch(batchSize);
+    for (auto _ : state)
+    {
+        std::span<const int> pending(batch);
+        while (!pending.empty())
+        {
+            pending = pending.subspan(queue->tryPushBulk(pending));
+        }
+        std::span<int> drained(batch);
+        while (!drained.empty())
+        {
+            drained = drained.subspan(queue->tryPopBulk(drained));
+        }
+        benchmark::DoNotOptimize(batch.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    if (state.thread_index() == 0)
+    {
+        queue.reset();
+    }
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_QueuePushPop, core::ThreadSafeQueue<int>)
+    ->ArgName("capacity")
+    ->Arg(16)
+    ->Arg(kQueueCapacity)
+    ->Arg(65536)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePushPop, core::LockFreeQueue<int>)
+    ->ArgName("capacity")
+    ->Arg(kQueueCapacity)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePushPop, core::BlockingQueue<int>)
+    ->ArgName("capacity")
+    ->Arg(kQueueCapacity)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_QueueBulkPushPop, core::ThreadSafeQueue<int>)
+    ->RangeMultiplier(4)
+    ->Range(1, 1024)
+    ->Threads(4)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueBulkPushPop, core::LockFreeQueue<int>)
+    ->RangeMultiplier(4)
+    ->Range(1, 1024)
+    ->Threads(4)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
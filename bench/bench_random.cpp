@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "random_source.h"
+
+namespace
+{
+
+/**
+ * @brief Throughput of a random source filling a buffer of 1024 numbers in 1..10^6.
+ *
+ * state.range(0) selects the core::RandomEngine. One item is one number.
+ */
+void BM_RandomSourceFill(benchmark::State& state)
+{
+    const auto engine = static_cast<core::RandomEngine>(state.range(0));
+    core::RandomSource random(engine, 1000000, 1, 0);
+    std::vector<int> values(1024);
+    for (auto _ : state)
+    {
+        random.fill(values);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+
+/**
+ * @brief Throughput of a random source handing out one number at a time with next().
+ */
+void BM_RandomSourceNext(benchmark::State& state)
+{
+    const auto engine = static_cast<core::RandomEngine>(state.range(0));
+    core::RandomSource random(engine, 1000000, 1, 0);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(random.next());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_RandomSourceFill)->DenseRange(0, 4)->ArgName("engine");
+BENCHMARK(BM_RandomSourceNext)->DenseRange(0, 4)->ArgName("engine");
@@ -0,0 +1,136 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "sharded_pipeline.h"
+#include "thread_safe_queue.h"
+
+namespace
+{
+
+constexpr size_t kQueueCapacity = 1024;
+constexpr int kValuesPerIteration = 1 << 16;
+
+/**
+ * @brief Throughput of k producers and k consumers sharing one queue.
+ *
+ * The benchmark runs 2k threads: the first k push kValuesPerIteration / k
+ * values per iteration, the others pop as many. One item is one value
+ * moved from a producer to a consumer.
+ */
+void BM_SharedQueueTopology(benchmark::State& state)
+{
+    static std::unique_ptr<core::ThreadSafeQueue<int>> queue;
+    if (state.thread_index() == 0)
+    {
+        queue = std::make_unique<core::ThreadSafeQueue<int>>(kQueueCapacity);
+    }
+
+    const int pairs = state.threads() / 2;
+    const int perThread = kValuesPerIteration / pairs;
+    const bool isProducer = state.thread_index() < pairs;
+    for (auto _ : state)
+    {
+        int value = 0;
+        for (int i = 0; i < perThread; ++i)
+        {
+            if (isProducer)
+            {
+                while (!queue->tryPush(i + 1))
+                {
+                    std::this_thread::yield();
+                }
+            }
+            else
+            {
+                while (!queue->tryPop(value))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations() * perThread);
+
+    if (state.thread_index() == 0)
+    {
+        queue.reset();
+    }
+}
+
+/**
+ * @brief Throughput of k producers and k consumers in the sharded topology.
+ *
+ * Same workload as BM_SharedQueueTopology, but every producer routes its
+ * values by ShardedQueues::shardOf() into its own SPSC queue to each
+ * consumer, and every consumer drains the queues from all producers.
+ */
+void BM_ShardedTopology(benchmark::State& state)
+{
+    static std::unique_ptr<ShardedQueues> queues;
+    const auto pairs = static_cast<size_t>(state.threads() / 2);
+    if (state.thread_index() == 0)
+    {
+        queues = std::make_unique<ShardedQueues>(pairs, pairs, kQueueCapacity);
+    }
+
+    const int perThread = kValuesPerIteration / static_cast<int>(pairs);
+    const auto index = static_cast<size_t>(state.thread_index());
+    const bool isProducer = index < pairs;
+    for (auto _ : state)
+    {
+        int value = 0;
+        if (isProducer)
+        {
+            // Values 1..perThread are spread evenly over the shards
+            for (int i = 1; i <= perThread; ++i)
+            {
+                auto& queue = queues->queue(index, queues->shardOf(i));
+                while (!queue.tryPush(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        else
+        {
+            const size_t consumer = index - pairs;
+            const size_t perProducer = queues->shardSize(consumer, static_cast<size_t>(perThread));
+            // Drain the producers round robin, a consumer waiting on one producer
+            // could otherwise block another producer on a full queue.
+            std::vector<size_t> remaining(pairs, perProducer);
+            size_t total = perProducer * pairs;
+            while (total > 0)
+            {
+                const size_t before = total;
+                for (size_t producer = 0; producer < pairs; ++producer)
+                {
+                    if (remaining[producer] > 0 && queues->queue(producer, consumer).tryPop(value))
+                    {
+                        --remaining[producer];
+                        --total;
+                    }
+                }
+                if (total == before)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations() * perThread);
+
+    if (state.thread_index() == 0)
+    {
+        queues.reset();
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_SharedQueueTopology)->Threads(2)->Threads(4)->Threads(8)->Threads(16)->UseRealTime();
+BENCHMARK(BM_ShardedTopology)->Threads(2)->Threads(4)->Threads(8)->Threads(16)->UseRealTime();
@@ -0,0 +1,150 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "dedup_kernel.h"
+#include "number_storage.h"
+
+namespace
+{
+
+/**
+ * @struct PackedNumberInfo
+ * @brief The former array-of-structures layout: order and time side by side, 16 bytes per number.
+ */
+struct PackedNumberInfo
+{
+    std::atomic<size_t> m_order = 0;  ///< The order in which the number was generated.
+    long long m_generationTime = 0;   ///< The time taken to generate the number.
+};
+
+/**
+ * @brief Draws a pseudo-random number in 1..elements.
+ *
+ * A 64-bit LCG keeps the cost of the draw small next to the storage access.
+ *
+ * @param state The generator state, advanced by the call.
+ * @param elements The number of elements.
+ */
+int draw(uint64_t& state, int elements)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<int>((state >> 33) % static_cast<uint64_t>(elements)) + 1;
+}
+
+/**
+ * @brief Complete runs over the packed layout, one compare-and-swap per draw.
+ *
+ * One iteration draws numbers in 1..state.range(0) until every number is
+ * recorded, so duplicates dominate as in a real run. One item is one draw.
+ */
+void BM_PackedStorage(benchmark::State& state)
+{
+    const auto elements = static_cast<int>(state.range(0));
+    uint64_t seed = 1;
+    int64_t draws = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<PackedNumberInfo> storage(static_cast<size_t>(elements));
+        state.ResumeTiming();
+
+        size_t order = 1;
+        while (order <= static_cast<size_t>(elements))
+        {
+            const int value = draw(seed, elements);
+            auto& info = storage[static_cast<size_t>(value - 1)];
+            size_t expected = 0;
+            if (info.m_order.compare_exchange_strong(expected, order))
+            {
+                info.m_generationTime = 1;
+                ++order;
+            }
+            ++draws;
+        }
+        benchmark::DoNotOptimize(storage.data());
+    }
+    state.SetItemsProcessed(draws);
+}
+
+/**
+ * @brief Complete runs over core::NumberStorage, one fetch_or on the bitset per draw.
+ *
+ * Same workload as BM_PackedStorage. state.range(1) selects whether the
+ * generation time column is kept.
+ */
+void BM_NumberStorage(benchmark::State& state)
+{
+    const auto elements = static_cast<int>(state.range(0));
+    const bool recordTimes = state.range(1) != 0;
+    uint64_t seed = 1;
+    int64_t draws = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        core::NumberStorage storage(static_cast<size_t>(elements), recordTimes);
+        state.ResumeTiming();
+
+        size_t order = 1;
+        while (order <= static_cast<size_t>(elements))
+        {
+            const int value = draw(seed, elements);
+            if (storage.tryMark(value))
+            {
+                storage.record(value, order++, 1);
+            }
+            ++draws;
+        }
+        benchmark::DoNotOptimize(&storage);
+    }
+    state.SetItemsProcessed(draws);
+}
+
+/**
+ * @brief Complete runs over a dedup bitset, marking batches of 64 draws with a markNew() kernel.
+ *
+ * Same workload as BM_NumberStorage, without the columns. state.range(1)
+ * selects the kernel, state.range(0) the number of elements.
+ */
+void BM_MarkNew(benchmark::State& state)
+{
+    const auto elements = static_cast<int>(state.range(0));
+    const auto kernel = static_cast<core::DedupKernel>(state.range(1));
+    if (!core::dedupKernelSupported(kernel))
+    {
+        state.SkipWithError("kernel not supported by the CPU");
+        return;
+    }
+    uint64_t seed = 1;
+    int64_t draws = 0;
+    std::array<int, 64> batch{};
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<std::atomic<uint64_t>> bits((static_cast<size_t>(elements) + 63) / 64);
+        state.ResumeTiming();
+
+        size_t marked = 0;
+        while (marked < static_cast<size_t>(elements))
+        {
+            for (int& value : batch)
+            {
+                value = draw(seed, elements);
+            }
+            marked += core::markNew(kernel, bits.data(), std::span<int>(batch));
+            draws += static_cast<int64_t>(batch.size());
+        }
+        benchmark::DoNotOptimize(bits.data());
+    }
+    state.SetItemsProcessed(draws);
+}
+
+}  // namespace
+
+BENCHMARK(BM_PackedStorage)->RangeMultiplier(8)->Range(1 << 12, 1 << 21);
+BENCHMARK(BM_NumberStorage)->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 21, 8), {0, 1}});
+BENCHMARK(BM_MarkNew)->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 21, 8), {0, 1, 2}});
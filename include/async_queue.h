@@ -0,0 +1,266 @@
+#pragma once
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "thread_pool.h"
+
+namespace core
+{
+
+/**
+ * @class AsyncQueue
+ * @brief A bounded queue whose coroutines suspend instead of spinning while it is full or empty.
+ *
+ * co_await push(value) suspends the calling coroutine while the queue is
+ * full, and co_await pop() while it is empty. A suspended coroutine holds
+ * no thread: it is parked in a list of waiters, and the operation that
+ * makes room or brings a value hands it back to the ThreadPool. A value
+ * pushed while coroutines wait to pop goes straight to the first of them.
+ * Plain threads can pop too, with popWait(), which blocks on a condition
+ * variable.
+ *
+ * close() wakes everyone: pushes fail from then on, and pops drain the
+ * values left before reporting the end.
+ *
+ * @tparam T The type of the elements.
+ */
+template <typename T>
+class AsyncQueue
+{
+   public:
+    using value_type = T;
+
+    /**
+     * @class PushAwaiter
+     * @brief The awaitable of push().
+     */
+    class PushAwaiter
+    {
+       public:
+        PushAwaiter(AsyncQueue& queue, T value) : m_queue(&queue), m_value(std::move(value)) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            return m_queue->suspendPush(*this, handle);
+        }
+
+        /**
+         * @return false if the queue was closed and the value dropped.
+         */
+        bool await_resume() const noexcept { return m_pushed; }
+
+       private:
+        friend class AsyncQueue;
+
+        AsyncQueue* m_queue;               ///< The queue pushed to.
+        T m_value;                         ///< The value to push.
+        bool m_pushed = false;             ///< Whether the value got into the queue.
+        std::coroutine_handle<> m_handle;  ///< The suspended coroutine, while it waits.
+    };
+
+    /**
+     * @class PopAwaiter
+     * @brief The awaitable of pop().
+     */
+    class PopAwaiter
+    {
+       public:
+        explicit PopAwaiter(AsyncQueue& queue) : m_queue(&queue) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            return m_queue->suspendPop(*this, handle);
+        }
+
+        /**
+         * @return The popped value, or std::nullopt once the queue is closed and drained.
+         */
+        std::optional<T> await_resume() noexcept { return std::move(m_value); }
+
+       private:
+        friend class AsyncQueue;
+
+        AsyncQueue* m_queue;               ///< The queue popped from.
+        std::optional<T> m_value;          ///< The popped value.
+        std::coroutine_handle<> m_handle;  ///< The suspended coroutine, while it waits.
+    };
+
+    /**
+     * @brief Constructs an empty queue.
+     *
+     * @param capacity The maximal number of values held, at least 1.
+     * @param pool The pool resuming the coroutines that waited.
+     */
+    AsyncQueue(size_t capacity, ThreadPool& pool)
+        : m_capacity(capacity > 0 ? capacity : 1), m_pool(&pool)
+    {
+    }
+
+    AsyncQueue(const AsyncQueue&) = delete;
+    AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+    /**
+     * @brief Pushes a value, suspending while the queue is full. Coroutines only.
+     *
+     * @param value The value to push.
+     * @return An awaitable yielding false if the queue is closed.
+     */
+    [[nodiscard]] PushAwaiter push(T value) { return PushAwaiter(*this, std::move(value)); }
+
+    /**
+     * @brief Pops a value, suspending while the queue is empty. Coroutines only.
+     *
+     * @return An awaitable yielding the value, or std::nullopt once the
+     *         queue is closed and drained.
+     */
+    [[nodiscard]] PopAwaiter pop() { return PopAwaiter(*this); }
+
+    /**
+     * @brief Pops a value, blocking the calling thread while the queue is empty.
+     *
+     * @return The value, or std::nullopt once the queue is closed and drained.
+     */
+    [[nodiscard]] std::optional<T> popWait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_closed || !m_values.empty(); });
+        if (m_values.empty())
+        {
+            return std::nullopt;
+        }
+        return takeFront();
+    }
+
+    /**
+     * @brief Closes the queue and wakes every waiting coroutine and thread.
+     *
+     * Further calls do nothing.
+     */
+    void close()
+    {
+        std::deque<PushAwaiter*> pushers;
+        std::deque<PopAwaiter*> poppers;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            pushers.swap(m_pushers);
+            poppers.swap(m_poppers);
+        }
+        m_cv.notify_all();
+        for (PushAwaiter* pusher : pushers)
+        {
+            m_pool->schedule(pusher->m_handle);
+        }
+        for (PopAwaiter* popper : poppers)
+        {
+            m_pool->schedule(popper->m_handle);
+        }
+    }
+
+   private:
+    /**
+     * @brief Pushes the value of an awaiter, or parks its coroutine while the queue is full.
+     *
+     * @return true if the coroutine is parked.
+     */
+    bool suspendPush(PushAwaiter& pusher, std::coroutine_handle<> handle)
+    {
+        PopAwaiter* popper = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closed)
+            {
+                return false;
+            }
+            pusher.m_pushed = true;
+            if (!m_poppers.empty())
+            {
+                // Hand the value over to the first coroutine waiting for one
+                popper = m_poppers.front();
+                m_poppers.pop_front();
+                popper->m_value = std::move(pusher.m_value);
+            }
+            else if (m_values.size() < m_capacity)
+            {
+                m_values.push_back(std::move(pusher.m_value));
+            }
+            else
+            {
+                // The coroutine may be resumed by another thread once the lock is released
+                pusher.m_pushed = false;
+                pusher.m_handle = handle;
+                m_pushers.push_back(&pusher);
+                return true;
+            }
+        }
+        if (popper != nullptr)
+        {
+            m_pool->schedule(popper->m_handle);
+        }
+        else
+        {
+            m_cv.notify_one();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Pops a value into an awaiter, or parks its coroutine while the queue is empty.
+     *
+     * @return true if the coroutine is parked.
+     */
+    bool suspendPop(PopAwaiter& popper, std::coroutine_handle<> handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_values.empty())
+        {
+            popper.m_value = takeFront();
+            return false;
+        }
+        if (m_closed)
+        {
+            return false;
+        }
+        popper.m_handle = handle;
+        m_poppers.push_back(&popper);
+        return true;
+    }
+
+    /**
+     * @brief Takes the front value and lets the first waiting pusher in. The lock must be held.
+     */
+    T takeFront()
+    {
+        T value = std::move(m_values.front());
+        m_values.pop_front();
+        if (!m_pushers.empty())
+        {
+            PushAwaiter* pusher = m_pushers.front();
+            m_pushers.pop_front();
+            m_values.push_back(std::move(pusher->m_value));
+            pusher->m_pushed = true;
+            m_pool->schedule(pusher->m_handle);
+        }
+        return value;
+    }
+
+    const size_t m_capacity;             ///< The maximal number of values held.
+    ThreadPool* m_pool;                  ///< The pool resuming the coroutines that waited.
+    std::mutex m_mutex;                  ///< Protects the members below.
+    std::condition_variable m_cv;        ///< Signals values and closing to threads in popWait().
+    std::deque<T> m_values;              ///< The values, in FIFO order.
+    std::deque<PushAwaiter*> m_pushers;  ///< Coroutines waiting for room.
+    std::deque<PopAwaiter*> m_poppers;   ///< Coroutines waiting for a value.
+    bool m_closed = false;               ///< Set by close().
+};
+
+}  // namespace core
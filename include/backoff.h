@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <thread>
+
+namespace core
+{
+
+/**
+ * @class Backoff
+ * @brief Adaptive backoff for threads waiting on a contended or empty resource.
+ *
+ * Each call to pause() waits a little longer than the previous one: first
+ * by spinning with a CPU relax hint for an exponentially growing number of
+ * iterations, then by yielding the time slice. Once both budgets are spent,
+ * pause() returns false to tell the caller to stop polling and park the
+ * thread instead, so that an idle thread does not burn a core.
+ */
+class Backoff
+{
+   public:
+    /**
+     * @brief Waits for the current backoff step and advances to the next one.
+     *
+     * @return true if the caller should retry, false if it should park.
+     */
+    bool pause() noexcept
+    {
+        if (m_step < kSpinSteps)
+        {
+            for (uint32_t i = 0; i < (1U << m_step); ++i)
+            {
+                cpuRelax();
+            }
+        }
+        else if (m_step < kSpinSteps + kYieldSteps)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            return false;
+        }
+        ++m_step;
+        return true;
+    }
+
+    /**
+     * @brief Restarts the backoff from the shortest spin.
+     */
+    void reset() noexcept { m_step = 0; }
+
+   private:
+    /**
+     * @brief Hints the CPU that the thread is in a spin-wait loop.
+     */
+    static void cpuRelax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    static constexpr uint32_t kSpinSteps = 7;   ///< Spin steps, from 1 up to 64 relax hints.
+    static constexpr uint32_t kYieldSteps = 4;  ///< Yield steps after spinning.
+    uint32_t m_step = 0;                        ///< The current backoff step.
+};
+
+}  // namespace core
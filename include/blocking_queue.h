@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <thread>
+
+#include "backoff.h"
+#include "cache_line.h"
+#include "lock_free_queue.h"
+
+namespace core
+{
+
+/**
+ * @class BlockingQueue
+ * @brief A bounded queue whose push and pop block instead of failing.
+ *
+ * Values are stored in a LockFreeQueue. A thread that cannot proceed first
+ * backs off (spin, then yield) and then parks with std::atomic::wait. A
+ * thread only parks after it has found the queue full (pushers) or empty
+ * (poppers), and a push or pop only issues a notification when a parked
+ * thread exists. So notifications are limited to the full to non-full and
+ * empty to non-empty transitions that parked threads are waiting for, and
+ * the steady state never touches the kernel.
+ *
+ * close() wakes every parked thread and makes further blocking calls fail,
+ * which is how a pipeline shuts down threads waiting on the queue.
+ *
+ * @tparam T The type of elements stored in the queue.
+ */
+template <typename T>
+class BlockingQueue
+{
+   public:
+    using value_type = T;
+
+    /**
+     * @brief Constructor for a BlockingQueue with a fixed size.
+     *
+     * @param size The minimal capacity of the queue, rounded up to a power of two.
+     */
+    explicit BlockingQueue(size_t size) : m_ring(size) {}
+
+    /**
+     * @brief Attempts to push a value to the queue without blocking.
+     *
+     * @param val The value to be added to the queue.
+     * @return true if the value was successfully added, false if the queue is full.
+     */
+    [[nodiscard]] bool tryPush(const T& val)
+    {
+        if (!m_ring.tryPush(val))
+        {
+            return false;
+        }
+        notify(m_notEmpty, 1);
+        return true;
+    }
+
+    /**
+     * @brief Attempts to pop a value from the queue without blocking.
+     *
+     * @param[out] val The value that was removed from the queue.
+     * @return true if a value was successfully removed, false if the queue was empty.
+     */
+    [[nodiscard]] bool tryPop(T& val)
+    {
+        if (!m_ring.tryPop(val))
+        {
+            return false;
+        }
+        notify(m_notFull, 1);
+        return true;
+    }
+
+    /**
+     * @brief Attempts to push a batch of values to the queue without blocking.
+     *
+     * @param vals The values to be added to the queue.
+     * @return The number of values added from the front of the batch.
+     */
+    [[nodiscard]] size_t tryPushBulk(std::span<const T> vals)
+    {
+        const size_t count = m_ring.tryPushBulk(vals);
+        if (count > 0)
+        {
+            notify(m_notEmpty, count);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Attempts to pop a batch of values from the queue without blocking.
+     *
+     * @param[out] vals The buffer receiving the removed values, in FIFO order.
+     * @return The number of values written to the front of the buffer.
+     */
+    [[nodiscard]] size_t tryPopBulk(std::span<T> vals)
+    {
+        const size_t count = m_ring.tryPopBulk(vals);
+        if (count > 0)
+        {
+            notify(m_notFull, count);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Pushes a value, blocking while the queue is full.
+     *
+     * @param val The value to be added to the queue.
+     * @return true if the value was added, false if the queue was closed.
+     */
+    bool push(const T& val)
+    {
+        return blockUntil([&]() { return tryPush(val); }, m_notFull);
+    }
+
+    /**
+     * @brief Pops a value, blocking while the queue is empty.
+     *
+     * Values still queued when the queue is closed can be popped.
+     *
+     * @param[out] val The value that was removed from the queue.
+     * @return true if a value was removed, false if the queue is closed and empty.
+     */
+    bool pop(T& val)
+    {
+        return blockUntil([&]() { return tryPop(val); }, m_notEmpty);
+    }
+
+    /**
+     * @brief Pops a value, blocking for at most the given time while the queue is empty.
+     *
+     * C++20 has no timed std::atomic::wait, so once spinning and yielding
+     * are exhausted this method parks in sleeps that double from
+     * kMinTimedSleep up to kMaxTimedSleep, bounded by the deadline.
+     *
+     * @param[out] val The value that was removed from the queue.
+     * @param timeout The maximal time to wait.
+     * @return true if a value was removed, false on timeout or if the queue is closed and empty.
+     */
+    template <typename Rep, typename Period>
+    [[nodiscard]] bool popFor(T& val, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::chrono::steady_clock::duration sleep = kMinTimedSleep;
+        Backoff backoff;
+        for (;;)
+        {
+            if (tryPop(val))
+            {
+                return true;
+            }
+            if (m_closed.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (backoff.pause())
+            {
+                continue;
+            }
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::min(sleep, deadline - now));
+            sleep = std::min<std::chrono::steady_clock::duration>(sleep * 2, kMaxTimedSleep);
+        }
+    }
+
+    /**
+     * @brief Closes the queue and wakes every parked thread.
+     *
+     * Blocking pushes fail from now on, blocking pops fail once the queue is empty.
+     */
+    void close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        for (Signal* signal : {&m_notEmpty, &m_notFull})
+        {
+            signal->m_epoch.fetch_add(1, std::memory_order_release);
+            signal->m_epoch.notify_all();
+        }
+    }
+
+    /**
+     * @brief Returns the real capacity of the queue.
+     *
+     * @return The number of slots, i.e. the requested size rounded up to a power of two.
+     */
+    [[nodiscard]] size_t capacity() const noexcept { return m_ring.capacity(); }
+
+   private:
+    /**
+     * @struct Signal
+     * @brief A wait word that parked threads sleep on, with the count of parked threads.
+     */
+    struct alignas(kCacheLineSize) Signal
+    {
+        std::atomic<uint32_t> m_epoch{0};    ///< Bumped on every wake-up.
+        std::atomic<uint32_t> m_waiters{0};  ///< Number of threads parked (or parking).
+    };
+
+    /**
+     * @brief Wakes threads parked on a signal, if there are any.
+     *
+     * @param signal The signal to notify.
+     * @param count The number of values that became available (or slots that were freed).
+     */
+    static void notify(Signal& signal, size_t count)
+    {
+        // Pairs with the fence in blockUntil: either the parking thread sees the queue change,
+        // or this thread sees it registered as a waiter.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (signal.m_waiters.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+        signal.m_epoch.fetch_add(1, std::memory_order_release);
+        if (count == 1)
+        {
+            signal.m_epoch.notify_one();
+        }
+        else
+        {
+            signal.m_epoch.notify_all();
+        }
+    }
+
+    /**
+     * @brief Retries an operation with adaptive backoff until it succeeds or the queue closes.
+     *
+     * @param tryOperation The non-blocking operation, returning true on success.
+     * @param signal The signal notified when the operation may succeed again.
+     * @return true if the operation succeeded, false if the queue was closed.
+     */
+    template <typename TryOperation>
+    bool blockUntil(TryOperation tryOperation, Signal& signal)
+    {
+        Backoff backoff;
+        for (;;)
+        {
+            if (tryOperation())
+            {
+                return true;
+            }
+            if (m_closed.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (backoff.pause())
+            {
+                continue;
+            }
+
+            // Register as a waiter, then check once more before parking, so that a concurrent
+            // notifier cannot miss this thread.
+            const uint32_t epoch = signal.m_epoch.load(std::memory_order_acquire);
+            signal.m_waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const bool succeeded = tryOperation();
+            if (!succeeded && !m_closed.load(std::memory_order_acquire))
+            {
+                signal.m_epoch.wait(epoch, std::memory_order_acquire);
+            }
+            signal.m_waiters.fetch_sub(1, std::memory_order_relaxed);
+            if (succeeded)
+            {
+                return true;
+            }
+            backoff.reset();
+        }
+    }
+
+    static constexpr std::chrono::microseconds kMinTimedSleep{50};  ///< First popFor sleep.
+    static constexpr std::chrono::milliseconds kMaxTimedSleep{1};   ///< Longest popFor sleep.
+
+    LockFreeQueue<T> m_ring;           ///< The underlying lock-free ring buffer.
+    Signal m_notEmpty;                 ///< Parked poppers wait here.
+    Signal m_notFull;                  ///< Parked pushers wait here.
+    std::atomic_bool m_closed{false};  ///< Set by close().
+};
+
+/**
+ * @brief Queue types whose push and pop block until they can proceed.
+ */
+template <typename Queue>
+concept BlockingQueueType = requires(Queue& queue, typename Queue::value_type& value) {
+    { queue.push(value) } -> std::same_as<bool>;
+    { queue.pop(value) } -> std::same_as<bool>;
+    queue.close();
+};
+
+}  // namespace core
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+namespace core
+{
+
+/**
+ * @brief Assumed size of a cache line in bytes.
+ *
+ * Used to align independently written shared state onto separate cache
+ * lines so that threads updating one variable do not invalidate the line
+ * holding another (false sharing).
+ */
+inline constexpr std::size_t kCacheLineSize = 64;
+
+}  // namespace core
@@ -0,0 +1,151 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace core
+{
+
+/**
+ * @struct CapacityTuning
+ * @brief Options of a CapacityTuner.
+ */
+struct CapacityTuning
+{
+    size_t m_initialCapacity = 1000;                 ///< Capacity to start from.
+    size_t m_minCapacity = 16;                       ///< Smallest capacity.
+    size_t m_maxCapacity = size_t{1} << 16;          ///< Largest capacity.
+    double m_lowWatermark = 0.01;                    ///< Rates at most this are low.
+    double m_highWatermark = 0.1;                    ///< Rates above this are high.
+    std::chrono::microseconds m_maxResidency{1000};  ///< Mean residency not to exceed.
+    size_t m_window = 4096;                          ///< Operations per decision.
+    size_t m_floorWindows = 16;                      ///< Windows a grown capacity is kept.
+};
+
+/**
+ * @class CapacityTuner
+ * @brief Chooses the effective capacity of a queue from how full and how empty it runs.
+ *
+ * The queue reports every push and pop call to the tuner. Over windows of
+ * m_window calls, the tuner measures the full rate (push calls cut short
+ * because the queue was at capacity), the empty rate (pop calls that found
+ * nothing) and the residency, the average time an element waits in the
+ * queue. The residency follows from Little's law, as the mean occupancy
+ * over the pop throughput, so no element is timestamped. At the end of a
+ * window:
+ * - full and empty rates both above their watermarks mean the queue flips
+ *   between full and empty: it is too small to absorb the bursts of either
+ *   side, and the capacity doubles;
+ * - a full rate above the high watermark, or a residency above the target,
+ *   while consumers rarely find the queue empty, means the consumers set
+ *   the pace: a larger queue only holds elements longer and spreads them
+ *   over more cache lines, so the capacity halves and producers wait sooner.
+ *
+ * After growing, the capacity does not shrink back below the capacity it
+ * grew to for m_floorWindows windows, so it settles instead of
+ * oscillating. Once that many windows pass without growth, the floor
+ * returns to the smallest capacity, so that a burst at startup, while the
+ * consumers spin up, does not pin a large capacity for the whole run. The
+ * tuner is not thread-safe: the queue calls it under its own lock.
+ */
+class CapacityTuner
+{
+   public:
+    /**
+     * @struct Summary
+     * @brief The chosen capacity and the measures of the last window.
+     */
+    struct Summary
+    {
+        size_t m_capacity = 0;                    ///< The current capacity.
+        size_t m_initialCapacity = 0;             ///< The capacity the tuner started from.
+        size_t m_resizes = 0;                     ///< Number of capacity changes.
+        size_t m_windows = 0;                     ///< Number of windows closed.
+        double m_fullRate = 0.0;                  ///< Share of push calls cut short, last window.
+        double m_emptyRate = 0.0;                 ///< Share of empty pop calls, last window.
+        std::chrono::nanoseconds m_residency{0};  ///< Mean residency, last window.
+    };
+
+    /**
+     * @brief Constructs a tuner starting from the initial capacity.
+     *
+     * @param tuning The options; a largest capacity below the smallest is raised to it, and
+     *               the initial capacity is clamped into the allowed range.
+     */
+    explicit CapacityTuner(const CapacityTuning& tuning);
+
+    /**
+     * @brief Returns the current capacity.
+     */
+    [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+
+    /**
+     * @brief Accounts for a push call.
+     *
+     * @param full Whether the capacity cut the push short.
+     * @param occupancy The number of elements in the queue after the call.
+     * @return The new capacity if the call closed a window that changed it.
+     */
+    [[nodiscard]] std::optional<size_t> onPush(bool full, size_t occupancy)
+    {
+        ++m_pushes;
+        m_fullPushes += full ? 1 : 0;
+        return onCall(occupancy);
+    }
+
+    /**
+     * @brief Accounts for a pop call.
+     *
+     * @param popped The number of elements popped, 0 if the queue was empty.
+     * @param occupancy The number of elements in the queue after the call.
+     * @return The new capacity if the call closed a window that changed it.
+     */
+    [[nodiscard]] std::optional<size_t> onPop(size_t popped, size_t occupancy)
+    {
+        ++m_pops;
+        m_emptyPops += popped == 0 ? 1 : 0;
+        m_popped += popped;
+        return onCall(occupancy);
+    }
+
+    /**
+     * @brief Returns the chosen capacity and the measures of the last window.
+     */
+    [[nodiscard]] Summary summary() const noexcept { return m_summary; }
+
+   private:
+    /**
+     * @brief Accumulates the occupancy, and closes the window once it is complete.
+     */
+    [[nodiscard]] std::optional<size_t> onCall(size_t occupancy)
+    {
+        m_occupancySum += occupancy;
+        if (++m_calls < m_tuning.m_window)
+        {
+            return std::nullopt;
+        }
+        return closeWindow();
+    }
+
+    /**
+     * @brief Measures the window, decides the capacity and starts the next window.
+     */
+    [[nodiscard]] std::optional<size_t> closeWindow();
+
+    CapacityTuning m_tuning;                              ///< The options.
+    size_t m_capacity;                                    ///< The current capacity.
+    size_t m_floor;                                       ///< Capacity not shrunk below.
+    size_t m_quietWindows = 0;                            ///< Windows since the last growth.
+    Summary m_summary;                                    ///< Outcome of the last window.
+    std::chrono::steady_clock::time_point m_windowStart;  ///< Start of the current window.
+    size_t m_calls = 0;                                   ///< Calls in the current window.
+    size_t m_pushes = 0;                                  ///< Push calls in the window.
+    size_t m_fullPushes = 0;                              ///< Push calls cut short.
+    size_t m_pops = 0;                                    ///< Pop calls in the window.
+    size_t m_emptyPops = 0;                               ///< Pop calls finding nothing.
+    size_t m_popped = 0;                                  ///< Elements popped in the window.
+    uint64_t m_occupancySum = 0;                          ///< Sum of the occupancies seen.
+};
+
+}  // namespace core
@@ -0,0 +1,154 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "cache_line.h"
+
+namespace core
+{
+
+/**
+ * @class ChaseLevDeque
+ * @brief A bounded work-stealing deque (Chase and Lev, with the C11 memory
+ *        orderings of Le, Pop, Cohen and Zappa Nardelli).
+ *
+ * One owner thread pushes and pops at the bottom, in LIFO order, without
+ * any read-modify-write except when it races a thief for the last
+ * element. Any number of thief threads steal from the top, in FIFO order,
+ * with one compare-and-swap each. Thieves therefore take the oldest work,
+ * far from what the owner is busy with.
+ *
+ * The slot array is allocated once in the constructor. Its size is the
+ * requested capacity rounded up to the next power of two; the deque does
+ * not grow, and push() fails when it is full.
+ *
+ * @tparam T The type of elements, trivially copyable (e.g. a task index).
+ */
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+class ChaseLevDeque
+{
+   public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs an empty deque.
+     *
+     * @param capacity The minimal capacity of the deque. It is rounded up to
+     *                 the next power of two (and to at least 2).
+     */
+    explicit ChaseLevDeque(size_t capacity)
+        : m_mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), m_slots(m_mask + 1)
+    {
+    }
+
+    /**
+     * @brief Pushes a value at the bottom. Owner only.
+     *
+     * @param value The value to push.
+     * @return false if the deque is full.
+     */
+    bool push(const T& value) noexcept
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top > static_cast<int64_t>(m_mask))
+        {
+            return false;
+        }
+        slot(bottom).store(value, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Pops the value pushed last. Owner only.
+     *
+     * @return The value, or std::nullopt if the deque is empty.
+     */
+    std::optional<T> pop() noexcept
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            // Empty: restore the bottom
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        std::optional<T> value = slot(bottom).load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // The last element: race the thieves for it
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                               std::memory_order_relaxed))
+            {
+                value.reset();
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Steals the oldest value. Any thread.
+     *
+     * @return The value, or std::nullopt if the deque is empty or another
+     *         thread took the value first.
+     */
+    std::optional<T> steal() noexcept
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return std::nullopt;
+        }
+        const T value = slot(top).load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Checks whether the deque looks empty. Any thread.
+     *
+     * The answer may be stale by the time it is used; a thief uses it to
+     * tell a lost race from a deque that has nothing left.
+     */
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+    }
+
+   private:
+    /**
+     * @brief Returns the slot of a position.
+     */
+    std::atomic<T>& slot(int64_t position) noexcept
+    {
+        return m_slots[static_cast<size_t>(position) & m_mask];
+    }
+
+    const size_t m_mask;                  ///< Capacity minus one, used to map positions to slots.
+    std::vector<std::atomic<T>> m_slots;  ///< The ring of slots, allocated once.
+
+    // The owner's end and the thieves' end live on separate cache lines.
+    alignas(kCacheLineSize) std::atomic<int64_t> m_top{0};     ///< Next position to steal.
+    alignas(kCacheLineSize) std::atomic<int64_t> m_bottom{0};  ///< Next position to push.
+};
+
+}  // namespace core
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+
+namespace core
+{
+
+/**
+ * @class CompletionPoll
+ * @brief Polls a completion flag shared by all the workers, reading it only now and then.
+ *
+ * Workers spinning on a queue used to load the flag on every iteration.
+ * The flag is only written once, but every load still has to find its
+ * cache line, and any write near it evicted the line from every core. A
+ * poll reads the flag once in kInterval calls of done(). Late detection
+ * is harmless: once all the numbers are generated, extra draws and pops
+ * only meet duplicates. Loops that are about to wait call doneNow().
+ */
+class CompletionPoll
+{
+   public:
+    /// Calls of done() per actual load of the flag.
+    static constexpr unsigned kInterval = 64;
+
+    /**
+     * @brief Constructs a poll of a flag.
+     *
+     * @param flag Reference to the completion flag.
+     */
+    explicit CompletionPoll(const std::atomic_bool& flag) noexcept : m_flag(&flag) {}
+
+    /**
+     * @brief Returns whether the flag was seen set, loading it once in kInterval calls.
+     */
+    [[nodiscard]] bool done() noexcept
+    {
+        if (--m_countdown != 0)
+        {
+            return m_done;
+        }
+        return doneNow();
+    }
+
+    /**
+     * @brief Loads the flag and returns whether it is set.
+     */
+    [[nodiscard]] bool doneNow() noexcept
+    {
+        m_countdown = kInterval;
+        m_done = m_done || m_flag->load(std::memory_order_acquire);
+        return m_done;
+    }
+
+   private:
+    const std::atomic_bool* m_flag;  ///< Pointer to the completion flag.
+    unsigned m_countdown = 1;        ///< Calls left until the next load; the first call loads.
+    bool m_done = false;             ///< Whether the flag was seen set.
+};
+
+}  // namespace core
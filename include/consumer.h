@@ -1,23 +1,17 @@
 #pragma once
-#include <unordered_map>
+#include <atomic>
+#include <span>
+#include <vector>
 
+#include "blocking_queue.h"
+#include "cache_line.h"
+#include "completion_poll.h"
+#include "lock_free_queue.h"
+#include "metrics.h"
+#include "number_storage.h"
+#include "output_sink.h"
 #include "thread_safe_queue.h"
 
-/**
- * @struct NumberInfo
- * @brief Structure to hold information about a number.
- *
- * This structure contains metadata related to a produced number,
- * including its order and the time it was generated.
- */
-
-struct NumberInfo
-{
-    std::atomic<size_t> m_order = 0;  ///< The order in which the number was generated.
-    long long m_generationTime =
-        0;  ///< The time in microseconds that was taken to generate the number.
-};
-
 /**
  * @class Consumer
  * @brief A class that consumes integers from a queue and processes them.
@@ -26,26 +20,55 @@ struct NumberInfo
  * queue, records their generation time, and maintains an order
  * of processing. It continues until the specified number of
  * elements has been consumed or the completion flag is set.
+ *
+ * @tparam Queue The queue type: core::ThreadSafeQueue<T>,
+ *               core::LockFreeQueue<T> or core::BlockingQueue<T>, of int
+ *               numbers up to INT_MAX or of uint64_t numbers beyond. With
+ *               a blocking queue the thread parks instead of polling and
+ *               values are moved one at a time.
+ *
+ * Consumers are kept in arrays, so each of them starts on its own cache
+ * line: appending to one consumer's output buffer never invalidates the
+ * line of its neighbour.
  */
-class Consumer
+template <typename Queue>
+class alignas(core::kCacheLineSize) Consumer
 {
    public:
+    using value_type = typename Queue::value_type;
+
     /**
      * @brief Constructs a Consumer.
      *
      * @param queue Reference to the thread-safe queue from which integers
      *              will be consumed.
-     * @param storage Reference to a vector of NumberInfo to store
-     *                information about consumed numbers.
+     * @param storage Reference to the storage recording the consumed numbers.
+     * @param sink Reference to the sink writing out the consumed numbers.
      * @param elements The number of elements to consume.
      * @param completed Reference to an atomic boolean to signal
      *                  completion of consumption.
+     * @param batchSize The maximal number of integers popped with a single
+     *                  bulk pop. 1 pops every integer on its own.
+     * @param metrics Pointer to the metrics of the run, or nullptr to record none.
      */
-    Consumer(core::ThreadSafeQueue<int>& queue,
-             std::vector<NumberInfo>& storage,
-             int elements,
-             std::atomic_bool& completed) noexcept
-        : m_elementsNr(elements), m_queue(&queue), m_storage(&storage), m_completed(&completed)
+    Consumer(Queue& queue,
+             core::NumberStorage& storage,
+             core::OutputSink& sink,
+             uint64_t elements,
+             std::atomic_bool& completed,
+             size_t batchSize = 1,
+             core::Metrics* metrics = nullptr)
+        : m_elementsNr(elements)
+        , m_batchSize(batchSize)
+        , m_batch(batchSize > 1 ? batchSize : 0)
+        , m_queue(&queue)
+        , m_storage(&storage)
+        , m_writer(sink)
+        , m_completed(&completed)
+        , m_completion(completed)
+        , m_metrics(metrics)
+        , m_threadMetrics(metrics != nullptr ? &metrics->registerThread() : nullptr)
+        , m_acceptCountdown(core::Metrics::kAcceptSampleInterval)
     {
     }
 
@@ -63,11 +86,70 @@ class Consumer
      * @brief Sets the start time for generation.
      *
      * This static method can be called to initialize the start
-     * time for generation tracking.
+     * time for generation tracking. It also restarts the order of
+     * consumption at 1, so that a process can run several generations.
      */
     static void setStartTime();
 
    private:
+    /**
+     * @brief Consumes integers from the queue in batches of up to m_batchSize.
+     *
+     * Each batch is drained from the queue into m_batch with tryPopBulk, so one
+     * synchronization covers the whole batch.
+     */
+    void consumeBatches();
+
+    /**
+     * @brief Pops an integer from a blocking queue, waiting for one if needed.
+     *
+     * @param randValue Receives the popped integer.
+     * @return false if the queue was closed.
+     */
+    bool popWaiting(value_type& randValue)
+        requires core::BlockingQueueType<Queue>;
+
+    /**
+     * @brief Records a popped integer in the metrics, then accepts it.
+     *
+     * @param randValue The popped integer.
+     */
+    void acceptPopped(value_type randValue);
+
+    /**
+     * @brief Counts a pop attempt that found the queue empty.
+     */
+    void onEmptyPop() noexcept
+    {
+        if (m_threadMetrics != nullptr)
+        {
+            m_threadMetrics->m_emptyPops.add(1);
+        }
+    }
+
+    /**
+     * @brief Records a consumed integer unless it was already generated.
+     *
+     * @param randValue The consumed integer.
+     */
+    void accept(value_type randValue);
+
+    /**
+     * @brief Records the integers of a popped batch that were not generated yet.
+     *
+     * The new integers take consecutive orders, claimed with a single
+     * update of the shared counter, and the time since the previous
+     * accept is charged to the first of them.
+     *
+     * @param values The popped batch; the new integers are moved to its front.
+     */
+    void acceptBatch(std::span<value_type> values);
+
+    /**
+     * @brief Signals that the last number was accepted.
+     */
+    void complete();
+
     /**
      * @brief Gets the current time in microseconds.
      *
@@ -79,12 +161,35 @@ class Consumer
     [[nodiscard]] static long long getCurrentTimeInMicroseconds();
 
    private:
-    int m_elementsNr;                         ///< The total number of elements to consume.
-    inline static long long m_startTime = 0;  ///< Start time for consumption tracking.
-    core::ThreadSafeQueue<int>*
-        m_queue;  ///< Pointer to the thread-safe queue for retrieving integers.
-    std::vector<NumberInfo>*
-        m_storage;                  ///< Pointer to the storage vector for consumed number info.
-    std::atomic_bool* m_completed;  ///< Pointer to the completion flag.
-    inline static std::atomic<size_t> m_order = 1;  ///< Atomic counter for order of consumption.
-};
\ No newline at end of file
+    /**
+     * @struct Progress
+     * @brief The order counter and the time of the last accepted number, shared by all consumers.
+     *
+     * Every accept updates both, so they share one cache line and nothing else does.
+     */
+    struct alignas(core::kCacheLineSize) Progress
+    {
+        std::atomic<long long> m_startTime{0};  ///< Time of the last accepted number.
+        std::atomic<size_t> m_order{1};         ///< Counter for order of consumption.
+    };
+
+    uint64_t m_elementsNr;                 ///< The total number of elements to consume.
+    size_t m_batchSize;                    ///< Maximal number of integers popped at once.
+    std::vector<value_type> m_batch;       ///< Buffer of a batch, allocated once.
+    Queue* m_queue;                        ///< Pointer to the queue of integers.
+    core::NumberStorage* m_storage;        ///< Pointer to the storage of consumed numbers.
+    core::OutputSink::Writer m_writer;     ///< Buffer of the consumed numbers to write.
+    std::atomic_bool* m_completed;         ///< Pointer to the completion flag.
+    core::CompletionPoll m_completion;     ///< Poll of the completion flag.
+    core::Metrics* m_metrics;              ///< Pointer to the metrics of the run, may be nullptr.
+    core::ThreadMetrics* m_threadMetrics;  ///< Pointer to the metrics of this consumer.
+    unsigned m_acceptCountdown;            ///< Pops left until the next accept latency sample.
+    inline static Progress m_progress;     ///< Shared by the consumers of all runs.
+};
+
+extern template class Consumer<core::ThreadSafeQueue<int>>;
+extern template class Consumer<core::LockFreeQueue<int>>;
+extern template class Consumer<core::BlockingQueue<int>>;
+extern template class Consumer<core::ThreadSafeQueue<uint64_t>>;
+extern template class Consumer<core::LockFreeQueue<uint64_t>>;
+extern template class Consumer<core::BlockingQueue<uint64_t>>;
\ No newline at end of file
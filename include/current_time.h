@@ -0,0 +1,20 @@
+#pragma once
+#include <chrono>
+
+namespace core
+{
+
+/**
+ * @brief Returns the current time in microseconds.
+ *
+ * The clock of the generation times recorded by every worker, so that
+ * times taken by different modes and threads can be compared.
+ */
+[[nodiscard]] inline long long getCurrentTimeInMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::high_resolution_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace core
@@ -1,32 +1,24 @@
 #pragma once
 
 #include "consumer.h"
+#include "output_sink.h"
+#include "random_source.h"
 
 /**
  * @file cv_based_threading.h
  * @brief A header file defining functions for a producer-consumer model
  *        using condition variable (CV) for synchronization.
  *
- * This file contains function declarations for initializing the random
- * number distribution and start time, as well as functions for
- * producing and consuming integers in a thread-safe manner using
- * a thread-safe queue.
+ * This file contains function declarations for initializing the start
+ * time, as well as functions for producing and consuming integers in a
+ * thread-safe manner using a thread-safe queue.
  */
 
-/**
- * @brief Initializes the random number distribution.
- *
- * This function sets up the uniform distribution for generating
- * random numbers within the specified range.
- *
- * @param to The upper limit for the random number generation.
- */
-void initializeDistribution(int to);
-
 /**
  * @brief Initializes the start time for tracking generation.
  *
- * This function records the start time for the generation process.
+ * This function records the start time for the generation process and
+ * restarts the order of consumption at 1.
  */
 void initializeStartTime();
 
@@ -37,13 +29,17 @@ void initializeStartTime();
  * pushes them into the provided thread-safe queue. It also signals
  * when the production is completed.
  *
+ * @tparam Queue The queue type: core::ThreadSafeQueue<int>,
+ *               core::LockFreeQueue<int> or core::BlockingQueue<int>.
  * @param queue Reference to the thread-safe queue for storing
  *              produced integers.
- * @param elements The number of integers to produce.
+ * @param random The source of random integers of this thread. Every
+ *               producer thread needs its own source.
  * @param completed Reference to an atomic boolean that indicates
  *                  whether production is complete.
  */
-void produce(core::ThreadSafeQueue<int>& queue, int elements, std::atomic_bool& completed);
+template <typename Queue>
+void produce(Queue& queue, core::RandomSource random, std::atomic_bool& completed);
 
 /**
  * @brief Consumes integers from the thread-safe queue and stores their
@@ -51,17 +47,40 @@ void produce(core::ThreadSafeQueue<int>& queue, int elements, std::atomic_bool&
  *
  * This function retrieves integers from the provided thread-safe queue
  * and stores information about each consumed integer in the specified
- * storage vector.
+ * storage.
  *
+ * @tparam Queue The queue type: core::ThreadSafeQueue<int>,
+ *               core::LockFreeQueue<int> or core::BlockingQueue<int>.
  * @param queue Reference to the thread-safe queue from which integers
  *              will be consumed.
- * @param storage Reference to a vector of NumberInfo to store
- *                information about consumed numbers.
+ * @param storage Reference to the storage recording the consumed numbers.
+ * @param sink Reference to the sink writing out the consumed numbers.
  * @param elements The number of elements to consume.
  * @param completed Reference to an atomic boolean that indicates
  *                  whether consumption is complete.
  */
-void consume(core::ThreadSafeQueue<int>& queue,
-             std::vector<NumberInfo>& storage,
+template <typename Queue>
+void consume(Queue& queue,
+             core::NumberStorage& storage,
+             core::OutputSink& sink,
              int elements,
-             std::atomic_bool& completed);
\ No newline at end of file
+             std::atomic_bool& completed);
+
+extern template void produce(core::ThreadSafeQueue<int>&, core::RandomSource, std::atomic_bool&);
+extern template void produce(core::LockFreeQueue<int>&, core::RandomSource, std::atomic_bool&);
+extern template void produce(core::BlockingQueue<int>&, core::RandomSource, std::atomic_bool&);
+extern template void consume(core::ThreadSafeQueue<int>&,
+                             core::NumberStorage&,
+                             core::OutputSink&,
+                             int,
+                             std::atomic_bool&);
+extern template void consume(core::LockFreeQueue<int>&,
+                             core::NumberStorage&,
+                             core::OutputSink&,
+                             int,
+                             std::atomic_bool&);
+extern template void consume(core::BlockingQueue<int>&,
+                             core::NumberStorage&,
+                             core::OutputSink&,
+                             int,
+                             std::atomic_bool&);
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "number_type.h"
+
+namespace core
+{
+
+/**
+ * @brief The implementations of markNew().
+ */
+enum class DedupKernel
+{
+    Scalar,  ///< One fetch_or per number.
+    Avx2,    ///< Gathers of 4 bitset words, then one fetch_or per candidate word.
+    Avx512,  ///< Gathers of 8 bitset words and compressed stores of the candidates.
+};
+
+/**
+ * @brief Returns the fastest kernel the CPU supports.
+ */
+[[nodiscard]] DedupKernel bestDedupKernel() noexcept;
+
+/**
+ * @brief Checks whether the CPU supports a kernel.
+ *
+ * @param kernel The kernel.
+ */
+[[nodiscard]] bool dedupKernelSupported(DedupKernel kernel) noexcept;
+
+/**
+ * @brief Marks a batch of numbers in a dedup bitset and keeps the new ones.
+ *
+ * A number is new if its bit was clear before the batch and it is its
+ * first occurrence in the batch. The new numbers are moved to the front of
+ * the batch, in batch order.
+ *
+ * The vector kernels first gather the bitset words of a whole vector of
+ * numbers and drop the numbers whose bit is already set, without any
+ * atomic operation: late in a run, that is nearly every number. The
+ * remaining candidates are committed with one fetch_or per run of
+ * consecutive candidates sharing a word, whose result settles both the
+ * numbers marked meanwhile by other threads and the duplicates within the
+ * batch. A set bit is never cleared, so the gathered snapshot can only
+ * miss bits, never invent them. Every kernel gives the same result as the
+ * scalar one.
+ *
+ * @tparam T The type of the numbers.
+ * @param kernel The implementation to use. It must be supported by the CPU.
+ * @param bits The bitset, one bit per number of 1..N, bit (n-1) % 64 of word (n-1) / 64.
+ * @param values The numbers of the batch, in 1..N. The new ones are moved to the front.
+ * @return The number of new numbers.
+ */
+template <NumberType T>
+size_t markNew(DedupKernel kernel, std::atomic<uint64_t>* bits, std::span<T> values) noexcept;
+
+/**
+ * @brief Marks a batch of numbers with the fastest kernel the CPU supports.
+ *
+ * @see markNew(DedupKernel, std::atomic<uint64_t>*, std::span<T>)
+ */
+template <NumberType T>
+size_t markNew(std::atomic<uint64_t>* bits, std::span<T> values) noexcept
+{
+    static const DedupKernel kernel = bestDedupKernel();
+    return markNew(kernel, bits, values);
+}
+
+extern template size_t markNew(DedupKernel, std::atomic<uint64_t>*, std::span<int>) noexcept;
+extern template size_t markNew(DedupKernel, std::atomic<uint64_t>*, std::span<uint64_t>) noexcept;
+
+}  // namespace core
@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cache_line.h"
+#include "number_storage.h"
+#include "output_sink.h"
+#include "random_source.h"
+#include "spsc_queue.h"
+
+/**
+ * @class DeterministicPipeline
+ * @brief The deterministic mode: parallel draws merged in a fixed order.
+ *
+ * The sequence of a run is defined without reference to threads: producer
+ * p draws from stream p of the seed, its draws are cut into blocks of
+ * kBlockSize, and the canonical sequence of draws takes one block of each
+ * producer in turn, from producer 0 to P-1. A number is emitted at its
+ * first occurrence in that sequence, with its rank as its order. The same
+ * engine, seed and producer count thus give the same numbers in the same
+ * order, bit for bit, whatever the scheduling.
+ *
+ * Producers run in parallel, each filling whole blocks into its own
+ * core::SpscQueue. A single merger takes the blocks in the canonical
+ * order and keeps the first occurrences. Drawing is where the time goes;
+ * the merger only tests and sets one bit per draw, and waits on a ring
+ * only when that producer lags behind.
+ */
+class DeterministicPipeline
+{
+   public:
+    /// Number of consecutive draws of a producer in the canonical sequence.
+    static constexpr size_t kBlockSize = core::RandomSource::kBufferSize;
+
+    /**
+     * @brief Constructs the rings of the producers.
+     *
+     * @param storage Reference to the storage recording the generated numbers.
+     * @param sink Reference to the sink writing out the generated numbers.
+     * @param elements The number of elements to generate.
+     * @param engine The random engine of the producers.
+     * @param seed The seed of the run.
+     * @param producersNr The number of producers.
+     */
+    DeterministicPipeline(core::NumberStorage& storage,
+                          core::OutputSink& sink,
+                          int elements,
+                          core::RandomEngine engine,
+                          uint64_t seed,
+                          size_t producersNr);
+
+    /**
+     * @brief Fills blocks into the ring of a producer until the merger is done.
+     * Called by producer threads.
+     *
+     * @param producer The index of the calling producer.
+     */
+    void produce(size_t producer);
+
+    /**
+     * @brief Merges the blocks in the canonical order until every number is emitted.
+     * Called by the merger thread.
+     */
+    void merge();
+
+    /**
+     * @brief Returns the number of producers.
+     */
+    [[nodiscard]] size_t producersNr() const noexcept { return m_rings.size(); }
+
+    /**
+     * @brief Returns the number of values the producers drew, counted by the merger.
+     */
+    [[nodiscard]] uint64_t draws() const noexcept { return m_draws; }
+
+   private:
+    core::NumberStorage* m_storage;                              ///< Pointer to the storage.
+    core::OutputSink* m_sink;                                    ///< Pointer to the output sink.
+    int m_elementsNr;                                            ///< The number of elements.
+    core::RandomEngine m_engine;                                 ///< The engine of the producers.
+    uint64_t m_seed;                                             ///< The seed of the run.
+    std::vector<std::unique_ptr<core::SpscQueue<int>>> m_rings;  ///< One ring per producer.
+    uint64_t m_draws = 0;                                        ///< Draws taken by the merger.
+
+    // Polled by every producer, so kept off the lines of the fields above
+    alignas(core::kCacheLineSize) std::atomic_bool m_done{false};  ///< Set by the merger.
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace core
+{
+
+/**
+ * @class FeistelPermutation
+ * @brief A keyed pseudo-random permutation of 0..size-1.
+ *
+ * A balanced Feistel network permutes the smallest domain of 2h bits that
+ * holds size values, whatever its round function. Indices that land
+ * outside 0..size-1 are encrypted again (cycle walking) until they fall
+ * inside, which restricts the permutation to 0..size-1. Since the domain
+ * is less than four times the size, this takes less than four rounds of
+ * the network on average. Any index can be mapped on its own, so workers
+ * can emit disjoint ranges of the permutation without coordination.
+ */
+class FeistelPermutation
+{
+   public:
+    /// Number of rounds of the Feistel network.
+    static constexpr size_t kRounds = 6;
+
+    /**
+     * @brief Constructs the permutation selected by a key.
+     *
+     * @param size The number of permuted values.
+     * @param key The key; different keys give unrelated permutations.
+     */
+    FeistelPermutation(uint64_t size, uint64_t key) noexcept
+        : m_size(size)
+        , m_halfBits((std::bit_width(size > 1 ? size - 1 : 1) + 1) / 2)
+        , m_halfMask((uint64_t{1} << m_halfBits) - 1)
+    {
+        for (auto& roundKey : m_roundKeys)
+        {
+            key += 0x9E3779B97F4A7C15ULL;
+            roundKey = mix(key);
+        }
+    }
+
+    /**
+     * @brief Maps an index to its value in the permutation.
+     *
+     * @param index The index, in 0..size()-1.
+     * @return The permuted value, in 0..size()-1.
+     */
+    [[nodiscard]] uint64_t operator()(uint64_t index) const noexcept
+    {
+        uint64_t value = index;
+        do
+        {
+            value = encrypt(value);
+        } while (value >= m_size);
+        return value;
+    }
+
+    /**
+     * @brief Returns the number of permuted values.
+     */
+    [[nodiscard]] uint64_t size() const noexcept { return m_size; }
+
+   private:
+    /**
+     * @brief Applies the Feistel network to a value of the 2h-bit domain.
+     */
+    [[nodiscard]] uint64_t encrypt(uint64_t value) const noexcept
+    {
+        uint64_t left = value >> m_halfBits;
+        uint64_t right = value & m_halfMask;
+        for (uint64_t roundKey : m_roundKeys)
+        {
+            const uint64_t next = left ^ (mix(right ^ roundKey) & m_halfMask);
+            left = right;
+            right = next;
+        }
+        return (left << m_halfBits) | right;
+    }
+
+    /**
+     * @brief The SplitMix64 finalizer, used as the round function.
+     */
+    [[nodiscard]] static constexpr uint64_t mix(uint64_t value) noexcept
+    {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    uint64_t m_size;                              ///< The number of permuted values.
+    int m_halfBits;                               ///< Bits of each half of the Feistel domain.
+    uint64_t m_halfMask;                          ///< Mask of one half.
+    std::array<uint64_t, kRounds> m_roundKeys{};  ///< Keys of the rounds, derived from the key.
+};
+
+}  // namespace core
@@ -0,0 +1,144 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace core
+{
+
+/**
+ * @class Generator
+ * @brief A lazy sequence produced by a coroutine, in the spirit of C++23 std::generator.
+ *
+ * The coroutine does not start until the first value is requested, and it
+ * runs only while the caller asks for the next value: every co_yield
+ * suspends it until the iterator is incremented. Destroying the generator
+ * destroys the suspended coroutine and its local variables, so a caller
+ * may stop pulling at any time.
+ *
+ * @tparam T The type of the yielded values.
+ */
+template <typename T>
+class Generator
+{
+   public:
+    /**
+     * @struct promise_type
+     * @brief The promise of the coroutine, holding the last yielded value.
+     */
+    struct promise_type
+    {
+        Generator get_return_object() noexcept
+        {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(T value) noexcept
+        {
+            m_value = std::move(value);
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+        std::optional<T> m_value;        ///< The last yielded value.
+        std::exception_ptr m_exception;  ///< The exception that ended the coroutine, if any.
+    };
+
+    /**
+     * @class Iterator
+     * @brief An input iterator over the yielded values.
+     */
+    class Iterator
+    {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        explicit Iterator(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle)
+        {
+        }
+
+        const T& operator*() const noexcept { return *m_handle.promise().m_value; }
+
+        Iterator& operator++()
+        {
+            resume(m_handle);
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const noexcept
+        {
+            return !m_handle || m_handle.done();
+        }
+
+       private:
+        std::coroutine_handle<promise_type> m_handle;  ///< The coroutine, not owned.
+    };
+
+    Generator(Generator&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Generator& operator=(Generator&& other) = delete;
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    /**
+     * @brief Destroys the coroutine, wherever it is suspended.
+     */
+    ~Generator()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    /**
+     * @brief Starts the coroutine and returns an iterator on its first value.
+     *
+     * @throws Any exception the coroutine let escape.
+     */
+    Iterator begin()
+    {
+        resume(m_handle);
+        return Iterator(m_handle);
+    }
+
+    /**
+     * @brief Returns the sentinel reached once the coroutine returns.
+     */
+    std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+   private:
+    explicit Generator(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+    /**
+     * @brief Runs the coroutine up to its next co_yield or to its end.
+     *
+     * @throws Any exception the coroutine let escape.
+     */
+    static void resume(std::coroutine_handle<promise_type> handle)
+    {
+        handle.resume();
+        if (handle.done() && handle.promise().m_exception)
+        {
+            std::rethrow_exception(handle.promise().m_exception);
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle;  ///< The coroutine, owned.
+};
+
+}  // namespace core
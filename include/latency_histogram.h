@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace core
+{
+
+/**
+ * @class LatencyHistogram
+ * @brief A log-linear histogram of durations, in the spirit of HdrHistogram.
+ *
+ * Values below 16 get a bucket each. Above, every power of two is split
+ * into 16 buckets, so a bucket is never wider than 1/16 of its lower
+ * bound and a reported percentile is within 6.25% of the exact value.
+ * 976 buckets cover the whole uint64_t range.
+ *
+ * A histogram has a single writer: only the owning thread calls record()
+ * and merge(), with plain relaxed loads and stores instead of atomic
+ * read-modify-writes. Other threads may read it while it is written, for
+ * example to sample percentiles during a run, and then see a slightly
+ * stale but well-defined state.
+ */
+class LatencyHistogram
+{
+   public:
+    /// Number of buckets per power of two, as a power of two.
+    static constexpr unsigned kSubBucketBits = 4;
+    /// Number of buckets per power of two.
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    /// Number of buckets covering 0..2^64-1.
+    static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Records one value.
+     *
+     * @param value The value, typically a duration in nanoseconds.
+     */
+    void record(uint64_t value) noexcept
+    {
+        increment(m_buckets[bucketOf(value)], 1);
+        increment(m_count, 1);
+        increment(m_sum, value);
+        if (value > m_max.load(std::memory_order_relaxed))
+        {
+            m_max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Adds the values recorded by another histogram.
+     *
+     * @param other The histogram to add, which may still be written.
+     */
+    void merge(const LatencyHistogram& other) noexcept
+    {
+        for (size_t i = 0; i < kBuckets; ++i)
+        {
+            increment(m_buckets[i], other.m_buckets[i].load(std::memory_order_relaxed));
+        }
+        increment(m_count, other.m_count.load(std::memory_order_relaxed));
+        increment(m_sum, other.m_sum.load(std::memory_order_relaxed));
+        m_max.store(std::max(max(), other.max()), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of recorded values.
+     */
+    [[nodiscard]] uint64_t count() const noexcept
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the largest recorded value, 0 if there is none.
+     */
+    [[nodiscard]] uint64_t max() const noexcept { return m_max.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the mean of the recorded values, 0 if there is none.
+     */
+    [[nodiscard]] double mean() const noexcept
+    {
+        const uint64_t count = this->count();
+        return count == 0 ? 0.0
+                          : static_cast<double>(m_sum.load(std::memory_order_relaxed)) /
+                                static_cast<double>(count);
+    }
+
+    /**
+     * @brief Returns a percentile of the recorded values.
+     *
+     * @param percentile The percentile, in 0..100.
+     * @return The highest value of the bucket holding the percentile, capped
+     *         at max(), or 0 if nothing was recorded.
+     */
+    [[nodiscard]] uint64_t percentile(double percentile) const noexcept
+    {
+        uint64_t total = 0;
+        for (const auto& bucket : m_buckets)
+        {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        if (total == 0)
+        {
+            return 0;
+        }
+        const auto rank = std::max<uint64_t>(
+            1, static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i)
+        {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+            {
+                return std::min(highestOf(i), max());
+            }
+        }
+        return max();
+    }
+
+    /**
+     * @brief Returns the bucket of a value.
+     */
+    [[nodiscard]] static constexpr size_t bucketOf(uint64_t value) noexcept
+    {
+        if (value < kSubBuckets)
+        {
+            return static_cast<size_t>(value);
+        }
+        const auto shift = static_cast<unsigned>(std::bit_width(value)) - 1 - kSubBucketBits;
+        const auto subBucket = static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+        return (shift + 1) * kSubBuckets + subBucket;
+    }
+
+    /**
+     * @brief Returns the highest value falling into a bucket.
+     */
+    [[nodiscard]] static constexpr uint64_t highestOf(size_t bucket) noexcept
+    {
+        if (bucket < kSubBuckets)
+        {
+            return bucket;
+        }
+        const size_t shift = bucket / kSubBuckets - 1;
+        const uint64_t lowest = (kSubBuckets + bucket % kSubBuckets) << shift;
+        return lowest + ((uint64_t{1} << shift) - 1);
+    }
+
+   private:
+    /**
+     * @brief Adds to a counter that only the calling thread writes.
+     */
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, kBuckets> m_buckets{};  ///< Number of values per bucket.
+    std::atomic<uint64_t> m_count{0};                         ///< Number of recorded values.
+    std::atomic<uint64_t> m_sum{0};                           ///< Sum of the recorded values.
+    std::atomic<uint64_t> m_max{0};                           ///< Largest recorded value.
+};
+
+}  // namespace core
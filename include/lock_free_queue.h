@@ -0,0 +1,275 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "cache_line.h"
+
+namespace core
+{
+
+/**
+ * @class LockFreeQueue
+ * @brief A bounded lock-free multi-producer multi-consumer queue.
+ *
+ * This class is a drop-in alternative to ThreadSafeQueue with the same
+ * tryPush/tryPop contract. It is a ring buffer in which every slot carries
+ * a sequence number (D. Vyukov's bounded MPMC queue): a producer may write
+ * a slot only when its sequence equals the enqueue position, and a consumer
+ * may read it only when the sequence equals the dequeue position plus one.
+ * Producers and consumers therefore only contend on their own position
+ * counter, which live on separate cache lines.
+ *
+ * The slot array is allocated once in the constructor. Its size is the
+ * requested capacity rounded up to the next power of two, so that the
+ * position-to-slot mapping is a mask instead of a division.
+ *
+ * @tparam T The type of elements stored in the queue.
+ */
+template <typename T>
+class LockFreeQueue
+{
+   public:
+    using value_type = T;
+
+    /**
+     * @brief Constructor for a LockFreeQueue with a fixed size.
+     *
+     * @param size The minimal capacity of the queue. It is rounded up to the
+     *             next power of two (and to at least 2).
+     */
+    explicit LockFreeQueue(size_t size)
+        : m_mask(std::bit_ceil(std::max<size_t>(size, 2)) - 1)
+        , m_cells(m_mask + 1)
+    {
+        for (size_t i = 0; i <= m_mask; ++i)
+        {
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Attempts to push a value to the queue.
+     *
+     * This method is thread-safe and lock-free. It will only add the value
+     * if the queue is not full.
+     *
+     * @param val The value to be added to the queue.
+     * @return true if the value was successfully added, false if the queue is full.
+     */
+    [[nodiscard]] bool tryPush(const T& val)
+    {
+        Cell* cell = nullptr;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->m_sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0)
+            {
+                // The slot is free for this position, try to claim it.
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The slot still holds a value from the previous lap: the queue is full.
+                return false;
+            }
+            else
+            {
+                // Another producer claimed this position, reload and retry.
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->m_value = val;
+        cell->m_sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Attempts to pop a value from the queue.
+     *
+     * This method is thread-safe and lock-free. It will only remove the front
+     * value if the queue is not empty.
+     *
+     * @param[out] val The value that was removed from the queue.
+     * @return true if a value was successfully removed, false if the queue was empty.
+     */
+    [[nodiscard]] bool tryPop(T& val)
+    {
+        Cell* cell = nullptr;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->m_sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                // The slot holds a value for this position, try to claim it.
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The slot has not been written yet: the queue is empty.
+                return false;
+            }
+            else
+            {
+                // Another consumer claimed this position, reload and retry.
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        val = cell->m_value;
+        // Mark the slot free for the producer of the next lap.
+        cell->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Attempts to push a batch of values to the queue.
+     *
+     * This method is thread-safe and lock-free. It claims a run of
+     * consecutive free slots with a single compare-and-swap of the enqueue
+     * position, so only a prefix of the batch may be added when the queue
+     * is nearly full.
+     *
+     * @param vals The values to be added to the queue.
+     * @return The number of values added from the front of the batch (0 if the queue is full).
+     */
+    [[nodiscard]] size_t tryPushBulk(std::span<const T> vals)
+    {
+        if (vals.empty())
+        {
+            return 0;
+        }
+        size_t count = 0;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const size_t seq = m_cells[pos & m_mask].m_sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff < 0)
+            {
+                return 0;
+            }
+            if (diff > 0)
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            // Extend the claim over the following slots that are free for this lap as well.
+            count = 1;
+            while (count < vals.size() &&
+                   m_cells[(pos + count) & m_mask].m_sequence.load(std::memory_order_acquire) ==
+                       pos + count)
+            {
+                ++count;
+            }
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            Cell& cell = m_cells[(pos + i) & m_mask];
+            cell.m_value = vals[i];
+            cell.m_sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Attempts to pop a batch of values from the queue.
+     *
+     * This method is thread-safe and lock-free. It claims a run of
+     * consecutive published slots with a single compare-and-swap of the
+     * dequeue position.
+     *
+     * @param[out] vals The buffer receiving the removed values, in FIFO order.
+     * @return The number of values written to the front of the buffer (0 if the queue was empty).
+     */
+    [[nodiscard]] size_t tryPopBulk(std::span<T> vals)
+    {
+        if (vals.empty())
+        {
+            return 0;
+        }
+        size_t count = 0;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const size_t seq = m_cells[pos & m_mask].m_sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff < 0)
+            {
+                return 0;
+            }
+            if (diff > 0)
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            // Extend the claim over the following slots that are already published.
+            count = 1;
+            while (count < vals.size() &&
+                   m_cells[(pos + count) & m_mask].m_sequence.load(std::memory_order_acquire) ==
+                       pos + count + 1)
+            {
+                ++count;
+            }
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            Cell& cell = m_cells[(pos + i) & m_mask];
+            vals[i] = cell.m_value;
+            cell.m_sequence.store(pos + i + m_mask + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Returns the real capacity of the queue.
+     *
+     * @return The number of slots, i.e. the requested size rounded up to a power of two.
+     */
+    [[nodiscard]] size_t capacity() const noexcept { return m_mask + 1; }
+
+   private:
+    /**
+     * @struct Cell
+     * @brief A ring slot holding a value and its sequence number.
+     */
+    struct Cell
+    {
+        std::atomic<size_t> m_sequence{0};  ///< Position this slot is ready for.
+        T m_value{};                        ///< The stored value.
+    };
+
+    const size_t m_mask;        ///< Capacity minus one, used to map positions to slots.
+    std::vector<Cell> m_cells;  ///< The ring of slots, allocated once.
+    // Each position counter gets a cache line of its own; the class alignment also pads the
+    // object so that the dequeue position does not share a line with whatever follows it.
+    alignas(kCacheLineSize) std::atomic<size_t> m_enqueuePos{0};  ///< Next position to push.
+    alignas(kCacheLineSize) std::atomic<size_t> m_dequeuePos{0};  ///< Next position to pop.
+};
+
+}  // namespace core
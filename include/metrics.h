@@ -0,0 +1,244 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cache_line.h"
+#include "latency_histogram.h"
+#include "number_type.h"
+
+namespace core
+{
+
+/**
+ * @class Counter
+ * @brief An event counter written by a single thread and readable by any.
+ */
+class Counter
+{
+   public:
+    /**
+     * @brief Adds to the counter. Only the owning thread may call it.
+     */
+    void add(uint64_t value) noexcept
+    {
+        m_value.store(m_value.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the current value.
+     */
+    [[nodiscard]] uint64_t value() const noexcept
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<uint64_t> m_value{0};  ///< The number of events.
+};
+
+/**
+ * @struct ThreadMetrics
+ * @brief The histograms and counters of one worker thread.
+ *
+ * Durations are in nanoseconds. Every worker owns its instance, so
+ * recording never touches memory written by another thread.
+ */
+struct alignas(kCacheLineSize) ThreadMetrics
+{
+    LatencyHistogram m_enqueueWait;    ///< Time a push waited for room in the queue.
+    LatencyHistogram m_residency;      ///< Time a sampled number spent in the queue.
+    LatencyHistogram m_acceptLatency;  ///< Time from a sampled pop to the end of its accept.
+    Counter m_pushes;                  ///< Successful push operations.
+    Counter m_pushFailures;            ///< Push attempts that found the queue full.
+    Counter m_pops;                    ///< Numbers taken out of the queue.
+    Counter m_emptyPops;               ///< Pop attempts that found the queue empty.
+    Counter m_accepted;                ///< Popped numbers that were new.
+    Counter m_duplicates;              ///< Popped numbers that were rejected as duplicates.
+    Counter m_filtered;                ///< Draws producers kept out of the queue as duplicates.
+};
+
+/**
+ * @class Metrics
+ * @brief Per-stage latency histograms and counters of a run.
+ *
+ * Workers register a ThreadMetrics each and record into it without any
+ * synchronization. The queue residency of a number cannot be carried
+ * through the integer queues, so it is sampled: producers stamp the push
+ * time of every kProbeStride-th number into a probe slot of that number,
+ * and the consumer popping it reads the slot back. The time from a pop to
+ * the end of the accept is sampled once every kAcceptSampleInterval pops.
+ *
+ * The merged percentiles are printed at the end of a run and can also be
+ * appended to a CSV file periodically while the run is going.
+ */
+class Metrics
+{
+   public:
+    /// One number out of kProbeStride has its queue residency measured.
+    static constexpr unsigned kProbeStride = 64;
+    /// One pop out of kAcceptSampleInterval has its accept latency measured.
+    static constexpr unsigned kAcceptSampleInterval = 16;
+
+    /**
+     * @brief Constructs the metrics of a run generating the numbers 1..elements.
+     *
+     * @param elements The number of elements.
+     */
+    explicit Metrics(size_t elements);
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    /**
+     * @brief Stops the periodic sampling, if any.
+     */
+    ~Metrics();
+
+    /**
+     * @brief Returns the current time in nanoseconds of a steady clock.
+     */
+    [[nodiscard]] static uint64_t now() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    /**
+     * @brief Adds the metrics of a worker thread.
+     *
+     * @return The metrics the worker records into. They live as long as this object.
+     */
+    ThreadMetrics& registerThread();
+
+    /**
+     * @brief Records a successful push.
+     *
+     * @param thread The metrics of the producer.
+     * @param values The pushed numbers.
+     * @param waitStart The time of the first failed attempt of this push, 0 if none.
+     */
+    template <NumberType T>
+    void onPushed(ThreadMetrics& thread, std::span<const T> values, uint64_t waitStart) noexcept
+    {
+        thread.m_pushes.add(1);
+        const uint64_t time = waitStart != 0 || hasProbe(values) ? now() : 0;
+        thread.m_enqueueWait.record(waitStart != 0 ? time - waitStart : 0);
+        for (const T value : values)
+        {
+            if (isProbe(value))
+            {
+                m_probes[probeOf(value)].store(time, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Records a popped number.
+     *
+     * @param thread The metrics of the consumer.
+     * @param value The popped number.
+     */
+    void onPopped(ThreadMetrics& thread, uint64_t value) noexcept
+    {
+        thread.m_pops.add(1);
+        if (isProbe(value))
+        {
+            const uint64_t pushTime =
+                m_probes[probeOf(value)].exchange(0, std::memory_order_relaxed);
+            if (pushTime != 0)
+            {
+                thread.m_residency.record(now() - pushTime);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the sums of the metrics of all workers registered so far.
+     *
+     * Workers may still be recording, the sums are then a recent snapshot.
+     */
+    [[nodiscard]] std::unique_ptr<ThreadMetrics> total() const;
+
+    /**
+     * @brief Writes the percentile summary of all workers.
+     *
+     * @param out The stream written to.
+     */
+    void printSummary(std::ostream& out) const;
+
+    /**
+     * @brief Starts appending a CSV line of the merged metrics to a file periodically.
+     *
+     * @param path The file written to, truncated first.
+     * @param interval The time between two lines.
+     * @return false if the file cannot be opened.
+     */
+    bool startSampling(const std::string& path, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Writes a last line and stops the periodic sampling. Further calls do nothing.
+     */
+    void stopSampling();
+
+   private:
+    /**
+     * @brief Appends one CSV line of the merged metrics to the sampling file.
+     */
+    void writeSample();
+
+    /**
+     * @brief Checks whether a number has its queue residency measured.
+     */
+    [[nodiscard]] static bool isProbe(uint64_t value) noexcept
+    {
+        return value % kProbeStride == 0;
+    }
+
+    /**
+     * @brief Checks whether any of the numbers has its queue residency measured.
+     */
+    template <NumberType T>
+    [[nodiscard]] static bool hasProbe(std::span<const T> values) noexcept
+    {
+        for (const T value : values)
+        {
+            if (isProbe(value))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the probe slot of a number for which isProbe() holds.
+     */
+    [[nodiscard]] static size_t probeOf(uint64_t value) noexcept
+    {
+        return static_cast<size_t>(value) / kProbeStride;
+    }
+
+    std::vector<std::atomic<uint64_t>> m_probes;            ///< Push times of in-flight probes.
+    mutable std::mutex m_mutex;                             ///< Protects m_threads.
+    std::vector<std::unique_ptr<ThreadMetrics>> m_threads;  ///< Metrics of the workers.
+    std::chrono::steady_clock::time_point m_startTime;      ///< Construction time.
+    std::ofstream m_sampleFile;                             ///< CSV file of periodic samples.
+    std::mutex m_samplingMutex;                             ///< Protects m_stopSampling.
+    std::condition_variable m_samplingCv;                   ///< Wakes the sampler to stop it.
+    bool m_stopSampling = false;                            ///< Set by stopSampling().
+    std::thread m_sampler;                                  ///< Thread of the periodic sampling.
+};
+
+}  // namespace core
@@ -0,0 +1,270 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "cache_line.h"
+#include "dedup_kernel.h"
+#include "page_memory.h"
+
+namespace core
+{
+
+/**
+ * @class NumberStorage
+ * @brief Records which numbers of 1..N were generated, in which order and how fast.
+ *
+ * The storage is laid out as separate columns. Duplicates are rejected by
+ * an atomic bitset, one bit per number, set with fetch_or on 64-bit words.
+ * This is the only column touched for every consumed number, so the hot
+ * working set is N/8 bytes. The order and generation time columns are only
+ * written for accepted numbers, by the one thread that set the number's
+ * bit. The bitset starts on a cache line, so that a thread owning a range
+ * of numbers can own whole lines of it. Either column can be left out
+ * entirely, e.g. when a mapped result file keeps them instead. The columns
+ * are allocated once, from a memory resource that may be the arena of a
+ * run. From a PageMemoryResource they are not even cleared: their pages
+ * are zero-filled on demand, and can be faulted in by the workers
+ * themselves with firstTouch().
+ */
+class NumberStorage
+{
+   public:
+    /// Number of consecutive numbers sharing one word of the bitset.
+    static constexpr size_t kNumbersPerWord = 64;
+
+    /**
+     * @brief Constructs an empty storage for the numbers 1..size.
+     *
+     * @param size The number of elements.
+     * @param recordTimes Whether to keep the generation time column.
+     * @param recordOrders Whether to keep the order column.
+     * @param resource The memory resource the columns are allocated from.
+     */
+    explicit NumberStorage(size_t size,
+                           bool recordTimes = true,
+                           bool recordOrders = true,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_size(size)
+        , m_bits((size + kNumbersPerWord - 1) / kNumbersPerWord, resource, kCacheLineSize)
+        , m_orders(recordOrders ? size : 0, resource)
+        , m_times(recordTimes ? size : 0, resource)
+    {
+    }
+
+    /**
+     * @brief Marks a number as generated.
+     *
+     * @param value The number, in 1..size().
+     * @return true if the number was not generated before, false if it is a duplicate.
+     */
+    [[nodiscard]] bool tryMark(uint64_t value) noexcept
+    {
+        const auto index = static_cast<size_t>(value - 1);
+        const uint64_t bit = uint64_t{1} << (index % kNumbersPerWord);
+        const uint64_t previous =
+            m_bits[index / kNumbersPerWord].fetch_or(bit, std::memory_order_relaxed);
+        return (previous & bit) == 0;
+    }
+
+    /**
+     * @brief Marks a number as generated, for the only thread marking its bitset word.
+     *
+     * A plain load and store instead of the fetch_or of tryMark(). It is only
+     * correct while no other thread marks a number of the same word, e.g. when
+     * every word belongs to one consumer.
+     *
+     * @param value The number, in 1..size().
+     * @return true if the number was not generated before, false if it is a duplicate.
+     */
+    [[nodiscard]] bool tryMarkOwned(uint64_t value) noexcept
+    {
+        const auto index = static_cast<size_t>(value - 1);
+        const uint64_t bit = uint64_t{1} << (index % kNumbersPerWord);
+        std::atomic<uint64_t>& word = m_bits[index / kNumbersPerWord];
+        const uint64_t previous = word.load(std::memory_order_relaxed);
+        if ((previous & bit) != 0)
+        {
+            return false;
+        }
+        word.store(previous | bit, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Marks a batch of numbers as generated and keeps the new ones.
+     *
+     * Gives the same result as calling tryMark() for each number in turn,
+     * with the vectorized kernel of markNew().
+     *
+     * @param values The numbers, in 1..size(). The new ones are moved to the front, in order.
+     * @return The number of new numbers.
+     */
+    template <NumberType T>
+    [[nodiscard]] size_t tryMarkBatch(std::span<T> values) noexcept
+    {
+        return markNew(m_bits.data(), values);
+    }
+
+    /**
+     * @brief Records the order and the generation time of a number.
+     *
+     * Only the thread whose tryMark() call succeeded for the number may record it.
+     *
+     * @param value The number, in 1..size().
+     * @param order The order in which the number was generated, starting at 1.
+     * @param generationTime The time in microseconds taken to generate the number.
+     */
+    void record(uint64_t value, size_t order, long long generationTime) noexcept
+    {
+        const auto index = static_cast<size_t>(value - 1);
+        if (!m_orders.empty())
+        {
+            m_orders[index] = order;
+        }
+        if (!m_times.empty())
+        {
+            m_times[index] = generationTime;
+        }
+    }
+
+    /**
+     * @brief Checks whether a number was generated.
+     *
+     * @param value The number, in 1..size().
+     * @return true if the number's bit is set.
+     */
+    [[nodiscard]] bool isMarked(uint64_t value) const noexcept
+    {
+        const auto index = static_cast<size_t>(value - 1);
+        const uint64_t bit = uint64_t{1} << (index % kNumbersPerWord);
+        return (m_bits[index / kNumbersPerWord].load(std::memory_order_relaxed) & bit) != 0;
+    }
+
+    /**
+     * @brief Returns the numbers not marked yet, in increasing order.
+     *
+     * The bitset is read a word at a time. Numbers marked concurrently may
+     * or may not be part of the result.
+     */
+    [[nodiscard]] std::vector<uint64_t> unmarked() const
+    {
+        std::vector<uint64_t> values;
+        for (size_t word = 0; word < m_bits.size(); ++word)
+        {
+            uint64_t missing = ~m_bits[word].load(std::memory_order_relaxed);
+            while (missing != 0)
+            {
+                const size_t index = word * kNumbersPerWord +
+                                     static_cast<size_t>(std::countr_zero(missing));
+                if (index >= m_size)
+                {
+                    break;
+                }
+                values.push_back(index + 1);
+                missing &= missing - 1;
+            }
+        }
+        return values;
+    }
+
+    /**
+     * @brief Writes the pages of one part of every column, so that they are allocated now.
+     *
+     * Splits the numbers into parts equal contiguous parts. Each worker
+     * calling it for its own part before the run faults those pages in
+     * itself, in parallel with the others, and on its own NUMA node. Pages
+     * that were touched already are left as they are. The columns still
+     * read as zero afterwards, so it must not run concurrently with tryMark()
+     * or record().
+     *
+     * @param part The part to touch, below parts.
+     * @param parts The number of parts.
+     */
+    void firstTouch(size_t part, size_t parts) noexcept
+    {
+        touchPart(m_bits, part, parts);
+        touchPart(m_orders, part, parts);
+        touchPart(m_times, part, parts);
+    }
+
+    /**
+     * @brief Returns the order in which a number was generated.
+     *
+     * @param value The number, in 1..size().
+     * @return The order, or 0 if the number was not recorded or orders are not recorded.
+     */
+    [[nodiscard]] size_t order(uint64_t value) const noexcept
+    {
+        return m_orders.empty() ? 0 : m_orders[static_cast<size_t>(value - 1)];
+    }
+
+    /**
+     * @brief Returns the time taken to generate a number.
+     *
+     * @param value The number, in 1..size().
+     * @return The time in microseconds, or 0 if times are not recorded.
+     */
+    [[nodiscard]] long long generationTime(uint64_t value) const noexcept
+    {
+        return m_times.empty() ? 0 : m_times[static_cast<size_t>(value - 1)];
+    }
+
+    /**
+     * @brief Returns the sum of the generation times of all numbers.
+     *
+     * @return The total time in microseconds, or 0 if times are not recorded.
+     */
+    [[nodiscard]] long long totalGenerationTime() const noexcept
+    {
+        return std::accumulate(m_times.begin(), m_times.end(), 0LL);
+    }
+
+    /**
+     * @brief Checks whether the generation time column is kept.
+     */
+    [[nodiscard]] bool recordsTimes() const noexcept { return !m_times.empty(); }
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+   private:
+    /**
+     * @brief Writes a zero into every page of one part of a column.
+     */
+    template <typename T>
+    static void touchPart(ZeroedArray<T>& column, size_t part, size_t parts) noexcept
+    {
+        const size_t first = column.size() * part / parts;
+        const size_t last = column.size() * (part + 1) / parts;
+        const size_t stride = std::max<size_t>(PageMemoryResource::pageSize() / sizeof(T), 1);
+        // The first element of the part, then the first element of every page after it
+        for (size_t i = first; i < last; i = (i / stride + 1) * stride)
+        {
+            if constexpr (std::is_same_v<T, std::atomic<uint64_t>>)
+            {
+                column[i].store(0, std::memory_order_relaxed);
+            }
+            else
+            {
+                column[i] = 0;
+            }
+        }
+    }
+
+    size_t m_size;                              ///< The number of elements.
+    ZeroedArray<std::atomic<uint64_t>> m_bits;  ///< Dedup bitset, one bit per number.
+    ZeroedArray<size_t> m_orders;               ///< Order column, empty if disabled.
+    ZeroedArray<long long> m_times;             ///< Generation time column, empty if disabled.
+};
+
+}  // namespace core
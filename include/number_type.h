@@ -0,0 +1,14 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+
+namespace core
+{
+
+/**
+ * @brief The types of the generated numbers: int up to INT_MAX, uint64_t beyond.
+ */
+template <typename T>
+concept NumberType = std::same_as<T, int> || std::same_as<T, uint64_t>;
+
+}  // namespace core
@@ -0,0 +1,204 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "result_file.h"
+
+namespace core
+{
+
+/**
+ * @brief The formats of the generated numbers written by an OutputSink.
+ */
+enum class OutputFormat
+{
+    Text,    ///< "number = 00042, order = 00007, generation_time = 0000000012" lines.
+    Csv,     ///< A "number,order,generation_time" header, then one row per number.
+    Binary,  ///< One BinaryRecord per number, in native byte order.
+    Mapped,  ///< Straight into a MappedResultFile, without a writer thread.
+    Quiet    ///< Nothing at all.
+};
+
+/**
+ * @brief Parses the name of an output format.
+ *
+ * @param name One of "text", "csv", "binary", "mapped" or "quiet".
+ * @return The format, or std::nullopt if the name is unknown.
+ */
+[[nodiscard]] std::optional<OutputFormat> parseOutputFormat(std::string_view name);
+
+/**
+ * @struct BinaryRecord
+ * @brief A generated number in the binary output format.
+ */
+struct BinaryRecord
+{
+    int32_t m_number;          ///< The generated number.
+    uint32_t m_order;          ///< The order in which the number was generated.
+    int64_t m_generationTime;  ///< The time in microseconds taken to generate the number.
+};
+
+/**
+ * @class OutputSink
+ * @brief Writes the generated numbers from a dedicated thread.
+ *
+ * Worker threads do not print. Each of them formats its numbers into the
+ * buffer of its own Writer and hands the buffer over once it is full. A
+ * writer thread owned by the sink writes the buffers to the file
+ * descriptor with large write(2) calls and returns them for reuse, so the
+ * workers do not wait on the terminal or the disk. Buffers of different
+ * workers are written whole, in the order they were handed over. At most
+ * kMaxPendingBuffers buffers wait to be written: past that, workers wait
+ * for the writer thread, so memory stays bounded however large the run.
+ * Records are formatted in place with std::format_to, and once enough
+ * buffers circulate, handing one over allocates nothing.
+ *
+ * A sink over a MappedResultFile has no buffers and no thread: writers
+ * store every number into the mapping at once.
+ */
+class OutputSink
+{
+   public:
+    /// Size from which a Writer hands its buffer over to the writer thread.
+    static constexpr size_t kBufferSize = size_t{1} << 16;
+    /// Number of buffers waiting for the writer thread from which submitting workers wait.
+    static constexpr size_t kMaxPendingBuffers = 256;
+
+    /**
+     * @class Writer
+     * @brief The buffer of one worker thread.
+     */
+    class Writer
+    {
+       public:
+        /**
+         * @brief Constructs a writer with an empty buffer.
+         *
+         * @param sink Reference to the sink receiving the buffers.
+         */
+        explicit Writer(OutputSink& sink);
+
+        Writer(Writer&& other) noexcept = default;
+        Writer& operator=(Writer&& other) = delete;
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        /**
+         * @brief Hands the remaining buffered records over to the sink.
+         */
+        ~Writer() { flush(); }
+
+        /**
+         * @brief Appends a generated number in the format of the sink.
+         *
+         * @param number The generated number.
+         * @param order The order in which the number was generated.
+         * @param generationTime The time in microseconds taken to generate the number.
+         */
+        void write(uint64_t number, size_t order, long long generationTime);
+
+        /**
+         * @brief Hands the buffered records over to the sink.
+         */
+        void flush();
+
+       private:
+        OutputSink* m_sink;          ///< Pointer to the sink receiving the buffers.
+        std::vector<char> m_buffer;  ///< Records not handed over yet.
+    };
+
+    /**
+     * @brief Constructs a sink and starts its writer thread.
+     *
+     * @param format The format of the records.
+     * @param fd The file descriptor written to. The sink does not close it.
+     * @param writeHeader Whether to start with the header of the format. Sinks of
+     *                    worker processes appending to the output of a parent leave it out.
+     */
+    OutputSink(OutputFormat format, int fd, bool writeHeader = true);
+
+    /**
+     * @brief Constructs a sink of the Mapped format, storing the numbers into a file.
+     *
+     * @param file Reference to the mapped file. It must outlive the sink.
+     */
+    explicit OutputSink(MappedResultFile& file);
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    /**
+     * @brief Writes the pending buffers and stops the writer thread.
+     */
+    ~OutputSink() { close(); }
+
+    /**
+     * @brief Writes the pending buffers and stops the writer thread.
+     *
+     * All writers must be flushed before. Further calls do nothing.
+     */
+    void close();
+
+    /**
+     * @brief Returns the format of the records.
+     */
+    [[nodiscard]] OutputFormat format() const noexcept { return m_format; }
+
+    /**
+     * @brief Returns when the number of order 1 was written, if it was.
+     */
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> firstNumberTime()
+        const noexcept;
+
+   private:
+    /**
+     * @brief Queues a buffer for the writer thread and returns an empty one.
+     *
+     * @param buffer The buffer to write.
+     * @return An empty buffer, recycled if possible.
+     */
+    std::vector<char> submit(std::vector<char> buffer);
+
+    /**
+     * @brief The loop of the writer thread.
+     */
+    void run();
+
+    /**
+     * @brief Writes a whole buffer to the file descriptor.
+     *
+     * @param buffer The buffer to write.
+     */
+    void writeAll(const std::vector<char>& buffer);
+
+    /**
+     * @brief Appends a buffer to the ring of pending buffers. Called under the mutex.
+     *
+     * @param buffer The buffer to write.
+     */
+    void pushPending(std::vector<char> buffer);
+
+    OutputFormat m_format;                      ///< The format of the records.
+    int m_fd;                                   ///< The file descriptor written to, -1 if mapped.
+    MappedResultFile* m_file = nullptr;         ///< The file of the Mapped format.
+    std::mutex m_mutex;                         ///< Protects the members below.
+    std::condition_variable m_cv;               ///< Signals pending buffers and stopping.
+    std::condition_variable m_roomCv;           ///< Signals room for more pending buffers.
+    std::vector<std::vector<char>> m_pending;   ///< Ring of buffers waiting to be written.
+    size_t m_pendingHead = 0;                   ///< Slot of the next buffer to write.
+    size_t m_pendingCount = 0;                  ///< Number of buffers waiting to be written.
+    std::vector<std::vector<char>> m_free;      ///< Written buffers, ready for reuse.
+    bool m_stopping = false;                    ///< Set by close().
+    std::atomic<int64_t> m_firstNumberTime{0};  ///< steady_clock ticks of the first number, or 0.
+    std::thread m_thread;                       ///< The writer thread.
+};
+
+}  // namespace core
@@ -0,0 +1,195 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+
+/**
+ * @class PageMemoryResource
+ * @brief A memory resource serving every allocation with its own anonymous mapping.
+ *
+ * The kernel hands out zero-filled pages on demand: mapping even a huge
+ * block costs nothing until its pages are first written, and no code has
+ * to clear it. Each page is then allocated on the NUMA node of the thread
+ * that first writes it, so the threads that will use a block can fault it
+ * in themselves. With huge pages, blocks of at least kHugePageSize are
+ * aligned to it and advised with MADV_HUGEPAGE, so that transparent huge
+ * pages can back them and the random accesses into a large bitset miss
+ * the TLB less often. Platforms without MADV_HUGEPAGE, such as macOS, only
+ * get the alignment.
+ */
+class PageMemoryResource final : public std::pmr::memory_resource
+{
+   public:
+    /// Size of the huge pages blocks are aligned to.
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+
+    /**
+     * @brief Constructs a resource.
+     *
+     * @param hugePages Whether to advise large blocks to use transparent huge pages.
+     *                  Without MADV_HUGEPAGE, large blocks are only aligned.
+     */
+    explicit PageMemoryResource(bool hugePages = false) noexcept : m_hugePages(hugePages) {}
+
+    /**
+     * @brief Checks whether large blocks are advised to use transparent huge pages.
+     */
+    [[nodiscard]] bool hugePages() const noexcept { return m_hugePages; }
+
+    /**
+     * @brief Returns the size of a page.
+     */
+    [[nodiscard]] static size_t pageSize() noexcept;
+
+    /**
+     * @brief Checks whether a resource hands out zero-filled memory.
+     *
+     * @param resource The memory resource.
+     * @return true if the resource is a PageMemoryResource.
+     */
+    [[nodiscard]] static bool zeroFills(const std::pmr::memory_resource* resource) noexcept
+    {
+        return dynamic_cast<const PageMemoryResource*>(resource) != nullptr;
+    }
+
+   private:
+    /**
+     * @brief Maps a zero-filled block of whole pages.
+     *
+     * @throws std::bad_alloc If the block cannot be mapped or the alignment exceeds a page.
+     */
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    /**
+     * @brief Unmaps a block returned by do_allocate().
+     */
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    bool m_hugePages;  ///< Whether large blocks are advised to use huge pages.
+};
+
+/**
+ * @class ZeroedArray
+ * @brief A fixed-size array of zero-initialized elements allocated from a memory resource.
+ *
+ * Memory from a PageMemoryResource is already zero, so the elements are
+ * not written at all and the pages stay untouched until first used. Any
+ * other resource gets its elements value-initialized. Zero bytes must thus
+ * be a valid value of T, as for integers and lock-free atomics.
+ *
+ * @tparam T The type of the elements.
+ */
+template <typename T>
+class ZeroedArray
+{
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "elements of a ZeroedArray are released without being destroyed");
+
+   public:
+    /**
+     * @brief Allocates and zero-initializes an array.
+     *
+     * @param size The number of elements.
+     * @param resource The memory resource the elements are allocated from.
+     * @param alignment The alignment of the first element, at least alignof(T).
+     */
+    ZeroedArray(size_t size, std::pmr::memory_resource* resource, size_t alignment = alignof(T))
+        : m_size(size), m_alignment(std::max(alignment, alignof(T))), m_resource(resource)
+    {
+        if (m_size == 0)
+        {
+            return;
+        }
+        void* memory = m_resource->allocate(m_size * sizeof(T), m_alignment);
+        if (PageMemoryResource::zeroFills(m_resource))
+        {
+            m_data = std::launder(static_cast<T*>(memory));
+        }
+        else
+        {
+            m_data = static_cast<T*>(memory);
+            std::uninitialized_value_construct_n(m_data, m_size);
+        }
+    }
+
+    ZeroedArray(ZeroedArray&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_alignment(other.m_alignment)
+        , m_resource(other.m_resource)
+    {
+    }
+    ZeroedArray& operator=(ZeroedArray&& other) = delete;
+    ZeroedArray(const ZeroedArray&) = delete;
+    ZeroedArray& operator=(const ZeroedArray&) = delete;
+
+    /**
+     * @brief Returns the elements to the memory resource.
+     */
+    ~ZeroedArray()
+    {
+        if (m_data != nullptr)
+        {
+            m_resource->deallocate(m_data, m_size * sizeof(T), m_alignment);
+        }
+    }
+
+    /**
+     * @brief Returns the elements.
+     */
+    [[nodiscard]] T* data() noexcept { return m_data; }
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    /**
+     * @brief Checks whether the array has no elements.
+     */
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    /**
+     * @brief Accesses an element.
+     *
+     * @param index The index of the element, below size().
+     */
+    [[nodiscard]] T& operator[](size_t index) noexcept { return m_data[index]; }
+
+    /**
+     * @brief Accesses an element.
+     *
+     * @param index The index of the element, below size().
+     */
+    [[nodiscard]] const T& operator[](size_t index) const noexcept { return m_data[index]; }
+
+    /**
+     * @brief Returns the first element, for range-based loops and algorithms.
+     */
+    [[nodiscard]] const T* begin() const noexcept { return m_data; }
+
+    /**
+     * @brief Returns the end of the elements.
+     */
+    [[nodiscard]] const T* end() const noexcept { return m_data + m_size; }
+
+   private:
+    T* m_data = nullptr;                    ///< The elements, null if empty.
+    size_t m_size;                          ///< The number of elements.
+    size_t m_alignment;                     ///< The alignment of the elements' block.
+    std::pmr::memory_resource* m_resource;  ///< The resource the elements come from.
+};
+
+}  // namespace core
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+
+#include "feistel_permutation.h"
+#include "number_storage.h"
+#include "output_sink.h"
+
+/**
+ * @class PermutationWorker
+ * @brief A worker of the permutation mode, emitting one range of a random permutation.
+ *
+ * Instead of drawing random numbers and rejecting duplicates, the
+ * permutation mode maps the indices 0..N-1 through a keyed
+ * core::FeistelPermutation. Each worker owns a disjoint range of indices,
+ * so the workers together emit every number exactly once in O(N) total
+ * work, without queues and without coordination. The order of a number is
+ * its index in the permutation plus one.
+ *
+ * Without a storage, a worker keeps no state per number at all, so the
+ * range can go far beyond INT_MAX and beyond what fits in memory.
+ */
+class PermutationWorker
+{
+   public:
+    /**
+     * @brief Constructs a PermutationWorker.
+     *
+     * @param permutation Reference to the permutation of 0..N-1 shared by all workers.
+     * @param storage Pointer to the storage recording the generated numbers, or
+     *                nullptr to only emit them.
+     * @param sink Reference to the sink writing out the generated numbers.
+     * @param first The first index emitted by this worker.
+     * @param last The index after the last one emitted by this worker.
+     */
+    PermutationWorker(const core::FeistelPermutation& permutation,
+                      core::NumberStorage* storage,
+                      core::OutputSink& sink,
+                      uint64_t first,
+                      uint64_t last)
+        : m_first(first)
+        , m_last(last)
+        , m_permutation(&permutation)
+        , m_storage(storage)
+        , m_writer(sink)
+    {
+    }
+
+    /**
+     * @brief Emits the numbers of this worker's range of the permutation.
+     */
+    void generate();
+
+   private:
+    uint64_t m_first;                               ///< The first index of the range.
+    uint64_t m_last;                                ///< The index after the range.
+    const core::FeistelPermutation* m_permutation;  ///< Pointer to the shared permutation.
+    core::NumberStorage* m_storage;                 ///< Pointer to the storage, may be null.
+    core::OutputSink::Writer m_writer;              ///< Buffer of the numbers to write.
+};
@@ -1,6 +1,15 @@
 #pragma once
-#include <random>
+#include <atomic>
+#include <vector>
 
+#include "blocking_queue.h"
+#include "cache_line.h"
+#include "completion_poll.h"
+#include "lock_free_queue.h"
+#include "metrics.h"
+#include "number_storage.h"
+#include "random_source.h"
+#include "remaining_sampler.h"
 #include "thread_safe_queue.h"
 
 /**
@@ -11,25 +20,61 @@
  * and pushes them into a provided thread-safe queue. It keeps track
  * of the number of elements to produce and can signal when the
  * production is complete.
+ *
+ * @tparam Queue The queue type: core::ThreadSafeQueue<T>,
+ *               core::LockFreeQueue<T> or core::BlockingQueue<T>, of int
+ *               numbers up to INT_MAX or of uint64_t numbers beyond. With
+ *               a blocking queue the thread parks instead of polling and
+ *               values are moved one at a time.
+ *
+ * A producer given the dedup bitset drops the draws already generated
+ * before pushing them, with a plain load of the bitset word. The check is
+ * only a hint, since a number may be marked right after it; consumers
+ * still reject duplicates on their own. Late in a run, when most draws
+ * are duplicates, this keeps most of them out of the queue.
+ *
+ * Producers are kept in arrays, so each of them starts on its own cache
+ * line: the buffer of one producer's random source is never on the line
+ * of its neighbour's.
  */
-class Producer
+template <typename Queue>
+class alignas(core::kCacheLineSize) Producer
 {
    public:
+    using value_type = typename Queue::value_type;
+
     /**
      * @brief Constructs a Producer.
      *
      * @param queue Reference to the thread-safe queue where produced
      *              integers will be stored.
-     * @param elements The number of elements to produce.
+     * @param random The source of random integers of this producer.
      * @param completed Reference to an atomic boolean to signal
      *                  completion of production.
+     * @param batchSize The number of integers generated and pushed with a
+     *                  single bulk push. 1 pushes every integer on its own.
+     * @param metrics Pointer to the metrics of the run, or nullptr to record none.
+     * @param remaining Pointer to the sampler switching the producers to the missing
+     *                  numbers, or nullptr to draw uniformly until the end.
+     * @param filter Pointer to the storage whose bitset draws are checked against
+     *               before they are pushed, or nullptr to push every draw.
      */
-    Producer(core::ThreadSafeQueue<int>& queue, int elements, std::atomic_bool& completed)
-        : m_elementsNr(elements)
+    Producer(Queue& queue,
+             core::RandomSource random,
+             std::atomic_bool& completed,
+             size_t batchSize = 1,
+             core::Metrics* metrics = nullptr,
+             core::RemainingSampler* remaining = nullptr,
+             const core::NumberStorage* filter = nullptr)
+        : m_batchSize(batchSize)
+        , m_batch(batchSize > 1 ? batchSize : 0)
         , m_queue(&queue)
-        , m_completed(&completed)
-        , m_generator(std::random_device{}())
-        , m_distribution(1, m_elementsNr)
+        , m_completion(completed)
+        , m_random(random)
+        , m_metrics(metrics)
+        , m_threadMetrics(metrics != nullptr ? &metrics->registerThread() : nullptr)
+        , m_remaining(remaining)
+        , m_filter(filter)
     {
     }
 
@@ -43,12 +88,103 @@ class Producer
      */
     void produce();
 
+    /**
+     * @brief Returns the number of values this producer drew and pushed.
+     *
+     * Uniform draws count whether or not they were pushed; after a switch
+     * to the missing numbers, every pushed value counts as one draw.
+     */
+    [[nodiscard]] uint64_t draws() const noexcept { return m_draws; }
+
+   private:
+    /**
+     * @brief Produces random integers in batches of m_batchSize.
+     *
+     * Each batch is generated into m_batch and then handed to the
+     * queue with tryPushBulk, so one synchronization covers the whole batch.
+     */
+    void produceBatches();
+
+    /**
+     * @brief Pushes this producer's slice of the missing numbers, once the sampler switched.
+     */
+    void produceRemaining();
+
+    /**
+     * @brief Checks whether the producer should switch to the missing numbers.
+     */
+    [[nodiscard]] bool remainingActive() const noexcept
+    {
+        return m_remaining != nullptr && m_remaining->active();
+    }
+
+    /**
+     * @brief Accounts for a uniform draw.
+     *
+     * @param value The drawn number.
+     */
+    void onDrawn(value_type value)
+    {
+        ++m_draws;
+        if (m_remaining != nullptr)
+        {
+            m_remaining->observe(m_monitor, value);
+        }
+    }
+
+    /**
+     * @brief Checks a draw against the dedup bitset, if this producer filters its draws.
+     *
+     * @param value The drawn number.
+     * @return true if the number is already generated and is not worth pushing.
+     */
+    [[nodiscard]] bool filterOut(value_type value) noexcept
+    {
+        if (m_filter == nullptr || !m_filter->isMarked(value))
+        {
+            return false;
+        }
+        if (m_threadMetrics != nullptr)
+        {
+            m_threadMetrics->m_filtered.add(1);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Pushes an integer into a blocking queue, waiting for room if needed.
+     *
+     * @param value The integer to push.
+     * @return false if the queue was closed.
+     */
+    bool pushWaiting(value_type value)
+        requires core::BlockingQueueType<Queue>;
+
+    /**
+     * @brief Records a failed push attempt.
+     *
+     * @param waitStart The time of the first failed attempt of the current push, 0 if none.
+     * @return The time of the first failed attempt of the current push.
+     */
+    uint64_t onPushFailed(uint64_t waitStart);
+
    private:
-    int m_elementsNr;  ///< The total number of elements to produce.
-    core::ThreadSafeQueue<int>*
-        m_queue;  ///< Pointer to the thread-safe queue for storing produced integers.
-    std::atomic_bool* m_completed;           ///< Pointer to the completion flag.
-    std::default_random_engine m_generator;  ///< Random number generator.
-    std::uniform_int_distribution<int>
-        m_distribution;  ///< Distribution for generating random integers.
-};
\ No newline at end of file
+    size_t m_batchSize;                         ///< The number of integers pushed at once.
+    std::vector<value_type> m_batch;            ///< Buffer of a batch, allocated once.
+    Queue* m_queue;                             ///< Pointer to the queue for produced integers.
+    core::CompletionPoll m_completion;          ///< Poll of the completion flag.
+    core::RandomSource m_random;                ///< Source of the random integers.
+    core::Metrics* m_metrics;                   ///< Pointer to the metrics of the run, may be null.
+    core::ThreadMetrics* m_threadMetrics;       ///< Pointer to the metrics of this producer.
+    core::RemainingSampler* m_remaining;        ///< Pointer to the missing numbers, may be null.
+    core::RemainingSampler::Monitor m_monitor;  ///< Miss rate estimate of this producer.
+    const core::NumberStorage* m_filter;        ///< Pointer to the bitset checked, may be null.
+    uint64_t m_draws = 0;                       ///< Values drawn and pushed so far.
+};
+
+extern template class Producer<core::ThreadSafeQueue<int>>;
+extern template class Producer<core::LockFreeQueue<int>>;
+extern template class Producer<core::BlockingQueue<int>>;
+extern template class Producer<core::ThreadSafeQueue<uint64_t>>;
+extern template class Producer<core::LockFreeQueue<uint64_t>>;
+extern template class Producer<core::BlockingQueue<uint64_t>>;
\ No newline at end of file
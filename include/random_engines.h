@@ -0,0 +1,302 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace core
+{
+
+/**
+ * @brief Advances a SplitMix64 state and returns its next output.
+ *
+ * Used to expand a single 64-bit seed into the state of the engines below.
+ *
+ * @param state The SplitMix64 state.
+ * @return The next output.
+ */
+[[nodiscard]] constexpr uint64_t splitMix64(uint64_t& state) noexcept
+{
+    uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @class Xoshiro256StarStar
+ * @brief The xoshiro256** generator by Blackman and Vigna.
+ *
+ * 256 bits of state, a period of 2^256 - 1 and a jump() that advances the
+ * state by 2^128 steps, which splits one seed into non-overlapping streams.
+ * Satisfies UniformRandomBitGenerator.
+ */
+class Xoshiro256StarStar
+{
+   public:
+    using result_type = uint64_t;
+
+    /**
+     * @brief Seeds the generator, expanding the seed with SplitMix64.
+     *
+     * @param seed The seed.
+     */
+    explicit Xoshiro256StarStar(uint64_t seed) noexcept
+    {
+        for (auto& word : m_state)
+        {
+            word = splitMix64(seed);
+        }
+    }
+
+    /**
+     * @brief Seeds the generator with an explicit state, which must not be all zeros.
+     *
+     * @param state The state.
+     */
+    explicit Xoshiro256StarStar(const std::array<uint64_t, 4>& state) noexcept : m_state(state) {}
+
+    /**
+     * @brief Returns the next 64-bit output.
+     */
+    uint64_t operator()() noexcept
+    {
+        const uint64_t result = std::rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t shifted = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= shifted;
+        m_state[3] = std::rotl(m_state[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Advances the state by 2^128 steps.
+     *
+     * Jumping k times gives the start of stream k of the seed.
+     */
+    void jump() noexcept
+    {
+        constexpr std::array<uint64_t, 4> kJump = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                                   0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+        std::array<uint64_t, 4> state{};
+        for (uint64_t jumpWord : kJump)
+        {
+            for (int bit = 0; bit < 64; ++bit)
+            {
+                if ((jumpWord & (uint64_t{1} << bit)) != 0)
+                {
+                    for (size_t i = 0; i < state.size(); ++i)
+                    {
+                        state[i] ^= m_state[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        m_state = state;
+    }
+
+    /**
+     * @brief Returns the state of the generator.
+     */
+    [[nodiscard]] const std::array<uint64_t, 4>& state() const noexcept { return m_state; }
+
+    static constexpr uint64_t min() noexcept { return 0; }
+    static constexpr uint64_t max() noexcept { return std::numeric_limits<uint64_t>::max(); }
+
+   private:
+    std::array<uint64_t, 4> m_state{};  ///< The generator state.
+};
+
+/**
+ * @class Pcg64
+ * @brief The PCG64 generator by O'Neill: a 128-bit LCG with the XSL-RR output function.
+ *
+ * Each odd increment selects an independent stream of the same seed.
+ * Satisfies UniformRandomBitGenerator.
+ */
+class Pcg64
+{
+   public:
+    using result_type = uint64_t;
+
+    /**
+     * @brief Seeds the generator on one of its streams.
+     *
+     * @param seed The seed.
+     * @param stream The stream selecting the increment of the LCG.
+     */
+    Pcg64(uint64_t seed, uint64_t stream) noexcept
+        : m_increment((static_cast<unsigned __int128>(stream) << 1) | 1)
+    {
+        step();
+        m_state += seed;
+        step();
+    }
+
+    /**
+     * @brief Returns the next 64-bit output.
+     */
+    uint64_t operator()() noexcept
+    {
+        step();
+        const auto high = static_cast<uint64_t>(m_state >> 64);
+        const auto low = static_cast<uint64_t>(m_state);
+        return std::rotr(high ^ low, static_cast<int>(m_state >> 122));
+    }
+
+    static constexpr uint64_t min() noexcept { return 0; }
+    static constexpr uint64_t max() noexcept { return std::numeric_limits<uint64_t>::max(); }
+
+   private:
+    /**
+     * @brief Advances the LCG by one step.
+     */
+    void step() noexcept
+    {
+        constexpr auto kMultiplier =
+            (static_cast<unsigned __int128>(2549297995355413924ULL) << 64) | 4865540595714422341ULL;
+        m_state = m_state * kMultiplier + m_increment;
+    }
+
+    unsigned __int128 m_state = 0;  ///< The LCG state.
+    unsigned __int128 m_increment;  ///< The odd LCG increment, selecting the stream.
+};
+
+/**
+ * @class Philox4x32
+ * @brief The counter-based Philox4x32-10 generator by Salmon et al. (Random123).
+ *
+ * Each output block is a pure function of a key and a 128-bit counter:
+ * ten rounds of two 32x32-bit multiplications scramble the counter. The
+ * key is the seed, the high half of the counter is the stream and the low
+ * half counts the blocks of the stream, so the n-th output of any stream
+ * is known without generating the ones before it. A block holds two
+ * 64-bit outputs. Satisfies UniformRandomBitGenerator.
+ */
+class Philox4x32
+{
+   public:
+    using result_type = uint64_t;
+    using Block = std::array<uint32_t, 4>;
+
+    /**
+     * @brief Positions the generator at the start of one stream of a seed.
+     *
+     * @param seed The seed, used as the key.
+     * @param stream The stream, the high half of the counter.
+     */
+    Philox4x32(uint64_t seed, uint64_t stream) noexcept
+        : m_key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}
+        , m_stream(stream)
+    {
+    }
+
+    /**
+     * @brief Returns the block of a key and a counter.
+     *
+     * @param key The key.
+     * @param counter The counter.
+     * @return The scrambled counter.
+     */
+    [[nodiscard]] static constexpr Block block(std::array<uint32_t, 2> key, Block counter) noexcept
+    {
+        constexpr uint64_t kMultiplier0 = 0xD2511F53;
+        constexpr uint64_t kMultiplier1 = 0xCD9E8D57;
+        constexpr uint32_t kWeyl0 = 0x9E3779B9;
+        constexpr uint32_t kWeyl1 = 0xBB67AE85;
+        for (int round = 0; round < 10; ++round)
+        {
+            const uint64_t product0 = kMultiplier0 * counter[0];
+            const uint64_t product1 = kMultiplier1 * counter[2];
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                       static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                       static_cast<uint32_t>(product0)};
+            key[0] += kWeyl0;
+            key[1] += kWeyl1;
+        }
+        return counter;
+    }
+
+    /**
+     * @brief Returns the next 64-bit output.
+     */
+    uint64_t operator()() noexcept
+    {
+        if (m_next == m_outputs.size())
+        {
+            const Block output = block(m_key, {static_cast<uint32_t>(m_counter),
+                                               static_cast<uint32_t>(m_counter >> 32),
+                                               static_cast<uint32_t>(m_stream),
+                                               static_cast<uint32_t>(m_stream >> 32)});
+            m_outputs = {output[0] | (uint64_t{output[1]} << 32),
+                         output[2] | (uint64_t{output[3]} << 32)};
+            ++m_counter;
+            m_next = 0;
+        }
+        return m_outputs[m_next++];
+    }
+
+    /**
+     * @brief Moves to a block of the stream, so that the next output is its first one.
+     *
+     * @param counter The index of the block in the stream.
+     */
+    void seek(uint64_t counter) noexcept
+    {
+        m_counter = counter;
+        m_next = m_outputs.size();
+    }
+
+    static constexpr uint64_t min() noexcept { return 0; }
+    static constexpr uint64_t max() noexcept { return std::numeric_limits<uint64_t>::max(); }
+
+   private:
+    std::array<uint32_t, 2> m_key;        ///< The key, from the seed.
+    uint64_t m_stream;                    ///< The high half of the counter.
+    uint64_t m_counter = 0;               ///< The next block of the stream.
+    std::array<uint64_t, 2> m_outputs{};  ///< The outputs of the current block.
+    size_t m_next = 2;                    ///< Index of the next output of the block.
+};
+
+/**
+ * @class Xoshiro256x4
+ * @brief Four interleaved xoshiro256** generators, stepped together with AVX2 when available.
+ *
+ * The lanes start on consecutive jump() streams of one seed. fill() writes
+ * the outputs of the four lanes in turn, using 256-bit vectors if the CPU
+ * supports AVX2 (checked at run time) and a plain loop otherwise.
+ */
+class Xoshiro256x4
+{
+   public:
+    /// Number of generators stepped together.
+    static constexpr size_t kLanes = 4;
+
+    /**
+     * @brief Seeds the lanes with streams 4*stream..4*stream+3 of the seed.
+     *
+     * @param seed The seed.
+     * @param stream The index of this group of lanes.
+     */
+    Xoshiro256x4(uint64_t seed, uint64_t stream) noexcept;
+
+    /**
+     * @brief Fills a buffer with 64-bit outputs.
+     *
+     * @param values The buffer; its size should be a multiple of kLanes,
+     *               otherwise the outputs past the end are dropped.
+     */
+    void fill(std::span<uint64_t> values) noexcept;
+
+   private:
+    alignas(32) std::array<std::array<uint64_t, kLanes>, 4> m_state{};  ///< State word i of lane j.
+};
+
+}  // namespace core
@@ -0,0 +1,164 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <variant>
+
+#include "number_type.h"
+#include "random_engines.h"
+
+namespace core
+{
+
+/**
+ * @brief The random engines a RandomSource can run on.
+ */
+enum class RandomEngine
+{
+    Standard,      ///< std::default_random_engine with std::uniform_int_distribution.
+    Xoshiro256,    ///< xoshiro256** with Lemire's bounded reduction.
+    Pcg64,         ///< PCG64 with Lemire's bounded reduction.
+    Xoshiro256x4,  ///< Four xoshiro256** lanes in AVX2 registers with Lemire's reduction.
+    Philox         ///< Counter-based Philox4x32-10 with Lemire's bounded reduction.
+};
+
+/**
+ * @brief Parses the name of a random engine.
+ *
+ * @param name One of "std", "xoshiro", "pcg", "simd" or "philox".
+ * @return The engine, or std::nullopt if the name is unknown.
+ */
+[[nodiscard]] std::optional<RandomEngine> parseRandomEngine(std::string_view name);
+
+/**
+ * @class RandomSource
+ * @brief Uniform random integers in 1..elements from an engine selected at run time.
+ *
+ * The engine is dispatched once per batch, not once per number: fill()
+ * runs the loop of the selected engine over the whole buffer, and next()
+ * hands out numbers from an internal buffer refilled by fill(). Apart from
+ * the standard engine, numbers are reduced to the range with Lemire's
+ * nearly divisionless method: one 32x32-bit multiplication per number,
+ * with a division only to compute the rejection threshold once. Numbers
+ * of type uint64_t take one 64x64-bit multiplication each, so they cover
+ * ranges beyond 2^32.
+ *
+ * Each source owns its engine, so every thread needs its own source.
+ * Sources built from the same seed with different stream indices produce
+ * non-overlapping sequences, and a source replays the same sequence for the
+ * same engine, seed and stream.
+ */
+class RandomSource
+{
+   public:
+    /// Number of numbers generated at once by next().
+    static constexpr size_t kBufferSize = 256;
+
+    /**
+     * @brief Constructs a source on one stream of a seed.
+     *
+     * @param engine The engine to run.
+     * @param elements The upper bound of the generated numbers. Sources of
+     *                 numbers of type int need it not to exceed INT_MAX.
+     * @param seed The seed shared by all streams.
+     * @param stream The stream of this source, e.g. the index of its thread.
+     */
+    RandomSource(RandomEngine engine, uint64_t elements, uint64_t seed, uint64_t stream);
+
+    /**
+     * @brief Fills a buffer with uniform random integers in 1..elements.
+     *
+     * @param values The buffer to fill.
+     */
+    void fill(std::span<int> values);
+
+    /**
+     * @brief Fills a buffer with uniform random 64-bit integers in 1..elements.
+     *
+     * @param values The buffer to fill.
+     */
+    void fill(std::span<uint64_t> values);
+
+    /**
+     * @brief Returns one uniform random integer in 1..elements.
+     *
+     * A source hands out numbers of one type only.
+     *
+     * @tparam T The type of the number.
+     */
+    template <NumberType T = int>
+    [[nodiscard]] T next()
+    {
+        auto& buffer = bufferOf<T>();
+        if (m_next == buffer.size())
+        {
+            fill(std::span<T>(buffer));
+            m_next = 0;
+        }
+        return buffer[m_next++];
+    }
+
+   private:
+    /**
+     * @struct StandardEngine
+     * @brief The standard library engine and distribution used before the fast engines.
+     */
+    struct StandardEngine
+    {
+        std::default_random_engine m_generator;             ///< The engine.
+        std::uniform_int_distribution<int> m_distribution;  ///< The distribution over 1..elements.
+    };
+
+    /**
+     * @brief Fills a buffer with Lemire's reduction of raw 64-bit outputs.
+     *
+     * @tparam Generate Callable filling a span of uint64_t with raw outputs.
+     * @param values The buffer to fill.
+     * @param generate The raw generator.
+     */
+    template <typename Generate>
+    void fillBounded(std::span<int> values, Generate generate);
+
+    /**
+     * @brief Fills a buffer with Lemire's 64-bit reduction of raw 64-bit outputs.
+     *
+     * @tparam Generate Callable filling a span of uint64_t with raw outputs.
+     * @param values The buffer to fill.
+     * @param generate The raw generator.
+     */
+    template <typename Generate>
+    void fillBoundedWide(std::span<uint64_t> values, Generate generate);
+
+    /**
+     * @brief Returns the buffer of next() for numbers of a type.
+     */
+    template <NumberType T>
+    [[nodiscard]] auto& bufferOf() noexcept
+    {
+        if constexpr (std::same_as<T, int>)
+        {
+            return m_buffer;
+        }
+        else
+        {
+            return m_wideBuffer;
+        }
+    }
+
+    uint64_t m_elements;       ///< The number of values in 1..elements.
+    uint32_t m_range;          ///< The number of values in 1..elements, if it fits 32 bits.
+    uint32_t m_threshold;      ///< Lemire's rejection threshold, 2^32 mod m_range.
+    uint64_t m_wideThreshold;  ///< Lemire's 64-bit rejection threshold, 2^64 mod m_elements.
+    std::variant<StandardEngine, Xoshiro256StarStar, Pcg64, Xoshiro256x4, Philox4x32>
+        m_engine;                                      ///< The engine, selected at construction.
+    std::array<uint64_t, kBufferSize / 2> m_raw{};     ///< Raw outputs, two numbers per output.
+    std::array<int, kBufferSize> m_buffer{};           ///< Numbers handed out by next<int>().
+    std::array<uint64_t, kBufferSize> m_wideBuffer{};  ///< Numbers handed out by next<uint64_t>().
+    size_t m_next = kBufferSize;                       ///< Index of the next number to hand out.
+};
+
+}  // namespace core
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "number_storage.h"
+
+namespace core
+{
+
+/**
+ * @class RemainingSampler
+ * @brief Lets producers draw from the numbers still missing once uniform draws mostly miss.
+ *
+ * Uniform draws over 1..N pay the coupon collector's tail: once a fraction
+ * f of the numbers is generated, a draw misses with probability f, and the
+ * last few percent cost more draws than everything before. Producers
+ * therefore probe one draw in kProbeInterval against the dedup bitset and
+ * estimate the miss rate over windows of kWindow probes. As soon as one
+ * producer sees the rate cross the threshold, the sampler switches for all
+ * of them: it collects the numbers still missing, shuffles them, and deals
+ * them into one disjoint slice per producer. From then on every value a
+ * producer pushes is new, apart from the few that were already in flight
+ * in the queue when the sampler switched.
+ */
+class RemainingSampler
+{
+   public:
+    /// One draw in kProbeInterval is checked against the bitset.
+    static constexpr unsigned kProbeInterval = 16;
+    /// Number of probes over which the miss rate is estimated.
+    static constexpr unsigned kWindow = 64;
+
+    /**
+     * @struct Monitor
+     * @brief The miss rate estimate of one producer.
+     */
+    struct Monitor
+    {
+        unsigned m_draws = 0;   ///< Draws since the last probe.
+        unsigned m_probes = 0;  ///< Probes in the current window.
+        unsigned m_misses = 0;  ///< Probes of the current window that hit generated numbers.
+    };
+
+    /**
+     * @brief Constructs a sampler that has not switched yet.
+     *
+     * @param storage Reference to the storage of the generated numbers.
+     * @param producersNr The number of producers, i.e. of slices.
+     * @param missRate The miss rate, in 0..1, from which producers switch.
+     * @param seed The seed of the shuffle of the missing numbers.
+     */
+    RemainingSampler(const NumberStorage& storage,
+                     size_t producersNr,
+                     double missRate,
+                     uint64_t seed);
+
+    /**
+     * @brief Accounts for one uniform draw of a producer, switching if it mostly misses.
+     *
+     * @param monitor The estimate of the producer.
+     * @param value The drawn number.
+     */
+    void observe(Monitor& monitor, uint64_t value)
+    {
+        if (++monitor.m_draws < kProbeInterval)
+        {
+            return;
+        }
+        monitor.m_draws = 0;
+        monitor.m_misses += m_storage->isMarked(value) ? 1 : 0;
+        if (++monitor.m_probes < kWindow)
+        {
+            return;
+        }
+        if (monitor.m_misses >= m_missThreshold)
+        {
+            activate();
+        }
+        monitor.m_probes = 0;
+        monitor.m_misses = 0;
+    }
+
+    /**
+     * @brief Checks whether producers should draw from the missing numbers.
+     */
+    [[nodiscard]] bool active() const noexcept { return m_active.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Switches all producers to the missing numbers. Further calls do nothing.
+     */
+    void activate();
+
+    /**
+     * @brief Hands the next slice of the missing numbers to a producer.
+     *
+     * Every producer calls it once after the switch.
+     *
+     * @return The numbers to push, in random order, or an empty vector once
+     *         every slice is taken.
+     */
+    [[nodiscard]] std::vector<uint64_t> takeSlice();
+
+   private:
+    const NumberStorage* m_storage;               ///< Pointer to the storage of the numbers.
+    size_t m_producersNr;                         ///< The number of slices.
+    unsigned m_missThreshold;                     ///< Misses per window from which to switch.
+    uint64_t m_seed;                              ///< Seed of the shuffle.
+    std::once_flag m_once;                        ///< Collects the missing numbers once.
+    std::vector<std::vector<uint64_t>> m_slices;  ///< The missing numbers, one per producer.
+    std::atomic<size_t> m_nextSlice{0};           ///< Next slice to hand out.
+    std::atomic_bool m_active{false};             ///< Set once the slices are ready.
+};
+
+}  // namespace core
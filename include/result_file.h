@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace core
+{
+
+/**
+ * @struct ResultFileHeader
+ * @brief The header at the start of a result file, in native byte order.
+ *
+ * The header is followed by three arrays, at the offsets it gives: the
+ * emitted sequence (int32 per position), the order of every number (uint32
+ * per number) and, if kHasTimes is set, the generation time of every
+ * number (int64 per number, in microseconds).
+ */
+struct ResultFileHeader
+{
+    /// Flag set when the file has the generation time array.
+    static constexpr uint32_t kHasTimes = 1;
+
+    char m_magic[8];            ///< "RNDSEQ\0\0".
+    uint32_t m_version;         ///< Version of the layout.
+    uint32_t m_flags;           ///< Combination of the flags above.
+    uint64_t m_elements;        ///< The number of elements N.
+    uint64_t m_emitted;         ///< Numbers emitted, set to N once the run is complete.
+    uint64_t m_sequenceOffset;  ///< Offset of the emitted sequence.
+    uint64_t m_ordersOffset;    ///< Offset of the order array.
+    uint64_t m_timesOffset;     ///< Offset of the generation time array, 0 if there is none.
+};
+
+/**
+ * @class MappedResultFile
+ * @brief A pre-sized binary result file, memory-mapped for writing or reading.
+ *
+ * A run writes every accepted number straight into the mapping: the number
+ * goes to its position in the emitted sequence, and its order and time go
+ * to the slots of the number. Each slot is written by the one thread that
+ * accepted the number, so writers need no synchronization, nothing is
+ * buffered in RAM and nothing is formatted. The page cache writes the
+ * pages back to disk. Readers map the same file and use the arrays in
+ * place.
+ */
+class MappedResultFile
+{
+   public:
+    /// Version of the layout written by this class.
+    static constexpr uint32_t kVersion = 1;
+
+    /**
+     * @brief Creates a result file for the numbers 1..elements and maps it for writing.
+     *
+     * An existing file is truncated. The arrays are zero-filled until written.
+     *
+     * @param path The path of the file.
+     * @param elements The number of elements.
+     * @param recordTimes Whether to keep the generation time array.
+     * @return The mapped file, or std::nullopt if it cannot be created or mapped.
+     */
+    [[nodiscard]] static std::optional<MappedResultFile> create(const std::string& path,
+                                                                size_t elements,
+                                                                bool recordTimes);
+
+    /**
+     * @brief Maps an existing result file for reading.
+     *
+     * @param path The path of the file.
+     * @return The mapped file, or std::nullopt if it cannot be mapped or its
+     *         header does not describe a file of its size.
+     */
+    [[nodiscard]] static std::optional<MappedResultFile> open(const std::string& path);
+
+    MappedResultFile(MappedResultFile&& other) noexcept;
+    MappedResultFile& operator=(MappedResultFile&& other) = delete;
+    MappedResultFile(const MappedResultFile&) = delete;
+    MappedResultFile& operator=(const MappedResultFile&) = delete;
+
+    /**
+     * @brief Unmaps and closes the file.
+     */
+    ~MappedResultFile();
+
+    /**
+     * @brief Writes an accepted number into the file.
+     *
+     * Only the thread that accepted the number may record it.
+     *
+     * @param number The number, in 1..elements().
+     * @param order The order in which the number was generated, in 1..elements().
+     * @param generationTime The time in microseconds taken to generate the number.
+     */
+    void record(uint64_t number, size_t order, long long generationTime) noexcept
+    {
+        const auto index = static_cast<size_t>(number - 1);
+        m_sequence[order - 1] = static_cast<int32_t>(number);
+        m_orders[index] = static_cast<uint32_t>(order);
+        if (m_times != nullptr)
+        {
+            m_times[index] = generationTime;
+        }
+    }
+
+    /**
+     * @brief Marks the run as complete by storing the number of emitted numbers.
+     *
+     * @param emitted The number of numbers emitted.
+     */
+    void finish(size_t emitted) noexcept;
+
+    /**
+     * @brief Checks that the file holds a complete permutation of 1..elements().
+     *
+     * Every number must appear exactly once in the sequence, and its order
+     * must match its position.
+     *
+     * @return A description of the first problem found, or std::nullopt if there is none.
+     */
+    [[nodiscard]] std::optional<std::string> verify() const;
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    [[nodiscard]] size_t elements() const noexcept { return m_header->m_elements; }
+
+    /**
+     * @brief Returns the number of emitted numbers, 0 until the run is finished.
+     */
+    [[nodiscard]] size_t emitted() const noexcept { return m_header->m_emitted; }
+
+    /**
+     * @brief Checks whether the file has the generation time array.
+     */
+    [[nodiscard]] bool recordsTimes() const noexcept { return m_times != nullptr; }
+
+    /**
+     * @brief Returns the emitted sequence, in the order of generation.
+     */
+    [[nodiscard]] std::span<const int32_t> sequence() const noexcept
+    {
+        return {m_sequence, elements()};
+    }
+
+    /**
+     * @brief Returns the order of every number, indexed by the number minus one.
+     */
+    [[nodiscard]] std::span<const uint32_t> orders() const noexcept
+    {
+        return {m_orders, elements()};
+    }
+
+    /**
+     * @brief Returns the generation time of every number, indexed by the number minus one.
+     *
+     * @return The times in microseconds, or an empty span if they are not recorded.
+     */
+    [[nodiscard]] std::span<const int64_t> times() const noexcept
+    {
+        return m_times != nullptr ? std::span<const int64_t>(m_times, elements())
+                                  : std::span<const int64_t>();
+    }
+
+    /**
+     * @brief Returns the sum of the generation times of all numbers.
+     *
+     * @return The total time in microseconds, or 0 if times are not recorded.
+     */
+    [[nodiscard]] long long totalGenerationTime() const noexcept;
+
+   private:
+    /**
+     * @brief Takes over a mapping and locates the arrays from its header.
+     *
+     * @param fd The file descriptor of the mapped file.
+     * @param data The start of the mapping.
+     * @param size The size of the mapping.
+     */
+    MappedResultFile(int fd, void* data, size_t size);
+
+    int m_fd;                    ///< The file descriptor, -1 once moved from.
+    void* m_data;                ///< The start of the mapping, nullptr once moved from.
+    size_t m_size;               ///< The size of the mapping.
+    ResultFileHeader* m_header;  ///< The header, at the start of the mapping.
+    int32_t* m_sequence;         ///< The emitted sequence.
+    uint32_t* m_orders;          ///< The order of every number.
+    int64_t* m_times;            ///< The generation time of every number, or nullptr.
+};
+
+}  // namespace core
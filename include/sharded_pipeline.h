@@ -0,0 +1,238 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cache_line.h"
+#include "completion_poll.h"
+#include "number_storage.h"
+#include "output_sink.h"
+#include "random_source.h"
+#include "spsc_queue.h"
+
+/**
+ * @class ShardedQueues
+ * @brief The shared state of the sharded pipeline: one SPSC queue per producer and consumer pair.
+ *
+ * Values are routed by value: the range 1..N is cut into groups of
+ * kGroupSize consecutive values (one cache line of the dedup bitset), and
+ * group g belongs to consumer g % C. Each consumer thus owns a disjoint,
+ * non-false-shared slice of the bitset, which it marks without any atomic
+ * read-modify-write. Producer p reaches consumer c
+ * through its own queue, so every queue has exactly one writer and one
+ * reader and nothing is shared between producers or between consumers.
+ */
+class ShardedQueues
+{
+   public:
+    /// Number of consecutive values routed to the same consumer.
+    static constexpr size_t kGroupSize =
+        core::NumberStorage::kNumbersPerWord * (core::kCacheLineSize / sizeof(uint64_t));
+
+    /**
+     * @brief Constructs the queues of the sharded pipeline.
+     *
+     * @param producers The number of producers.
+     * @param consumers The number of consumers.
+     * @param capacity The capacity of every queue.
+     */
+    ShardedQueues(size_t producers, size_t consumers, size_t capacity);
+
+    /**
+     * @brief Returns the queue from a producer to a consumer.
+     *
+     * @param producer The index of the producer.
+     * @param consumer The index of the consumer.
+     * @return Reference to the queue.
+     */
+    [[nodiscard]] core::SpscQueue<int>& queue(size_t producer, size_t consumer)
+    {
+        return *m_queues[producer * m_consumersNr + consumer];
+    }
+
+    /**
+     * @brief Returns the index of the consumer that owns a value.
+     *
+     * @param value The value, in 1..N.
+     * @return The index of the consumer.
+     */
+    [[nodiscard]] size_t shardOf(int value) const noexcept
+    {
+        return (static_cast<size_t>(value - 1) / kGroupSize) % m_consumersNr;
+    }
+
+    /**
+     * @brief Counts the values in 1..elements owned by a consumer.
+     *
+     * @param consumer The index of the consumer.
+     * @param elements The number of elements of the run.
+     * @return The number of values routed to the consumer.
+     */
+    [[nodiscard]] size_t shardSize(size_t consumer, size_t elements) const noexcept;
+
+    /**
+     * @brief Marks a consumer's shard as complete.
+     *
+     * @param consumer The index of the consumer.
+     * @return true if this was the last shard to complete.
+     */
+    bool markShardDone(size_t consumer);
+
+    /**
+     * @brief Checks whether a consumer already has all the values of its shard.
+     *
+     * @param consumer The index of the consumer.
+     * @return true if the shard is complete.
+     */
+    [[nodiscard]] bool isShardDone(size_t consumer) const
+    {
+        return m_shardDone[consumer].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Takes a block of consecutive order numbers.
+     *
+     * @param count The number of orders to take.
+     * @return The first order of the block.
+     */
+    size_t claimOrders(size_t count) { return m_order.fetch_add(count, std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of producers.
+     */
+    [[nodiscard]] size_t producersNr() const noexcept { return m_producersNr; }
+
+    /**
+     * @brief Returns the number of consumers.
+     */
+    [[nodiscard]] size_t consumersNr() const noexcept { return m_consumersNr; }
+
+   private:
+    size_t m_producersNr;                                               ///< Producer count.
+    size_t m_consumersNr;                                               ///< Consumer count.
+    std::vector<std::unique_ptr<core::SpscQueue<int>>> m_queues;        ///< Producer-major queues.
+    std::vector<std::atomic_bool> m_shardDone;                          ///< Completed shards.
+    alignas(core::kCacheLineSize) std::atomic<size_t> m_shardsDone{0};  ///< Completed count.
+    alignas(core::kCacheLineSize) std::atomic<size_t> m_order{1};       ///< Next order number.
+};
+
+/**
+ * @class ShardedProducer
+ * @brief A producer of the sharded pipeline.
+ *
+ * It generates random integers and pushes each of them into its own queue
+ * to the consumer that owns the value. Values owned by a consumer whose
+ * shard is already complete are dropped right away.
+ */
+class ShardedProducer
+{
+   public:
+    /**
+     * @brief Constructs a ShardedProducer.
+     *
+     * @param queues Reference to the queues of the sharded pipeline.
+     * @param index The index of this producer.
+     * @param random The source of random integers of this producer.
+     * @param completed Reference to an atomic boolean to signal
+     *                  completion of production.
+     */
+    ShardedProducer(ShardedQueues& queues,
+                    size_t index,
+                    core::RandomSource random,
+                    std::atomic_bool& completed)
+        : m_index(index), m_queues(&queues), m_completion(completed), m_random(random)
+    {
+    }
+
+    /**
+     * @brief Starts the production of random integers.
+     *
+     * It runs until the completion flag is set.
+     */
+    void produce();
+
+   private:
+    size_t m_index;                     ///< The index of this producer.
+    ShardedQueues* m_queues;            ///< Pointer to the queues of the pipeline.
+    core::CompletionPoll m_completion;  ///< Poll of the completion flag.
+    core::RandomSource m_random;        ///< Source of the random integers.
+};
+
+/**
+ * @class ShardedConsumer
+ * @brief A consumer of the sharded pipeline.
+ *
+ * It drains the queues of all producers to this consumer. Since only this
+ * consumer receives the values of its shard, no other thread touches the
+ * bitset lines it writes to, and it marks them with plain loads and
+ * stores. Orders are taken from the shared counter in blocks of
+ * kOrderBlock, never more than the numbers left in the shard, so the
+ * blocks of all consumers still add up to exactly 1..N. It finishes once
+ * its shard is complete, and the last consumer to finish sets the
+ * completion flag.
+ */
+class ShardedConsumer
+{
+   public:
+    /// Number of orders taken from the shared counter at once.
+    static constexpr size_t kOrderBlock = 64;
+
+    /**
+     * @brief Constructs a ShardedConsumer.
+     *
+     * @param queues Reference to the queues of the sharded pipeline.
+     * @param index The index of this consumer.
+     * @param storage Reference to the storage recording the consumed numbers.
+     * @param sink Reference to the sink writing out the consumed numbers.
+     * @param elements The number of elements of the run.
+     * @param completed Reference to an atomic boolean to signal
+     *                  completion of consumption.
+     * @param batchSize The maximal number of integers popped at once from a queue.
+     */
+    ShardedConsumer(ShardedQueues& queues,
+                    size_t index,
+                    core::NumberStorage& storage,
+                    core::OutputSink& sink,
+                    int elements,
+                    std::atomic_bool& completed,
+                    size_t batchSize)
+        : m_index(index)
+        , m_batchSize(batchSize)
+        , m_remaining(queues.shardSize(index, static_cast<size_t>(elements)))
+        , m_queues(&queues)
+        , m_storage(&storage)
+        , m_writer(sink)
+        , m_completed(&completed)
+        , m_completion(completed)
+    {
+    }
+
+    /**
+     * @brief Starts the consumption of integers from the queues.
+     *
+     * It runs until this consumer's shard is complete or the completion
+     * flag is set.
+     */
+    void consume();
+
+   private:
+    /**
+     * @brief Records a consumed integer unless it was already generated.
+     *
+     * @param randValue The consumed integer.
+     */
+    void accept(int randValue);
+
+    size_t m_index;                     ///< The index of this consumer.
+    size_t m_batchSize;                 ///< The maximal number of integers popped at once.
+    size_t m_remaining;                 ///< Values of the shard not generated yet.
+    long long m_lastTime = 0;           ///< Time of this consumer's last accepted number.
+    ShardedQueues* m_queues;            ///< Pointer to the queues of the pipeline.
+    core::NumberStorage* m_storage;     ///< Pointer to the storage of consumed numbers.
+    core::OutputSink::Writer m_writer;  ///< Buffer of the consumed numbers to write.
+    std::atomic_bool* m_completed;      ///< Pointer to the completion flag.
+    core::CompletionPoll m_completion;  ///< Poll of the completion flag.
+    size_t m_nextOrder = 0;             ///< Next order of the claimed block.
+    size_t m_ordersLeft = 0;            ///< Orders of the claimed block not used yet.
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+
+#include "output_sink.h"
+#include "random_source.h"
+#include "shared_segment.h"
+
+/**
+ * @file shared_pipeline.h
+ * @brief The workers of the multi-process mode, exchanging numbers through a core::SharedSegment.
+ *
+ * Each worker may run in a process of its own: all the state they share
+ * lives in the segment. Producers push their draws into the ring of the
+ * segment, and consumers pop them, reject duplicates on the shared bitset
+ * and take their orders from the shared counter. Every consumer process
+ * writes its numbers through its own OutputSink.
+ */
+
+/**
+ * @brief Restarts the shared clock and order counter of a segment.
+ *
+ * Called once, before the workers start.
+ *
+ * @param segment Reference to the shared segment.
+ */
+void initializeSharedStartTime(core::SharedSegment& segment);
+
+/**
+ * @brief Pushes random integers into the ring of a segment until every number is generated.
+ *
+ * @param segment Reference to the shared segment.
+ * @param random The source of random integers of this producer.
+ * @param batchSize The number of integers generated and pushed at once.
+ */
+void produceShared(core::SharedSegment& segment, core::RandomSource random, size_t batchSize);
+
+/**
+ * @brief Pops integers from the ring of a segment and writes out the new ones.
+ *
+ * The consumer accepting the last number sets the completion flag of the segment.
+ *
+ * @param segment Reference to the shared segment.
+ * @param sink Reference to the sink of this process.
+ * @param batchSize The maximal number of integers popped at once.
+ */
+void consumeShared(core::SharedSegment& segment, core::OutputSink& sink, size_t batchSize);
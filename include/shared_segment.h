@@ -0,0 +1,184 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "cache_line.h"
+
+namespace core
+{
+
+/**
+ * @struct SharedSegmentHeader
+ * @brief The header at the start of a shared segment.
+ *
+ * The header is followed by the ring cells and the dedup bitset, at
+ * offsets derived from the capacity and the number of elements. The
+ * counters of the producers, of the consumers and the completion flag
+ * each get a cache line of their own.
+ */
+struct SharedSegmentHeader
+{
+    char m_magic[8];      ///< "RNDSHM\0\0", written last by the creator.
+    uint32_t m_version;   ///< Version of the layout.
+    uint32_t m_reserved;  ///< Unused, zero.
+    uint64_t m_elements;  ///< The number of elements N.
+    uint64_t m_capacity;  ///< Number of ring cells, a power of two.
+    uint64_t m_size;      ///< Size of the whole segment in bytes.
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> m_enqueuePos;  ///< Next position to push.
+    alignas(kCacheLineSize) std::atomic<uint64_t> m_dequeuePos;  ///< Next position to pop.
+    alignas(kCacheLineSize) std::atomic<uint64_t> m_order;       ///< Last order given out.
+    std::atomic<int64_t> m_startTime;                            ///< Time of the last accept.
+    std::atomic<int64_t> m_totalTime;                            ///< Sum of the generation times.
+    alignas(kCacheLineSize) std::atomic_bool m_complete;         ///< Set once N numbers are in.
+};
+
+/**
+ * @class SharedSegment
+ * @brief A ring of numbers and a dedup bitset in POSIX shared memory.
+ *
+ * The transport of the multi-process mode. The creator sizes a shm_open
+ * segment and lays out a bounded MPMC ring (the sequence-numbered cells of
+ * LockFreeQueue), the atomic dedup bitset of NumberStorage and the shared
+ * counters of a run. Other processes map the segment by name, or inherit
+ * the mapping across fork(). Producers write their numbers straight into
+ * the ring cells and consumers read them from there: nothing is copied
+ * through a socket and nothing is serialized.
+ *
+ * Everything shared is a lock-free std::atomic, which is address-free and
+ * thus works across processes mapping the segment at different addresses.
+ * The segment holds offsets only, never pointers.
+ */
+class SharedSegment
+{
+   public:
+    /// Version of the layout written by this class.
+    static constexpr uint32_t kVersion = 1;
+
+    /**
+     * @brief Creates, sizes and maps a new segment for the numbers 1..elements.
+     *
+     * The segment is removed again when the returned object is destroyed.
+     *
+     * @param name The name of the segment, starting with '/'. It must not exist yet.
+     * @param elements The number of elements.
+     * @param capacity The minimal number of ring cells, rounded up to a power of two.
+     * @return The mapped segment, or std::nullopt if it cannot be created or mapped.
+     */
+    [[nodiscard]] static std::optional<SharedSegment> create(const std::string& name,
+                                                             size_t elements,
+                                                             size_t capacity);
+
+    /**
+     * @brief Maps an existing segment created by another process.
+     *
+     * @param name The name of the segment.
+     * @return The mapped segment, or std::nullopt if it cannot be mapped or its
+     *         header does not describe a segment of its size.
+     */
+    [[nodiscard]] static std::optional<SharedSegment> open(const std::string& name);
+
+    SharedSegment(SharedSegment&& other) noexcept;
+    SharedSegment& operator=(SharedSegment&& other) = delete;
+    SharedSegment(const SharedSegment&) = delete;
+    SharedSegment& operator=(const SharedSegment&) = delete;
+
+    /**
+     * @brief Unmaps the segment, and removes its name if this object created it.
+     */
+    ~SharedSegment();
+
+    /**
+     * @brief Attempts to push a batch of values to the ring.
+     *
+     * Safe to call from any thread of any process mapping the segment. Like
+     * LockFreeQueue::tryPushBulk, only a prefix of the batch may be added.
+     *
+     * @param vals The values to be added to the ring.
+     * @return The number of values added from the front of the batch (0 if the ring is full).
+     */
+    [[nodiscard]] size_t tryPushBulk(std::span<const int> vals) noexcept;
+
+    /**
+     * @brief Attempts to pop a batch of values from the ring.
+     *
+     * Safe to call from any thread of any process mapping the segment.
+     *
+     * @param[out] vals The buffer receiving the removed values, in FIFO order.
+     * @return The number of values written to the front of the buffer (0 if the ring was empty).
+     */
+    [[nodiscard]] size_t tryPopBulk(std::span<int> vals) noexcept;
+
+    /**
+     * @brief Marks a number as generated in the shared bitset.
+     *
+     * @param value The number, in 1..elements().
+     * @return true if the number was not generated before, false if it is a duplicate.
+     */
+    [[nodiscard]] bool tryMark(int value) noexcept
+    {
+        const auto index = static_cast<size_t>(value - 1);
+        const uint64_t bit = uint64_t{1} << (index % 64);
+        return (m_bits[index / 64].fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+    }
+
+    /**
+     * @brief Returns the shared header, holding the counters of the run.
+     */
+    [[nodiscard]] SharedSegmentHeader& header() noexcept { return *m_header; }
+
+    /**
+     * @brief Returns the flag set once every number is generated.
+     */
+    [[nodiscard]] const std::atomic_bool& completed() const noexcept
+    {
+        return m_header->m_complete;
+    }
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    [[nodiscard]] size_t elements() const noexcept { return m_header->m_elements; }
+
+    /**
+     * @brief Returns the number of ring cells.
+     */
+    [[nodiscard]] size_t capacity() const noexcept { return m_header->m_capacity; }
+
+   private:
+    /**
+     * @struct Cell
+     * @brief A ring slot holding a value and its sequence number.
+     */
+    struct Cell
+    {
+        std::atomic<uint64_t> m_sequence;  ///< Position this slot is ready for.
+        int m_value;                       ///< The stored value.
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                      std::atomic<int64_t>::is_always_lock_free &&
+                      std::atomic_bool::is_always_lock_free,
+                  "shared counters must be lock-free to work across processes");
+
+    /**
+     * @brief Takes over a mapping and locates the ring and the bitset from its header.
+     *
+     * @param name The name of the segment, empty if it is not owned.
+     * @param fd The file descriptor of the segment.
+     * @param data The start of the mapping.
+     */
+    SharedSegment(std::string name, int fd, void* data);
+
+    std::string m_name;             ///< Name removed on destruction, empty if not the creator.
+    int m_fd;                       ///< The file descriptor, -1 once moved from.
+    SharedSegmentHeader* m_header;  ///< The header, at the start of the mapping.
+    Cell* m_cells;                  ///< The ring cells.
+    std::atomic<uint64_t>* m_bits;  ///< The dedup bitset, one bit per number.
+};
+
+}  // namespace core
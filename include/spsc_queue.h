@@ -0,0 +1,151 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "cache_line.h"
+
+namespace core
+{
+
+/**
+ * @class SpscQueue
+ * @brief A bounded lock-free single-producer single-consumer queue.
+ *
+ * Exactly one thread may push and exactly one (other) thread may pop. The
+ * producer owns the tail index and the consumer owns the head index, each
+ * on its own cache line together with the owner's cached copy of the other
+ * index. A push or pop therefore only reads the other side's index when the
+ * cached copy says the queue looks full or empty.
+ *
+ * @tparam T The type of elements stored in the queue.
+ */
+template <typename T>
+class SpscQueue
+{
+   public:
+    using value_type = T;
+
+    /**
+     * @brief Constructor for a SpscQueue with a fixed size.
+     *
+     * @param size The minimal capacity of the queue. It is rounded up to the
+     *             next power of two (and to at least 2).
+     */
+    explicit SpscQueue(size_t size)
+        : m_mask(std::bit_ceil(std::max<size_t>(size, 2)) - 1), m_slots(m_mask + 1)
+    {
+    }
+
+    /**
+     * @brief Attempts to push a value to the queue. Producer thread only.
+     *
+     * @param val The value to be added to the queue.
+     * @return true if the value was successfully added, false if the queue is full.
+     */
+    [[nodiscard]] bool tryPush(const T& val)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask)
+            {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = val;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Attempts to pop a value from the queue. Consumer thread only.
+     *
+     * @param[out] val The value that was removed from the queue.
+     * @return true if a value was successfully removed, false if the queue was empty.
+     */
+    [[nodiscard]] bool tryPop(T& val)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+            {
+                return false;
+            }
+        }
+        val = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Attempts to push a batch of values to the queue. Producer thread only.
+     *
+     * @param vals The values to be added to the queue.
+     * @return The number of values added from the front of the batch (0 if the queue is full).
+     */
+    [[nodiscard]] size_t tryPushBulk(std::span<const T> vals)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t space = m_mask + 1 - (tail - m_cachedHead);
+        if (space < vals.size())
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            space = m_mask + 1 - (tail - m_cachedHead);
+        }
+        const size_t count = std::min(space, vals.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_slots[(tail + i) & m_mask] = vals[i];
+        }
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Attempts to pop a batch of values from the queue. Consumer thread only.
+     *
+     * @param[out] vals The buffer receiving the removed values, in FIFO order.
+     * @return The number of values written to the front of the buffer (0 if the queue was empty).
+     */
+    [[nodiscard]] size_t tryPopBulk(std::span<T> vals)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        size_t available = m_cachedTail - head;
+        if (available < vals.size())
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            available = m_cachedTail - head;
+        }
+        const size_t count = std::min(available, vals.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            vals[i] = m_slots[(head + i) & m_mask];
+        }
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Returns the real capacity of the queue.
+     *
+     * @return The number of slots, i.e. the requested size rounded up to a power of two.
+     */
+    [[nodiscard]] size_t capacity() const noexcept { return m_mask + 1; }
+
+   private:
+    const size_t m_mask;                                    ///< Capacity minus one.
+    std::vector<T> m_slots;                                 ///< The ring of slots, allocated once.
+    alignas(kCacheLineSize) std::atomic<size_t> m_tail{0};  ///< Next index to push.
+    size_t m_cachedHead = 0;                                ///< Producer's copy of m_head.
+    alignas(kCacheLineSize) std::atomic<size_t> m_head{0};  ///< Next index to pop.
+    size_t m_cachedTail = 0;                                ///< Consumer's copy of m_tail.
+};
+
+}  // namespace core
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace core
+{
+
+/**
+ * @brief Parses a CPU (or NUMA node) list such as "0,2,4-7".
+ *
+ * @param text The list of numbers and inclusive ranges, separated by commas.
+ * @return The listed numbers in the given order, or an empty vector if the list is invalid.
+ */
+[[nodiscard]] std::vector<int> parseCpuList(std::string_view text);
+
+/**
+ * @class ThreadPinning
+ * @brief Assigns worker threads to the CPUs they are pinned to.
+ *
+ * A pinning holds a list of CPU sets. Worker i is pinned to set
+ * i % size(), so workers are spread round robin over single cores or over
+ * whole NUMA nodes. Pinning uses pthread_setaffinity_np and is only
+ * available on Linux; elsewhere pinCurrentThread() fails.
+ */
+class ThreadPinning
+{
+   public:
+    /**
+     * @brief Constructs a pinning that leaves threads to the scheduler.
+     */
+    ThreadPinning() = default;
+
+    /**
+     * @brief Parses a pinning specification.
+     *
+     * Accepted specifications are:
+     * - "cores": one CPU per worker, round robin over the CPUs the process may run on;
+     * - "cores:LIST": one CPU per worker, round robin over the listed CPUs;
+     * - "numa": workers round robin over the NUMA nodes, each bound to all CPUs of its node;
+     * - "numa:LIST": the same over the listed NUMA nodes.
+     *
+     * @param spec The pinning specification.
+     * @return The pinning, or std::nullopt if the specification is invalid.
+     */
+    [[nodiscard]] static std::optional<ThreadPinning> parse(std::string_view spec);
+
+    /**
+     * @brief Checks whether threads are pinned at all.
+     *
+     * @return true if pinCurrentThread() pins threads, false if it does nothing.
+     */
+    [[nodiscard]] bool enabled() const noexcept { return !m_cpuSets.empty(); }
+
+    /**
+     * @brief Pins the calling thread to the CPU set of the given worker.
+     *
+     * @param workerIndex The index of the worker running on the calling thread.
+     * @return true if the thread was pinned or pinning is disabled, false on failure.
+     */
+    bool pinCurrentThread(size_t workerIndex) const;
+
+    /**
+     * @brief Describes the CPU set of the given worker.
+     *
+     * @param workerIndex The index of the worker.
+     * @return The CPU set as a list, e.g. "3" or "0,1,2,3", or "any" if pinning is disabled.
+     */
+    [[nodiscard]] std::string describe(size_t workerIndex) const;
+
+   private:
+    std::vector<std::vector<int>> m_cpuSets;  ///< CPU sets assigned round robin to workers.
+};
+
+}  // namespace core
@@ -0,0 +1,129 @@
+#pragma once
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+
+/**
+ * @class ThreadPool
+ * @brief A few threads resuming coroutines.
+ *
+ * Coroutines are handed to the pool as handles ready to run, and any
+ * thread of the pool resumes them in turn. A coroutine keeps its thread
+ * until it suspends again, typically on an AsyncQueue, which hands it
+ * back to the pool once it can go on. Threads with nothing to resume
+ * sleep on a condition variable; they never spin.
+ */
+class ThreadPool
+{
+   public:
+    /**
+     * @brief Starts the threads of the pool.
+     *
+     * @param threadsNr The number of threads, at least 1.
+     */
+    explicit ThreadPool(size_t threadsNr);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Resumes the coroutines already scheduled, then stops and joins the threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Schedules a suspended coroutine to be resumed by a thread of the pool.
+     *
+     * @param handle The coroutine.
+     */
+    void schedule(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Returns the number of threads.
+     */
+    [[nodiscard]] size_t threadsNr() const noexcept { return m_threads.size(); }
+
+   private:
+    /**
+     * @brief The loop of a thread of the pool.
+     */
+    void run();
+
+    std::mutex m_mutex;                           ///< Protects the members below.
+    std::condition_variable m_cv;                 ///< Signals ready coroutines and stopping.
+    std::deque<std::coroutine_handle<>> m_ready;  ///< Coroutines waiting to be resumed.
+    bool m_stopping = false;                      ///< Set by the destructor.
+    std::vector<std::thread> m_threads;           ///< The threads of the pool.
+};
+
+/**
+ * @class Task
+ * @brief A coroutine started on a ThreadPool and then left to run on its own.
+ *
+ * The coroutine is created suspended. start() hands it to a pool, and its
+ * frame is freed as soon as it returns, so whoever starts it must learn
+ * about its end by other means. A task that never started is destroyed
+ * with the Task object.
+ */
+class Task
+{
+   public:
+    /**
+     * @struct promise_type
+     * @brief The promise of the coroutine.
+     */
+    struct promise_type
+    {
+        Task get_return_object() noexcept
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        void return_void() noexcept {}
+
+        [[noreturn]] void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task& operator=(Task&& other) = delete;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /**
+     * @brief Destroys the coroutine if it was never started.
+     */
+    ~Task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    /**
+     * @brief Hands the coroutine to a pool. The Task no longer owns it.
+     *
+     * @param pool The pool running the coroutine.
+     */
+    void start(ThreadPool& pool) { pool.schedule(std::exchange(m_handle, {})); }
+
+   private:
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+    std::coroutine_handle<promise_type> m_handle;  ///< The coroutine, until it is started.
+};
+
+}  // namespace core
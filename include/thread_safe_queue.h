@@ -1,6 +1,13 @@
 #pragma once
+#include <algorithm>
+#include <memory_resource>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "cache_line.h"
+#include "capacity_tuner.h"
 
 namespace core
 {
@@ -9,10 +16,22 @@ namespace core
  * @class ThreadSafeQueue
  * @brief A thread-safe queue implementation with a fixed size.
  *
- * This class provides a thread-safe wrapper around a standard queue,
- * ensuring that push and pop operations are safe to call from multiple
- * threads. The queue has a maximum size, and pushing elements when full
- * will fail as well as popping elements when empty.
+ * This class provides a bounded FIFO ring of slots guarded by a mutex,
+ * so that push and pop operations are safe to call from multiple threads.
+ * The queue has a maximum size, and pushing elements when full will fail
+ * as well as popping elements when empty.
+ *
+ * The ring is a std::pmr::vector allocated once by the constructor, from
+ * the given memory resource, and indexed from the front slot modulo its
+ * size, so pushes and pops never allocate. A std::queue over a std::deque
+ * allocated and freed a chunk every few hundred elements as the queue
+ * filled and drained, taking the allocator's locks under the queue's
+ * mutex.
+ *
+ * A queue constructed from a CapacityTuning allocates its largest capacity
+ * but only lets that many elements in as its CapacityTuner allows, from
+ * the full and empty rates and the residency it observes. Every call then
+ * also updates the tuner's counters, under the lock the call holds anyway.
  *
  * @tparam T The type of elements stored in the queue.
  */
@@ -20,12 +39,34 @@ template <typename T>
 class ThreadSafeQueue
 {
    public:
+    using value_type = T;
+
     /**
      * @brief Constructor for a ThreadSafeQueue with a fixed size.
      *
      * @param size The maximum size of the queue.
+     * @param resource The memory resource the slots are allocated from.
+     */
+    explicit ThreadSafeQueue(size_t size,
+                             std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_slots(size, resource), m_size(size), m_limit(size)
+    {
+    }
+
+    /**
+     * @brief Constructor for a ThreadSafeQueue whose capacity is tuned while it runs.
+     *
+     * @param tuning The options of the tuner, bounding the capacity.
+     * @param resource The memory resource the slots are allocated from.
      */
-    explicit ThreadSafeQueue(size_t size) : m_size(size) {}
+    explicit ThreadSafeQueue(const CapacityTuning& tuning,
+                             std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_slots(std::max(tuning.m_minCapacity, tuning.m_maxCapacity), resource)
+        , m_size(m_slots.size())
+        , m_tuner(std::in_place, tuning)
+    {
+        m_limit = m_tuner->capacity();
+    }
 
     /**
      * @brief Attempts to push a value to the queue.
@@ -39,11 +80,14 @@ class ThreadSafeQueue
     [[nodiscard]] bool tryPush(const T& val)
     {
         std::scoped_lock lock(m_mtx);
-        if (m_queue.size() >= m_size)
+        if (m_count >= m_limit)
         {
+            notePush(true);
             return false;
         }
-        m_queue.push(val);
+        m_slots[slot(m_count)] = val;
+        ++m_count;
+        notePush(false);
         return true;
     }
 
@@ -59,19 +103,137 @@ class ThreadSafeQueue
     [[nodiscard]] bool tryPop(T& val)
     {
         std::scoped_lock lock(m_mtx);
-        if (m_queue.size() == 0)
+        if (m_count == 0)
         {
+            notePop(0);
             return false;
         }
-        val = m_queue.front();
-        m_queue.pop();
+        val = m_slots[m_head];
+        m_head = slot(1);
+        --m_count;
+        notePop(1);
         return true;
     }
 
+    /**
+     * @brief Attempts to push a batch of values to the queue.
+     *
+     * This method is thread-safe. The whole batch is pushed under a single
+     * lock acquisition. Values are pushed in order until the queue is full,
+     * so only a prefix of the batch may be added.
+     *
+     * @param vals The values to be added to the queue.
+     * @return The number of values added from the front of the batch (0 if the queue is full).
+     */
+    [[nodiscard]] size_t tryPushBulk(std::span<const T> vals)
+    {
+        std::scoped_lock lock(m_mtx);
+        // A capacity that shrank may be below the count
+        const size_t count = std::min(vals.size(), m_limit - std::min(m_count, m_limit));
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_slots[slot(m_count + i)] = vals[i];
+        }
+        m_count += count;
+        notePush(count < vals.size());
+        return count;
+    }
+
+    /**
+     * @brief Attempts to pop a batch of values from the queue.
+     *
+     * This method is thread-safe. The whole batch is popped under a single
+     * lock acquisition. It removes as many front values as are available,
+     * up to the size of the output buffer.
+     *
+     * @param[out] vals The buffer receiving the removed values, in FIFO order.
+     * @return The number of values written to the front of the buffer (0 if the queue was empty).
+     */
+    [[nodiscard]] size_t tryPopBulk(std::span<T> vals)
+    {
+        std::scoped_lock lock(m_mtx);
+        const size_t count = std::min(vals.size(), m_count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            vals[i] = m_slots[slot(i)];
+        }
+        m_head = slot(count);
+        m_count -= count;
+        notePop(count);
+        return count;
+    }
+
+    /**
+     * @brief Returns the number of elements the queue currently lets in.
+     */
+    [[nodiscard]] size_t capacity() const
+    {
+        std::scoped_lock lock(m_mtx);
+        return m_limit;
+    }
+
+    /**
+     * @brief Returns the capacity chosen by the tuner and its last measures.
+     *
+     * @return The summary, or std::nullopt if the capacity is fixed.
+     */
+    [[nodiscard]] std::optional<CapacityTuner::Summary> tuningSummary() const
+    {
+        std::scoped_lock lock(m_mtx);
+        if (!m_tuner)
+        {
+            return std::nullopt;
+        }
+        return m_tuner->summary();
+    }
+
    private:
-    size_t m_size;          ///< Maximum size of the queue.
-    std::queue<T> m_queue;  ///< The underlying standard queue.
-    std::mutex m_mtx;       ///< Mutex to ensure thread-safe access.
+    /**
+     * @brief Accounts for a push call in the tuner, if any. Called under the lock.
+     *
+     * @param full Whether the capacity cut the push short.
+     */
+    void notePush(bool full)
+    {
+        if (m_tuner)
+        {
+            m_limit = m_tuner->onPush(full, m_count).value_or(m_limit);
+        }
+    }
+
+    /**
+     * @brief Accounts for a pop call in the tuner, if any. Called under the lock.
+     *
+     * @param popped The number of elements popped.
+     */
+    void notePop(size_t popped)
+    {
+        if (m_tuner)
+        {
+            m_limit = m_tuner->onPop(popped, m_count).value_or(m_limit);
+        }
+    }
+
+    /**
+     * @brief Returns the slot at a distance from the front of the queue. Called under the lock.
+     *
+     * @param offset The distance from the front, at most the size of the queue.
+     */
+    [[nodiscard]] size_t slot(size_t offset) const noexcept
+    {
+        const size_t index = m_head + offset;
+        return index >= m_size ? index - m_size : index;
+    }
+
+    // The mutex and the state it guards are taken together, so they start a
+    // line of their own instead of sharing one with the queue's neighbours
+    alignas(kCacheLineSize) mutable std::mutex m_mtx;  ///< Mutex to ensure thread-safe access.
+    std::pmr::vector<T> m_slots;                       ///< The ring of slots, allocated once.
+    size_t m_size;                                     ///< Maximum size of the queue.
+    size_t m_limit;                                    ///< Elements let in, at most m_size.
+    std::optional<CapacityTuner> m_tuner;              ///< Tuner of m_limit, if it is not fixed.
+    size_t m_head = 0;                                 ///< Slot of the front element.
+    size_t m_count = 0;                                ///< Number of elements in the queue.
 };
 
 }  // namespace core
\ No newline at end of file
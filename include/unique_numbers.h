@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "generator.h"
+#include "random_source.h"
+
+namespace core
+{
+
+/**
+ * @struct UniqueNumbersOptions
+ * @brief Options of uniqueNumbers().
+ */
+struct UniqueNumbersOptions
+{
+    uint64_t m_elements = 0;                                 ///< The numbers are 1..m_elements.
+    size_t m_producersNr = 2;                                ///< Producer stages.
+    size_t m_consumersNr = 2;                                ///< Consumer stages.
+    size_t m_threadsNr = 2;                                  ///< Threads running the stages.
+    size_t m_queueCapacity = 1024;                           ///< Capacity of each queue.
+    RandomEngine m_randomEngine = RandomEngine::Xoshiro256;  ///< Engine of the producers.
+    uint64_t m_seed = 0;                                     ///< Seed of the random streams.
+};
+
+/**
+ * @brief Yields every number of 1..elements exactly once, in random order.
+ *
+ * Nothing runs until the first value is requested. The generator then
+ * starts a small ThreadPool running the stages as coroutines: producers
+ * draw numbers into an AsyncQueue, consumers reject the duplicates with a
+ * NumberStorage bitset and push the new numbers into a second queue, from
+ * which the generator yields them. Every stage suspends while its queue is
+ * full or empty, so when the caller stops pulling, the stages fill the
+ * queues and then hold no thread at all. Destroying the generator stops
+ * the stages and the pool.
+ *
+ * @param options The options of the sequence.
+ * @return The generator of the numbers.
+ */
+[[nodiscard]] Generator<uint64_t> uniqueNumbers(UniqueNumbersOptions options);
+
+}  // namespace core
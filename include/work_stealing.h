@@ -0,0 +1,134 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "cache_line.h"
+#include "chase_lev_deque.h"
+#include "number_storage.h"
+#include "output_sink.h"
+#include "random_source.h"
+
+/**
+ * @class WorkStealingScheduler
+ * @brief The work-stealing mode: chunks of the range generated locally by workers that steal.
+ *
+ * The range 1..N is cut into chunks of kChunkSize consecutive numbers, a
+ * whole number of words of the dedup bitset. A chunk is one task that
+ * fuses the producer and consumer stages: the worker running it draws
+ * numbers in the chunk's range from a random source of its own, rejects
+ * the duplicates on bitset words no other worker touches, and emits the
+ * new numbers until the chunk is complete. No number is ever drawn for a
+ * chunk that is already done, so there is no flood of late duplicates.
+ *
+ * Every worker starts with an equal share of the chunks in its own
+ * core::ChaseLevDeque and runs them from the bottom. A worker whose deque
+ * is empty steals from the top of the others', so the load stays balanced
+ * when the thread count does not divide N or when some cores are slower.
+ * Each chunk draws from its own seed, so the numbers of a chunk do not
+ * depend on which worker runs it.
+ */
+class WorkStealingScheduler
+{
+   public:
+    /// Number of consecutive numbers in one chunk.
+    static constexpr size_t kChunkSize = 64 * core::NumberStorage::kNumbersPerWord;
+
+    /**
+     * @brief Cuts the range into chunks and deals them to the workers.
+     *
+     * @param storage Reference to the storage recording the generated numbers.
+     * @param sink Reference to the sink writing out the generated numbers.
+     * @param elements The number of elements to generate.
+     * @param engine The random engine of the chunks.
+     * @param seed The seed of the run.
+     * @param workersNr The number of workers.
+     */
+    WorkStealingScheduler(core::NumberStorage& storage,
+                          core::OutputSink& sink,
+                          int elements,
+                          core::RandomEngine engine,
+                          uint64_t seed,
+                          size_t workersNr);
+
+    /**
+     * @brief Runs chunks until no worker has any left. Called by worker threads.
+     *
+     * @param worker The index of the calling worker.
+     */
+    void work(size_t worker);
+
+    /**
+     * @brief Returns the number of workers.
+     */
+    [[nodiscard]] size_t workersNr() const noexcept { return m_workers.size(); }
+
+    /**
+     * @brief Returns the number of chunks.
+     */
+    [[nodiscard]] size_t chunksNr() const noexcept { return m_chunksNr; }
+
+    /**
+     * @brief Returns the number of chunks a worker ran.
+     *
+     * @param worker The index of the worker.
+     */
+    [[nodiscard]] size_t chunksRun(size_t worker) const noexcept
+    {
+        return m_workers[worker]->m_chunksRun;
+    }
+
+    /**
+     * @brief Returns the number of chunks a worker stole from the others.
+     *
+     * @param worker The index of the worker.
+     */
+    [[nodiscard]] size_t chunksStolen(size_t worker) const noexcept
+    {
+        return m_workers[worker]->m_chunksStolen;
+    }
+
+   private:
+    /**
+     * @struct Worker
+     * @brief The deque and the output buffer of one worker.
+     */
+    struct alignas(core::kCacheLineSize) Worker
+    {
+        Worker(size_t capacity, core::OutputSink& sink) : m_deque(capacity), m_writer(sink) {}
+
+        core::ChaseLevDeque<uint64_t> m_deque;  ///< Chunks not started yet.
+        core::OutputSink::Writer m_writer;      ///< Buffer of the numbers to write.
+        size_t m_chunksRun = 0;                 ///< Chunks run by this worker.
+        size_t m_chunksStolen = 0;              ///< Chunks this worker stole.
+    };
+
+    /**
+     * @brief Steals a chunk from another worker.
+     *
+     * @param thief The index of the stealing worker.
+     * @return A chunk, or std::nullopt once every other deque is empty.
+     */
+    std::optional<uint64_t> steal(size_t thief);
+
+    /**
+     * @brief Generates every number of a chunk.
+     *
+     * @param worker The worker running the chunk.
+     * @param chunk The index of the chunk.
+     */
+    void runChunk(Worker& worker, uint64_t chunk);
+
+    core::NumberStorage* m_storage;                  ///< Pointer to the storage of numbers.
+    size_t m_elementsNr;                             ///< The number of elements to generate.
+    size_t m_chunksNr;                               ///< The number of chunks.
+    core::RandomEngine m_engine;                     ///< The random engine of the chunks.
+    uint64_t m_seed;                                 ///< The seed of the run.
+    std::vector<std::unique_ptr<Worker>> m_workers;  ///< The workers, apart in memory.
+
+    // Handed out by every worker, so kept off the lines of the fields read by all
+    alignas(core::kCacheLineSize) std::atomic<size_t> m_order{1};  ///< Next order to hand out.
+};
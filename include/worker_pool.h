@@ -0,0 +1,89 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+
+/**
+ * @class WorkerPool
+ * @brief Threads kept across runs, each running one worker of a run at a time.
+ *
+ * The workers of a run spin on each other through queues and flags, so
+ * they must all run at once: unlike ThreadPool, the pool never queues a
+ * worker behind another, but gives each worker started in a round a
+ * thread of its own. Worker i of every round runs on thread i, created the
+ * first time a round needs it and parked on a condition variable between
+ * rounds. Back-to-back runs thus pay for thread creation only once, and a
+ * worker pinned to a CPU finds its thread already there.
+ *
+ * start() and wait() are called by one controlling thread.
+ */
+class WorkerPool
+{
+   public:
+    WorkerPool() = default;
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Waits for the workers of the current round, then stops and joins the threads.
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief Starts a worker of the current round on a thread of its own.
+     *
+     * @param work The work of the worker. It runs on thread startedNr() of the pool.
+     */
+    void start(std::function<void()> work);
+
+    /**
+     * @brief Waits until every worker of the round has returned, and starts a new round.
+     */
+    void wait();
+
+    /**
+     * @brief Returns the number of workers started in the current round.
+     */
+    [[nodiscard]] size_t startedNr() const noexcept { return m_started; }
+
+    /**
+     * @brief Returns the number of threads created so far.
+     */
+    [[nodiscard]] size_t threadsNr() const noexcept { return m_slots.size(); }
+
+   private:
+    /**
+     * @struct Slot
+     * @brief A thread of the pool and the work handed to it.
+     */
+    struct Slot
+    {
+        std::function<void()> m_work;  ///< Work not picked up yet, empty if none.
+        std::condition_variable m_cv;  ///< Signals work and stopping.
+        std::thread m_thread;          ///< The thread.
+    };
+
+    /**
+     * @brief The loop of a thread of the pool.
+     *
+     * @param slot The slot of the thread.
+     */
+    void run(Slot& slot);
+
+    std::mutex m_mutex;                          ///< Protects the members below.
+    std::condition_variable m_doneCv;            ///< Signals the end of the last running worker.
+    std::vector<std::unique_ptr<Slot>> m_slots;  ///< The threads, in worker order.
+    size_t m_started = 0;                        ///< Workers started in the current round.
+    size_t m_running = 0;                        ///< Workers of the round that did not return.
+    bool m_stopping = false;                     ///< Set by the destructor.
+};
+
+}  // namespace core
@@ -0,0 +1,84 @@
+#include "capacity_tuner.h"
+
+#include <algorithm>
+
+namespace core
+{
+
+CapacityTuner::CapacityTuner(const CapacityTuning& tuning)
+    : m_tuning(tuning)
+    , m_capacity(0)
+    , m_floor(tuning.m_minCapacity)
+    , m_windowStart(std::chrono::steady_clock::now())
+{
+    // Growth stays within the same bounds as the initial capacity
+    m_tuning.m_maxCapacity = std::max(m_tuning.m_minCapacity, m_tuning.m_maxCapacity);
+    m_capacity =
+        std::clamp(m_tuning.m_initialCapacity, m_tuning.m_minCapacity, m_tuning.m_maxCapacity);
+    m_summary.m_capacity = m_capacity;
+    m_summary.m_initialCapacity = m_capacity;
+}
+
+std::optional<size_t> CapacityTuner::closeWindow()
+{
+    const auto now = std::chrono::steady_clock::now();
+    const double fullRate =
+        m_pushes == 0 ? 0.0 : static_cast<double>(m_fullPushes) / static_cast<double>(m_pushes);
+    const double emptyRate =
+        m_pops == 0 ? 0.0 : static_cast<double>(m_emptyPops) / static_cast<double>(m_pops);
+    // Little's law: residency = mean occupancy / throughput
+    std::optional<std::chrono::nanoseconds> residency;
+    if (m_popped != 0)
+    {
+        const double meanOccupancy =
+            static_cast<double>(m_occupancySum) / static_cast<double>(m_calls);
+        const auto elapsed = std::chrono::duration<double, std::nano>(now - m_windowStart);
+        residency = std::chrono::nanoseconds(static_cast<int64_t>(
+            meanOccupancy * elapsed.count() / static_cast<double>(m_popped)));
+    }
+
+    // The floor left by the last growth lasts until enough windows passed without another
+    if (++m_quietWindows > m_tuning.m_floorWindows)
+    {
+        m_floor = m_tuning.m_minCapacity;
+    }
+
+    size_t capacity = m_capacity;
+    if (fullRate > m_tuning.m_highWatermark && emptyRate > m_tuning.m_lowWatermark)
+    {
+        // Too small for the bursts of either side
+        capacity = std::min(m_capacity * 2, m_tuning.m_maxCapacity);
+        m_floor = capacity;
+        m_quietWindows = 0;
+    }
+    else if ((fullRate > m_tuning.m_highWatermark ||
+              (residency && *residency > m_tuning.m_maxResidency)) &&
+             emptyRate <= m_tuning.m_lowWatermark)
+    {
+        // The consumers set the pace: hold fewer elements, for less time
+        capacity = std::max(m_capacity / 2, m_floor);
+    }
+
+    m_summary.m_windows++;
+    m_summary.m_fullRate = fullRate;
+    m_summary.m_emptyRate = emptyRate;
+    m_summary.m_residency = residency.value_or(std::chrono::nanoseconds(0));
+    m_windowStart = now;
+    m_calls = 0;
+    m_pushes = 0;
+    m_fullPushes = 0;
+    m_pops = 0;
+    m_emptyPops = 0;
+    m_popped = 0;
+    m_occupancySum = 0;
+    if (capacity == m_capacity)
+    {
+        return std::nullopt;
+    }
+    m_capacity = capacity;
+    m_summary.m_capacity = capacity;
+    m_summary.m_resizes++;
+    return capacity;
+}
+
+}  // namespace core
@@ -1,55 +1,201 @@
 #include "consumer.h"
 
-#include <chrono>
-#include <format>
 #include <iostream>
+#include <span>
 
-void Consumer::setStartTime()
+#include "current_time.h"
+
+template <typename Queue>
+void Consumer<Queue>::setStartTime()
 {
-    m_startTime = getCurrentTimeInMicroseconds();
+    m_progress.m_startTime = getCurrentTimeInMicroseconds();
+    m_progress.m_order = 1;
 }
 
-long long Consumer::getCurrentTimeInMicroseconds()
+template <typename Queue>
+long long Consumer<Queue>::getCurrentTimeInMicroseconds()
 {
-    return std::chrono::duration_cast<std::chrono::microseconds>(
-               std::chrono::high_resolution_clock::now().time_since_epoch())
-        .count();
+    return core::getCurrentTimeInMicroseconds();
 }
 
-void Consumer::consume()
+template <typename Queue>
+void Consumer<Queue>::consume()
 {
-    int randValue{};
+    value_type randValue{};
 
-    while (!m_completed->load())
+    if constexpr (core::BlockingQueueType<Queue>)
     {
-        if (m_queue->tryPop(randValue))
+        // pop() parks the thread while the queue is empty and fails once the queue is closed.
+        while (!m_completion.done() && popWaiting(randValue))
         {
-            int index = randValue - 1;
-            size_t expected = 0;
-            // Check if the generated number is already present in the storage. Do it in a
-            // thread-safe manner using the atomic operation compare_exchange_strong.
-            if ((*m_storage)[index].m_order.compare_exchange_strong(expected, m_order))
+            acceptPopped(randValue);
+        }
+    }
+    else if (m_batchSize > 1)
+    {
+        consumeBatches();
+    }
+    else
+    {
+        while (!m_completion.done())
+        {
+            if (m_queue->tryPop(randValue))
+            {
+                acceptPopped(randValue);
+            }
+            else
             {
-                // Calculate time it took to generate the value
-                auto endTime = getCurrentTimeInMicroseconds();
-                auto timeTaken = endTime - m_startTime;
-
-                // Save the generated number
-                (*m_storage)[index].m_order = m_order++;
-                (*m_storage)[index].m_generationTime = timeTaken;
-
-                std::cout << std::format(
-                    "number = {:05}, order = {:05}, generation_time = {:010}\n", randValue,
-                    (*m_storage)[index].m_order.load(), timeTaken);
-
-                if (m_order == m_elementsNr + 1)
-                {
-                    // All the numbers are generated
-                    m_completed->store(true);
-                }
-                m_startTime = getCurrentTimeInMicroseconds();
+                onEmptyPop();
             }
         }
     }
+    m_writer.flush();
     std::cout << "Consumer finished task.\n";
-}
\ No newline at end of file
+}
+
+template <typename Queue>
+void Consumer<Queue>::consumeBatches()
+{
+    std::span<value_type> batch(m_batch);
+
+    while (!m_completion.doneNow())
+    {
+        const size_t popped = m_queue->tryPopBulk(batch);
+        if (popped == 0)
+        {
+            onEmptyPop();
+        }
+        else if (m_threadMetrics == nullptr)
+        {
+            acceptBatch(batch.first(popped));
+        }
+        else
+        {
+            for (size_t i = 0; i < popped; ++i)
+            {
+                acceptPopped(batch[i]);
+            }
+        }
+    }
+}
+
+template <typename Queue>
+bool Consumer<Queue>::popWaiting(value_type& randValue)
+    requires core::BlockingQueueType<Queue>
+{
+    if (m_threadMetrics == nullptr)
+    {
+        return m_queue->pop(randValue);
+    }
+    if (m_queue->tryPop(randValue))
+    {
+        return true;
+    }
+    onEmptyPop();
+    return m_queue->pop(randValue);
+}
+
+template <typename Queue>
+void Consumer<Queue>::acceptPopped(value_type randValue)
+{
+    if (m_threadMetrics == nullptr)
+    {
+        accept(randValue);
+        return;
+    }
+    m_metrics->onPopped(*m_threadMetrics, randValue);
+    if (--m_acceptCountdown != 0)
+    {
+        accept(randValue);
+        return;
+    }
+    // Sample the time from the pop to the end of the accept
+    m_acceptCountdown = core::Metrics::kAcceptSampleInterval;
+    const uint64_t popTime = core::Metrics::now();
+    accept(randValue);
+    m_threadMetrics->m_acceptLatency.record(core::Metrics::now() - popTime);
+}
+
+template <typename Queue>
+void Consumer<Queue>::accept(value_type randValue)
+{
+    // Check if the generated number is already present in the storage. Setting its bit
+    // with an atomic fetch_or tells whether another consumer got it first.
+    if (!m_storage->tryMark(randValue))
+    {
+        if (m_threadMetrics != nullptr)
+        {
+            m_threadMetrics->m_duplicates.add(1);
+        }
+        return;
+    }
+    if (m_threadMetrics != nullptr)
+    {
+        m_threadMetrics->m_accepted.add(1);
+    }
+
+    // Calculate time it took to generate the value. The start time is shared by all
+    // consumers, so it is swapped atomically for the time of this number.
+    const auto endTime = getCurrentTimeInMicroseconds();
+    const auto timeTaken = endTime - m_progress.m_startTime.exchange(endTime);
+
+    // Save the generated number. Orders must stay a dense 1..N: an order is the number's
+    // position in the output and order N completes the run. Consumers of a shared queue
+    // cannot know how many numbers they will still accept, so a block claimed ahead would
+    // leave holes; one increment per number is the price. Batches claim exact blocks.
+    const size_t order = m_progress.m_order++;
+    m_storage->record(randValue, order, timeTaken);
+
+    m_writer.write(randValue, order, timeTaken);
+
+    if (order == m_elementsNr)
+    {
+        complete();
+    }
+}
+
+template <typename Queue>
+void Consumer<Queue>::acceptBatch(std::span<value_type> values)
+{
+    // Keep the numbers that are new, at the front of the batch
+    const size_t fresh = m_storage->tryMarkBatch(values);
+    if (fresh == 0)
+    {
+        return;
+    }
+
+    // One exchange of the start time and one block of orders for the whole batch
+    const auto endTime = getCurrentTimeInMicroseconds();
+    long long timeTaken = endTime - m_progress.m_startTime.exchange(endTime);
+    const size_t firstOrder = m_progress.m_order.fetch_add(fresh);
+    for (size_t i = 0; i < fresh; ++i)
+    {
+        m_storage->record(values[i], firstOrder + i, timeTaken);
+        m_writer.write(values[i], firstOrder + i, timeTaken);
+        timeTaken = 0;
+    }
+
+    if (firstOrder + fresh - 1 == m_elementsNr)
+    {
+        complete();
+    }
+}
+
+template <typename Queue>
+void Consumer<Queue>::complete()
+{
+    // All the numbers are generated
+    m_completed->store(true);
+    if constexpr (core::BlockingQueueType<Queue>)
+    {
+        // Wake the threads parked on the queue so that they can finish
+        m_queue->close();
+    }
+}
+
+template class Consumer<core::ThreadSafeQueue<int>>;
+template class Consumer<core::LockFreeQueue<int>>;
+template class Consumer<core::BlockingQueue<int>>;
+template class Consumer<core::ThreadSafeQueue<uint64_t>>;
+template class Consumer<core::LockFreeQueue<uint64_t>>;
+template class Consumer<core::BlockingQueue<uint64_t>>;
\ No newline at end of file
@@ -1,48 +1,40 @@
 #include "cv_based_threading.h"
 
 #include <condition_variable>
-#include <format>
 #include <iostream>
 #include <mutex>
-#include <random>
+
+#include "cache_line.h"
+#include "current_time.h"
 
 namespace
 {
-std::default_random_engine
-    g_generator(  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-        std::random_device{}());
-std::uniform_int_distribution<int>
-    g_distribution;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-
-std::mutex g_producerMtx;      // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// The producers park here while the consumers update the counters below, so
+// the two groups are kept on separate cache lines
+alignas(core::kCacheLineSize) std::mutex
+    g_producerMtx;             // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 std::condition_variable g_cv;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
-std::atomic_int g_order = 1;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-long long g_startTime;        // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+alignas(core::kCacheLineSize) std::atomic_int
+    g_order = 1;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
-[[nodiscard]] long long getCurrentTimeInMicroseconds()
-{
-    return std::chrono::duration_cast<std::chrono::microseconds>(
-               std::chrono::high_resolution_clock::now().time_since_epoch())
-        .count();
-}
-}  // namespace
+// Time of the last accepted number, swapped atomically by the consumers
+std::atomic_llong g_startTime = 0;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
-void initializeDistribution(int to)
-{
-    g_distribution = std::uniform_int_distribution<int>(1, to);
-}
+}  // namespace
 
 void initializeStartTime()
 {
-    g_startTime = getCurrentTimeInMicroseconds();
+    g_startTime = core::getCurrentTimeInMicroseconds();
+    g_order = 1;
 }
 
-void produce(core::ThreadSafeQueue<int>& queue, int elements, std::atomic_bool& completed)
+template <typename Queue>
+void produce(Queue& queue, core::RandomSource random, std::atomic_bool& completed)
 {
     while (!completed.load())
     {
-        if (!queue.tryPush(g_distribution(g_generator)))
+        if (!queue.tryPush(random.next()))
         {
             // The producer thread will wait on the CV until one of the consumers signals that space
             // has been freed in the queue, allowing the producer to continue producing items
@@ -54,46 +46,64 @@ void produce(core::ThreadSafeQueue<int>& queue, int elements, std::atomic_bool&
     std::cout << "CV-based producer finished task.\n";
 }
 
-void consume(core::ThreadSafeQueue<int>& queue,
-             std::vector<NumberInfo>& storage,
+template <typename Queue>
+void consume(Queue& queue,
+             core::NumberStorage& storage,
+             core::OutputSink& sink,
              int elements,
              std::atomic_bool& completed)
 {
+    core::OutputSink::Writer writer(sink);
     int randValue{};
     while (!completed.load())
     {
         if (queue.tryPop(randValue))
         {
-            int index = randValue - 1;
-            size_t expected = 0;
-            // Check if the generated number is already present in the storage. Do it in a
-            // thread-safe manner using the atomic operation compare_exchange_strong.
-            if (storage[index].m_order.compare_exchange_strong(expected, g_order))
+            // Check if the generated number is already present in the storage. Setting its
+            // bit with an atomic fetch_or tells whether another consumer got it first.
+            if (storage.tryMark(randValue))
             {
-                // Calculate time it took to generate the value
-                auto endTime = getCurrentTimeInMicroseconds();
-                auto timeTaken = endTime - g_startTime;
+                // Calculate time it took to generate the value. The start time is shared by
+                // all consumers, so it is swapped atomically for the time of this number.
+                const auto endTime = core::getCurrentTimeInMicroseconds();
+                const auto timeTaken = endTime - g_startTime.exchange(endTime);
 
                 // Save the generated number
-                storage[index].m_order = g_order++;
-                storage[index].m_generationTime = timeTaken;
+                const int order = g_order++;
+                storage.record(randValue, static_cast<size_t>(order), timeTaken);
 
-                std::cout << std::format(
-                    "number = {:05}, order = {:05}, generation_time = {:010}\n", randValue,
-                    storage[index].m_order.load(), timeTaken);
+                writer.write(randValue, static_cast<size_t>(order), timeTaken);
 
-                if (g_order == elements + 1)
+                if (order == elements)
                 {
                     // All the numbers are generated
                     completed.store(true);
                     g_cv.notify_all();
                     break;
                 }
-
-                g_startTime = getCurrentTimeInMicroseconds();
             }
             g_cv.notify_one();
         }
     }
+    writer.flush();
     std::cout << "CV-based consumer finished task.\n";
-}
\ No newline at end of file
+}
+
+template void produce(core::ThreadSafeQueue<int>&, core::RandomSource, std::atomic_bool&);
+template void produce(core::LockFreeQueue<int>&, core::RandomSource, std::atomic_bool&);
+template void produce(core::BlockingQueue<int>&, core::RandomSource, std::atomic_bool&);
+template void consume(core::ThreadSafeQueue<int>&,
+                      core::NumberStorage&,
+                      core::OutputSink&,
+                      int,
+                      std::atomic_bool&);
+template void consume(core::LockFreeQueue<int>&,
+                      core::NumberStorage&,
+                      core::OutputSink&,
+                      int,
+                      std::atomic_bool&);
+template void consume(core::BlockingQueue<int>&,
+                      core::NumberStorage&,
+                      core::OutputSink&,
+                      int,
+                      std::atomic_bool&);
\ No newline at end of file
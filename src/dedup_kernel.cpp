@@ -0,0 +1,276 @@
+#include "dedup_kernel.h"
+
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace core
+{
+
+namespace
+{
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+              "the vector kernels gather the bitset words as plain 64-bit integers");
+
+/**
+ * @brief Returns the bit of a number in its bitset word.
+ */
+template <NumberType T>
+[[nodiscard]] uint64_t bitOf(T value) noexcept
+{
+    return uint64_t{1} << ((static_cast<uint64_t>(value) - 1) % 64);
+}
+
+/**
+ * @brief Returns the index of the bitset word of a number.
+ */
+template <NumberType T>
+[[nodiscard]] uint64_t wordOf(T value) noexcept
+{
+    return (static_cast<uint64_t>(value) - 1) / 64;
+}
+
+/**
+ * @brief The scalar kernel, and the reference of the others: one fetch_or per number.
+ */
+template <NumberType T>
+size_t markNewScalar(std::atomic<uint64_t>* bits, std::span<T> values) noexcept
+{
+    size_t fresh = 0;
+    for (const T value : values)
+    {
+        const uint64_t bit = bitOf(value);
+        if ((bits[wordOf(value)].fetch_or(bit, std::memory_order_relaxed) & bit) == 0)
+        {
+            values[fresh++] = value;
+        }
+    }
+    return fresh;
+}
+
+/**
+ * @brief Commits the candidates left by a vector filter, one fetch_or per run sharing a word.
+ *
+ * @param bits The bitset.
+ * @param values The batch, whose first count numbers are the candidates in batch order.
+ * @param count The number of candidates.
+ * @return The number of new numbers, moved to the front of the batch.
+ */
+template <NumberType T>
+size_t commitCandidates(std::atomic<uint64_t>* bits, std::span<T> values, size_t count) noexcept
+{
+    size_t fresh = 0;
+    size_t i = 0;
+    while (i < count)
+    {
+        const uint64_t word = wordOf(values[i]);
+        uint64_t mask = 0;
+        size_t end = i;
+        while (end < count && wordOf(values[end]) == word)
+        {
+            mask |= bitOf(values[end]);
+            ++end;
+        }
+        // The bits set before, by this batch as well as by other threads
+        uint64_t seen = bits[word].fetch_or(mask, std::memory_order_relaxed);
+        for (; i < end; ++i)
+        {
+            const uint64_t bit = bitOf(values[i]);
+            if ((seen & bit) == 0)
+            {
+                seen |= bit;
+                values[fresh++] = values[i];
+            }
+        }
+    }
+    return fresh;
+}
+
+/**
+ * @brief Keeps the numbers of a scalar tail whose bit is clear in the bitset.
+ *
+ * @param bits The bitset.
+ * @param values The batch.
+ * @param first The first number of the tail.
+ * @param count The number of candidates found so far, at the front of the batch.
+ * @return The number of candidates, tail included.
+ */
+template <NumberType T>
+size_t filterTail(const std::atomic<uint64_t>* bits,
+                  std::span<T> values,
+                  size_t first,
+                  size_t count) noexcept
+{
+    for (size_t i = first; i < values.size(); ++i)
+    {
+        if ((bits[wordOf(values[i])].load(std::memory_order_relaxed) & bitOf(values[i])) == 0)
+        {
+            values[count++] = values[i];
+        }
+    }
+    return count;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * @brief The AVX2 kernel: filters 4 numbers per gather, then commits the candidates.
+ */
+template <NumberType T>
+__attribute__((target("avx2"))) size_t markNewAvx2(std::atomic<uint64_t>* bits,
+                                                   std::span<T> values) noexcept
+{
+    constexpr size_t kLanes = 4;
+    const auto* words = reinterpret_cast<const long long*>(bits);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i low = _mm256_set1_epi64x(63);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + kLanes <= values.size(); i += kLanes)
+    {
+        __m256i numbers;
+        if constexpr (std::same_as<T, int>)
+        {
+            numbers = _mm256_cvtepu32_epi64(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(&values[i])));
+        }
+        else
+        {
+            numbers = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&values[i]));
+        }
+        const __m256i index = _mm256_sub_epi64(numbers, one);
+        const __m256i bit = _mm256_sllv_epi64(one, _mm256_and_si256(index, low));
+        const __m256i word = _mm256_i64gather_epi64(words, _mm256_srli_epi64(index, 6), 8);
+        // All ones in the lanes whose bit is still clear
+        const __m256i clear = _mm256_cmpeq_epi64(_mm256_and_si256(word, bit), zero);
+        auto candidates = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(clear)));
+        while (candidates != 0)
+        {
+            values[count++] = values[i + static_cast<size_t>(std::countr_zero(candidates))];
+            candidates &= candidates - 1;
+        }
+    }
+    count = filterTail(bits, values, i, count);
+    return commitCandidates(bits, values, count);
+}
+
+// Before GCC 13, the unmasked AVX-512 intrinsics of the compiler's own headers fill
+// their pass-through operand with a self-initialized vector, which -Wmaybe-uninitialized
+// reports at every call site
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 13
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+/**
+ * @brief The AVX-512 kernel: filters 8 numbers per gather, then commits the candidates.
+ */
+template <NumberType T>
+__attribute__((target("avx512f"))) size_t markNewAvx512(std::atomic<uint64_t>* bits,
+                                                        std::span<T> values) noexcept
+{
+    constexpr size_t kLanes = 8;
+    const auto* words = reinterpret_cast<const long long*>(bits);
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i low = _mm512_set1_epi64(63);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + kLanes <= values.size(); i += kLanes)
+    {
+        __m512i raw;
+        __m512i numbers;
+        if constexpr (std::same_as<T, int>)
+        {
+            const __m256i loaded = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&values[i]));
+            raw = _mm512_zextsi256_si512(loaded);
+            numbers = _mm512_cvtepu32_epi64(loaded);
+        }
+        else
+        {
+            raw = _mm512_loadu_si512(&values[i]);
+            numbers = raw;
+        }
+        const __m512i index = _mm512_sub_epi64(numbers, one);
+        const __m512i bit = _mm512_sllv_epi64(one, _mm512_and_si512(index, low));
+        const __m512i word = _mm512_i64gather_epi64(_mm512_srli_epi64(index, 6), words, 8);
+        const __mmask8 clear = _mm512_testn_epi64_mask(word, bit);
+        // The candidates land at or before the numbers just loaded
+        if constexpr (std::same_as<T, int>)
+        {
+            _mm512_mask_compressstoreu_epi32(&values[count], clear, raw);
+        }
+        else
+        {
+            _mm512_mask_compressstoreu_epi64(&values[count], clear, raw);
+        }
+        count += static_cast<size_t>(std::popcount(static_cast<unsigned>(clear)));
+    }
+    count = filterTail(bits, values, i, count);
+    return commitCandidates(bits, values, count);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 13
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+}  // namespace
+
+bool dedupKernelSupported(DedupKernel kernel) noexcept
+{
+    switch (kernel)
+    {
+        case DedupKernel::Scalar:
+            return true;
+#if defined(__x86_64__) || defined(__i386__)
+        case DedupKernel::Avx2:
+            return __builtin_cpu_supports("avx2") != 0;
+        case DedupKernel::Avx512:
+            return __builtin_cpu_supports("avx512f") != 0;
+#else
+        case DedupKernel::Avx2:
+        case DedupKernel::Avx512:
+            return false;
+#endif
+    }
+    return false;
+}
+
+DedupKernel bestDedupKernel() noexcept
+{
+    if (dedupKernelSupported(DedupKernel::Avx512))
+    {
+        return DedupKernel::Avx512;
+    }
+    if (dedupKernelSupported(DedupKernel::Avx2))
+    {
+        return DedupKernel::Avx2;
+    }
+    return DedupKernel::Scalar;
+}
+
+template <NumberType T>
+size_t markNew(DedupKernel kernel, std::atomic<uint64_t>* bits, std::span<T> values) noexcept
+{
+    switch (kernel)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        case DedupKernel::Avx2:
+            return markNewAvx2(bits, values);
+        case DedupKernel::Avx512:
+            return markNewAvx512(bits, values);
+#endif
+        default:
+            return markNewScalar(bits, values);
+    }
+}
+
+template size_t markNew(DedupKernel, std::atomic<uint64_t>*, std::span<int>) noexcept;
+template size_t markNew(DedupKernel, std::atomic<uint64_t>*, std::span<uint64_t>) noexcept;
+
+}  // namespace core
@@ -0,0 +1,105 @@
+#include "deterministic_pipeline.h"
+
+#include <array>
+#include <iostream>
+#include <span>
+#include <thread>
+
+#include "current_time.h"
+
+namespace
+{
+
+/// Number of blocks a producer may run ahead of the merger.
+constexpr size_t kRingBlocks = 16;
+
+}  // namespace
+
+DeterministicPipeline::DeterministicPipeline(core::NumberStorage& storage,
+                                             core::OutputSink& sink,
+                                             int elements,
+                                             core::RandomEngine engine,
+                                             uint64_t seed,
+                                             size_t producersNr)
+    : m_storage(&storage), m_sink(&sink), m_elementsNr(elements), m_engine(engine), m_seed(seed)
+{
+    m_rings.reserve(producersNr);
+    for (size_t i = 0; i < producersNr; ++i)
+    {
+        m_rings.push_back(std::make_unique<core::SpscQueue<int>>(kRingBlocks * kBlockSize));
+    }
+}
+
+void DeterministicPipeline::produce(size_t producer)
+{
+    core::RandomSource random(m_engine, static_cast<uint64_t>(m_elementsNr), m_seed, producer);
+    core::SpscQueue<int>& ring = *m_rings[producer];
+    std::array<int, kBlockSize> block{};
+    while (!m_done.load(std::memory_order_relaxed))
+    {
+        random.fill(std::span<int>(block));
+        std::span<const int> pending(block);
+        while (!pending.empty() && !m_done.load(std::memory_order_relaxed))
+        {
+            const size_t pushed = ring.tryPushBulk(pending);
+            pending = pending.subspan(pushed);
+            if (pushed == 0)
+            {
+                // The merger is busy with the other rings, let it run.
+                std::this_thread::yield();
+            }
+        }
+    }
+    std::cout << "Deterministic producer finished task.\n";
+}
+
+void DeterministicPipeline::merge()
+{
+    core::OutputSink::Writer writer(*m_sink);
+    std::array<int, kBlockSize> block{};
+    size_t order = 0;
+    uint64_t draws = 0;
+    long long lastTime = core::getCurrentTimeInMicroseconds();
+
+    for (size_t producer = 0; order < static_cast<size_t>(m_elementsNr);
+         producer = (producer + 1) % m_rings.size())
+    {
+        // Take a whole block of this producer, whatever the other rings hold
+        core::SpscQueue<int>& ring = *m_rings[producer];
+        std::span<int> missing(block);
+        while (!missing.empty())
+        {
+            const size_t popped = ring.tryPopBulk(missing);
+            missing = missing.subspan(popped);
+            if (popped == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        for (size_t i = 0; i < kBlockSize && order < static_cast<size_t>(m_elementsNr); ++i)
+        {
+            // The only thread marking numbers, so the first occurrence always wins
+            const int randValue = block[i];
+            ++draws;
+            if (!m_storage->tryMarkOwned(randValue))
+            {
+                continue;
+            }
+
+            // Calculate time it took to generate the value
+            const auto endTime = core::getCurrentTimeInMicroseconds();
+            const auto timeTaken = endTime - lastTime;
+
+            ++order;
+            m_storage->record(randValue, order, timeTaken);
+            writer.write(randValue, order, timeTaken);
+            lastTime = core::getCurrentTimeInMicroseconds();
+        }
+    }
+
+    writer.flush();
+    m_draws = draws;
+    m_done.store(true);
+    std::cout << "Deterministic merger finished task.\n";
+}
@@ -1,98 +1,1439 @@
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <concepts>
+#include <format>
+#include <fstream>
 #include <iostream>
-#include <numeric>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 
+#include "blocking_queue.h"
+#include "cache_line.h"
+#include "capacity_tuner.h"
 #include "consumer.h"
 #include "cv_based_threading.h"
+#include "deterministic_pipeline.h"
+#include "lock_free_queue.h"
+#include "metrics.h"
+#include "number_storage.h"
+#include "output_sink.h"
+#include "page_memory.h"
+#include "permutation_worker.h"
 #include "producer.h"
+#include "random_source.h"
+#include "remaining_sampler.h"
+#include "result_file.h"
+#include "sharded_pipeline.h"
+#include "shared_pipeline.h"
+#include "thread_pinning.h"
+#include "thread_safe_queue.h"
+#include "unique_numbers.h"
+#include "work_stealing.h"
+#include "worker_pool.h"
+
+namespace
+{
+
+/**
+ * @brief Returns the value of a "--name=value" command-line option.
+ *
+ * @param arg The command-line argument.
+ * @return The text after the first '=', or an empty string if there is none.
+ */
+[[nodiscard]] std::string_view optionValue(std::string_view arg)
+{
+    const size_t equals = arg.find('=');
+    return equals == std::string_view::npos ? std::string_view() : arg.substr(equals + 1);
+}
+
+/**
+ * @brief Parses a positive count given as the value of a command-line option.
+ *
+ * @param text The option value.
+ * @return The parsed count, or 0 if the value is not a positive integer.
+ */
+[[nodiscard]] size_t parseCount(std::string_view text)
+{
+    size_t value = 0;
+    const char* last = std::next(text.data(), static_cast<std::ptrdiff_t>(text.size()));
+    const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+    if (ec != std::errc() || ptr != last)
+    {
+        return 0;
+    }
+    return value;
+}
+
+/**
+ * @brief Parses a seed given as the value of a command-line option.
+ *
+ * @param text The option value.
+ * @return The parsed seed, or std::nullopt if the value is not a 64-bit unsigned integer.
+ */
+[[nodiscard]] std::optional<uint64_t> parseSeed(std::string_view text)
+{
+    uint64_t value = 0;
+    const char* last = std::next(text.data(), static_cast<std::ptrdiff_t>(text.size()));
+    const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+    if (text.empty() || ec != std::errc() || ptr != last)
+    {
+        return std::nullopt;
+    }
+    return value;
+}
 
-enum
+/**
+ * @brief Parses a rate in (0, 1] given as the value of a command-line option.
+ *
+ * @param text The option value.
+ * @return The parsed rate, or 0 if the value is not a number in (0, 1].
+ */
+[[nodiscard]] double parseRate(std::string_view text)
 {
-    QUEUE_SIZE_MAX = 1000
+    double value = 0.0;
+    const char* last = std::next(text.data(), static_cast<std::ptrdiff_t>(text.size()));
+    const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+    if (ec != std::errc() || ptr != last || !(value > 0.0 && value <= 1.0))
+    {
+        return 0.0;
+    }
+    return value;
+}
+
+/// Text printed by --help.
+constexpr std::string_view kUsage =
+    "Usage: multithreaded_generator [N] [OPTION]...\n"
+    "Generates the numbers 1..N in random order with producer and consumer threads.\n"
+    "Without N, it is read from stdin.\n"
+    "\n"
+    "  --elements=N            number of elements, like the positional N\n"
+    "  --mode=MODE             queue (default), lock-free, blocking, cv, sharded, permutation,\n"
+    "                          stream, work-stealing, deterministic, shm or coroutines;\n"
+    "                          --MODE selects a mode as well\n"
+    "  --producers=P           producer threads (default 2)\n"
+    "  --consumers=C           consumer threads (default 2)\n"
+    "  --queue-capacity=K|auto capacity of the queues (default 1000), or tuned while running\n"
+    "  --queue-watermarks=L,H  full and empty rates steering the tuned capacity (0.01,0.1)\n"
+    "  --queue-residency=US    mean time in the queue above which it shrinks (default 1000)\n"
+    "  --batch=K               numbers moved per queue operation (default 1)\n"
+    "  --pin=SPEC              cores[:LIST] or numa[:LIST]\n"
+    "  --rng=ENGINE            std, xoshiro, pcg, simd or philox\n"
+    "  --seed=S                seed of the random streams\n"
+    "  --format=FORMAT         text, csv, binary, mapped or quiet\n"
+    "  --output=PATH           file receiving the numbers instead of stdout\n"
+    "  --no-times              do not keep the generation times\n"
+    "  --huge-pages            advise the storage to use transparent huge pages\n"
+    "                          (Linux only, no effect elsewhere)\n"
+    "  --prefilter             producers drop the draws already generated\n"
+    "  --adaptive[=RATE]       producers switch to the missing numbers at a miss rate\n"
+    "  --metrics               print per-stage latencies and counters\n"
+    "  --metrics-file=PATH     also sample the metrics to a CSV file\n"
+    "  --metrics-interval=MS   time between two samples (default 100)\n"
+    "  --jobs=PATH             run the runs listed in PATH (- for stdin), one per line,\n"
+    "                          back to back on the same worker threads\n"
+    "  --help                  print this text\n";
+
+/**
+ * @struct Options
+ * @brief Options of a generation run, collected from the command line.
+ */
+struct Options
+{
+    uint64_t elementsNr = 0;            ///< Number of elements to generate, 0 to ask on stdin.
+    std::string jobsPath;               ///< File of run specs to run back to back, "-" for stdin.
+    bool cvMode = false;                ///< Use the condition variable based approach.
+    bool lockFreeMode = false;          ///< Use the lock-free queue.
+    bool blockingMode = false;          ///< Use the blocking queue.
+    bool shardedMode = false;           ///< Use per-consumer SPSC queues with value routing.
+    bool permutationMode = false;       ///< Emit a random permutation instead of drawing numbers.
+    bool streamMode = false;            ///< Emit the permutation without any per-number state.
+    bool workStealingMode = false;      ///< Generate chunks of the range on work-stealing workers.
+    bool coroutinesMode = false;        ///< Pull the numbers from the coroutine pipeline.
+    bool deterministicMode = false;     ///< Merge the draws in a fixed order, reproducible by seed.
+    bool sharedMemoryMode = false;      ///< Run the workers in processes sharing a memory segment.
+    bool recordTimes = true;            ///< Keep the generation time of every number.
+    bool hugePages = false;             ///< Advise the storage to use transparent huge pages.
+    double adaptiveMissRate = 0.0;      ///< Miss rate from which producers draw missing numbers.
+    bool prefilter = false;             ///< Producers drop draws already generated.
+    core::RandomEngine randomEngine{};  ///< Random engine of the producers.
+    core::OutputFormat outputFormat{};  ///< Format of the generated numbers.
+    std::string outputPath;             ///< File receiving the generated numbers, stdout if empty.
+    bool metrics = false;               ///< Collect per-stage latency histograms and counters.
+    std::string metricsPath;            ///< CSV file receiving periodic metrics samples, if any.
+    size_t metricsInterval = 100;       ///< Time in milliseconds between two metrics samples.
+    uint64_t seed = 0;                  ///< Seed of the random streams of the producers.
+    bool fixedSeed = false;             ///< The seed was given with --seed.
+    size_t batchSize = 1;               ///< Integers moved with one queue operation.
+    size_t producersNr = 2;             ///< Number of producer threads.
+    size_t consumersNr = 2;             ///< Number of consumer threads.
+    size_t queueCapacity = 1000;        ///< Capacity of the queues between the two stages.
+    bool tunedCapacity = false;         ///< Tune the capacity of the queue while the run goes.
+    core::CapacityTuning tuning;        ///< Bounds and watermarks of the tuned capacity.
+    core::ThreadPinning pinning;        ///< CPUs the producer and consumer threads are pinned to.
 };
 
-int main(int argc, char* argv[])
+/**
+ * @brief Starts a worker on a thread of the pool, pinned according to its index.
+ *
+ * @param workers The pool running the workers; the worker index is its start order in the round.
+ * @param pinning The pinning of the workers.
+ * @param work The work to run on the thread.
+ */
+template <typename Work>
+void startWorker(core::WorkerPool& workers, const core::ThreadPinning& pinning, Work work)
 {
-    bool cvMode = false;
+    const size_t workerIndex = workers.startedNr();
+    workers.start(
+        [&pinning, workerIndex, work]()
+        {
+            if (!pinning.pinCurrentThread(workerIndex))
+            {
+                std::cout << std::format("Failed to pin worker {} to CPUs {}.\n", workerIndex,
+                                         pinning.describe(workerIndex));
+            }
+            work();
+        });
+}
 
-    // Check command-line arguments
-    std::vector<std::string> arguments(argv + 1, argv + argc);
+/**
+ * @brief Faults the pages of the storage in from the pinned worker CPUs, in parallel.
+ *
+ * Worker i of the P + C workers writes part i of every column, so that
+ * its pages come from the NUMA node the worker runs on. The work-stealing
+ * workers start with the same contiguous parts of the range.
+ *
+ * @param workers The pool running the worker threads.
+ * @param storage Reference to the storage, not in use yet.
+ * @param options The options of the run.
+ */
+void touchStorage(core::WorkerPool& workers, core::NumberStorage& storage, const Options& options)
+{
+    const size_t workersNr = options.producersNr + options.consumersNr;
+    for (size_t i = 0; i < workersNr; ++i)
+    {
+        startWorker(workers, options.pinning,
+                    [&storage, i, workersNr]() { storage.firstTouch(i, workersNr); });
+    }
+    workers.wait();
+}
+
+/**
+ * @brief Runs the producers and consumers over the given queue.
+ *
+ * Producers get the worker indices 0..P-1 and consumers P..P+C-1, which
+ * decide the CPUs they are pinned to.
+ *
+ * @tparam Queue The queue type shared by the producers and consumers.
+ * @param workers The pool running the worker threads.
+ * @param queue Reference to the shared queue.
+ * @param storage Reference to the storage for the generated numbers.
+ * @param sink Reference to the sink writing out the generated numbers.
+ * @param metrics Pointer to the metrics of the run, or nullptr to record none.
+ * @param elementsNr The number of elements to generate.
+ * @param complete Reference to the completion flag.
+ * @param options The options of the run.
+ * @return The number of values the producers drew, or 0 if they are not counted.
+ */
+template <typename Queue>
+uint64_t run(core::WorkerPool& workers,
+             Queue& queue,
+             core::NumberStorage& storage,
+             core::OutputSink& sink,
+             core::Metrics* metrics,
+             uint64_t elementsNr,
+             std::atomic_bool& complete,
+             const Options& options)
+{
+    uint64_t draws = 0;
+
+    if (!options.cvMode)
+    {
+        // Switches the producers to the missing numbers once uniform draws mostly miss
+        std::optional<core::RemainingSampler> remaining;
+        if (options.adaptiveMissRate > 0.0)
+        {
+            remaining.emplace(storage, options.producersNr, options.adaptiveMissRate,
+                              options.seed);
+        }
+
+        Consumer<Queue>::setStartTime();
+        std::vector<Producer<Queue>> producers;
+        std::vector<Consumer<Queue>> consumers;
+        producers.reserve(options.producersNr);
+        consumers.reserve(options.consumersNr);
+        for (size_t i = 0; i < options.producersNr; ++i)
+        {
+            producers.emplace_back(
+                queue, core::RandomSource(options.randomEngine, elementsNr, options.seed, i),
+                complete, options.batchSize, metrics, remaining ? &*remaining : nullptr,
+                options.prefilter ? &storage : nullptr);
+        }
+        for (size_t i = 0; i < options.consumersNr; ++i)
+        {
+            consumers.emplace_back(queue, storage, sink, elementsNr, complete, options.batchSize,
+                                   metrics);
+        }
+
+        // Perform generation of random numbers asynchronously
+        for (auto& producer : producers)
+        {
+            startWorker(workers, options.pinning, [&producer]() { producer.produce(); });
+        }
+        for (auto& consumer : consumers)
+        {
+            startWorker(workers, options.pinning, [&consumer]() { consumer.consume(); });
+        }
+
+        // Wait for all workers to finish
+        workers.wait();
+        for (const auto& producer : producers)
+        {
+            draws += producer.draws();
+        }
+    }
+    else if constexpr (std::same_as<typename Queue::value_type, int>)
+    {
+        // The condition variable based approach only handles int numbers, up to INT_MAX
+        initializeStartTime();
+
+        // Perform generation of random numbers asynchronously, every producer on its own stream
+        for (size_t i = 0; i < options.producersNr; ++i)
+        {
+            core::RandomSource random(options.randomEngine, elementsNr, options.seed, i);
+            startWorker(workers, options.pinning,
+                        [&queue, random, &complete]() { produce(queue, random, complete); });
+        }
+        for (size_t i = 0; i < options.consumersNr; ++i)
+        {
+            startWorker(workers, options.pinning,
+                        [&]()
+                        {
+                            consume(queue, storage, sink, static_cast<int>(elementsNr),
+                                    complete);
+                        });
+        }
+
+        // Wait for all workers to finish
+        workers.wait();
+    }
+    return draws;
+}
+
+/**
+ * @brief Runs the producers and consumers over a queue, with a tuned capacity if asked.
+ *
+ * @tparam Queue The queue type shared by the producers and consumers.
+ * @param workers The pool running the worker threads.
+ * @param storage Reference to the storage for the generated numbers.
+ * @param sink Reference to the sink writing out the generated numbers.
+ * @param metrics Pointer to the metrics of the run, or nullptr to record none.
+ * @param elementsNr The number of elements to generate.
+ * @param complete Reference to the completion flag.
+ * @param options The options of the run.
+ * @param[out] tuning The outcome of the capacity tuning, if the capacity was tuned.
+ * @return The number of values the producers drew, or 0 if they are not counted.
+ */
+template <typename Queue>
+uint64_t runOnQueueOf(core::WorkerPool& workers,
+                      core::NumberStorage& storage,
+                      core::OutputSink& sink,
+                      core::Metrics* metrics,
+                      uint64_t elementsNr,
+                      std::atomic_bool& complete,
+                      const Options& options,
+                      std::optional<core::CapacityTuner::Summary>& tuning)
+{
+    // Only the mutex-protected queue can change its capacity
+    if constexpr (std::constructible_from<Queue, const core::CapacityTuning&>)
+    {
+        if (options.tunedCapacity)
+        {
+            core::CapacityTuning capacityTuning = options.tuning;
+            capacityTuning.m_initialCapacity = options.queueCapacity;
+            Queue queue(capacityTuning);
+            const uint64_t draws =
+                run(workers, queue, storage, sink, metrics, elementsNr, complete, options);
+            tuning = queue.tuningSummary();
+            return draws;
+        }
+    }
+    Queue queue(options.queueCapacity);
+    return run(workers, queue, storage, sink, metrics, elementsNr, complete, options);
+}
+
+/**
+ * @brief Runs the producers and consumers over a queue of the narrowest value type.
+ *
+ * Numbers up to INT_MAX travel as int; larger ranges take a queue of uint64_t.
+ *
+ * @tparam QueueType The queue template, instantiated for the value type.
+ * @param workers The pool running the worker threads.
+ * @param storage Reference to the storage for the generated numbers.
+ * @param sink Reference to the sink writing out the generated numbers.
+ * @param metrics Pointer to the metrics of the run, or nullptr to record none.
+ * @param elementsNr The number of elements to generate.
+ * @param complete Reference to the completion flag.
+ * @param options The options of the run.
+ * @param[out] tuning The outcome of the capacity tuning, if the capacity was tuned.
+ * @return The number of values the producers drew, or 0 if they are not counted.
+ */
+template <template <typename> typename QueueType>
+uint64_t runOnQueue(core::WorkerPool& workers,
+                    core::NumberStorage& storage,
+                    core::OutputSink& sink,
+                    core::Metrics* metrics,
+                    uint64_t elementsNr,
+                    std::atomic_bool& complete,
+                    const Options& options,
+                    std::optional<core::CapacityTuner::Summary>& tuning)
+{
+    if (elementsNr <= INT_MAX)
+    {
+        return runOnQueueOf<QueueType<int>>(workers, storage, sink, metrics, elementsNr, complete,
+                                            options, tuning);
+    }
+    return runOnQueueOf<QueueType<uint64_t>>(workers, storage, sink, metrics, elementsNr,
+                                             complete, options, tuning);
+}
+
+/**
+ * @brief Runs the sharded pipeline.
+ *
+ * Producers get the worker indices 0..P-1 and consumers P..P+C-1, as in run().
+ *
+ * @param workers The pool running the worker threads.
+ * @param storage Reference to the storage for the generated numbers.
+ * @param sink Reference to the sink writing out the generated numbers.
+ * @param elementsNr The number of elements to generate.
+ * @param complete Reference to the completion flag.
+ * @param options The options of the run.
+ */
+void runSharded(core::WorkerPool& workers,
+                core::NumberStorage& storage,
+                core::OutputSink& sink,
+                int elementsNr,
+                std::atomic_bool& complete,
+                const Options& options)
+{
+    ShardedQueues queues(options.producersNr, options.consumersNr, options.queueCapacity);
+    std::vector<ShardedProducer> producers;
+    std::vector<ShardedConsumer> consumers;
+    producers.reserve(options.producersNr);
+    consumers.reserve(options.consumersNr);
+    for (size_t i = 0; i < options.producersNr; ++i)
+    {
+        producers.emplace_back(
+            queues, i, core::RandomSource(options.randomEngine, elementsNr, options.seed, i),
+            complete);
+    }
+    for (size_t i = 0; i < options.consumersNr; ++i)
+    {
+        consumers.emplace_back(queues, i, storage, sink, elementsNr, complete,
+                               options.batchSize);
+    }
+
+    // Perform generation of random numbers asynchronously
+    for (auto& producer : producers)
+    {
+        startWorker(workers, options.pinning, [&producer]() { producer.produce(); });
+    }
+    for (auto& consumer : consumers)
+    {
+        startWorker(workers, options.pinning, [&consumer]() { consumer.consume(); });
+    }
+
+    // Wait for all workers to finish
+    workers.wait();
+}
+
+/**
+ * @brief Generates the numbers on work-stealing workers.
+ *
+ * The producer and consumer counts add up to the number of workers, since
+ * every worker runs both stages. The workers get the indices 0..P+C-1,
+ * which decide the CPUs they are pinned to.
+ *
+ * @param workers The pool running the worker threads.
+ * @param storage Reference to the storage for the generated numbers.
+ * @param sink Reference to the sink writing out the generated numbers.
+ * @param elementsNr The number of elements to generate.
+ * @param options The options of the run.
+ */
+void runWorkStealing(core::WorkerPool& workers,
+                     core::NumberStorage& storage,
+                     core::OutputSink& sink,
+                     int elementsNr,
+                     const Options& options)
+{
+    WorkStealingScheduler scheduler(storage, sink, elementsNr, options.randomEngine, options.seed,
+                                    options.producersNr + options.consumersNr);
+
+    // Perform generation of random numbers asynchronously
+    for (size_t i = 0; i < scheduler.workersNr(); ++i)
+    {
+        startWorker(workers, options.pinning, [&scheduler, i]() { scheduler.work(i); });
+    }
+
+    // Wait for all workers to finish
+    workers.wait();
+}
+
+/**
+ * @brief Emits a random permutation of 1..elementsNr.
+ *
+ * The producer count sets the number of workers, each emitting one
+ * contiguous range of indices of the permutation. The workers get the
+ * indices 0..P-1, which decide the CPUs they are pinned to.
+ *
+ * @param workers The pool running the worker threads.
+ * @param storage Pointer to the storage for the generated numbers, or nullptr to stream them.
+ * @param sink Reference to the sink writing out the generated numbers.
+ * @param elementsNr The number of elements to generate.
+ * @param options The options of the run.
+ */
+void runPermutation(core::WorkerPool& workers,
+                    core::NumberStorage* storage,
+                    core::OutputSink& sink,
+                    uint64_t elementsNr,
+                    const Options& options)
+{
+    const core::FeistelPermutation permutation(elementsNr, options.seed);
+
+    // Start index of worker i, without overflowing for ranges close to 2^64
+    const auto rangeStart = [&](size_t i)
+    {
+        return static_cast<uint64_t>(static_cast<unsigned __int128>(elementsNr) * i /
+                                     options.producersNr);
+    };
+    std::vector<PermutationWorker> permutationWorkers;
+    permutationWorkers.reserve(options.producersNr);
+    for (size_t i = 0; i < options.producersNr; ++i)
+    {
+        permutationWorkers.emplace_back(permutation, storage, sink, rangeStart(i),
+                                        rangeStart(i + 1));
+    }
+
+    // Perform generation of random numbers asynchronously
+    for (auto& worker : permutationWorkers)
+    {
+        startWorker(workers, options.pinning, [&worker]() { worker.generate(); });
+    }
+
+    // Wait for all workers to finish
+    workers.wait();
+}
+
+/**
+ * @brief Runs the deterministic pipeline.
+ *
+ * Producers get the worker indices 0..P-1 and the merger P. The consumer
+ * count does not apply: merging in a fixed order takes a single thread.
+ *
+ * @param workers The pool running the worker threads.
+ * @param storage Reference to the storage for the generated numbers.
+ * @param sink Reference to the sink writing out the generated numbers.
+ * @param elementsNr The number of elements to generate.
+ * @param options The options of the run.
+ * @return The number of values the merger took from the producers.
+ */
+uint64_t runDeterministic(core::WorkerPool& workers,
+                          core::NumberStorage& storage,
+                          core::OutputSink& sink,
+                          int elementsNr,
+                          const Options& options)
+{
+    DeterministicPipeline pipeline(storage, sink, elementsNr, options.randomEngine, options.seed,
+                                   options.producersNr);
+
+    // Perform generation of random numbers asynchronously
+    for (size_t i = 0; i < options.producersNr; ++i)
+    {
+        startWorker(workers, options.pinning, [&pipeline, i]() { pipeline.produce(i); });
+    }
+    startWorker(workers, options.pinning, [&pipeline]() { pipeline.merge(); });
+
+    // Wait for all workers to finish
+    workers.wait();
+    return pipeline.draws();
+}
+
+/**
+ * @brief Emits the numbers pulled from the coroutine pipeline of uniqueNumbers().
+ *
+ * The producer and consumer counts set the number of stages, and the pool
+ * running them gets one thread per stage. Pinning does not apply to the pool.
+ *
+ * @param sink Reference to the sink writing out the generated numbers.
+ * @param elementsNr The number of elements to generate.
+ * @param options The options of the run.
+ */
+void runCoroutines(core::OutputSink& sink, uint64_t elementsNr, const Options& options)
+{
+    core::UniqueNumbersOptions generatorOptions;
+    generatorOptions.m_elements = elementsNr;
+    generatorOptions.m_producersNr = options.producersNr;
+    generatorOptions.m_consumersNr = options.consumersNr;
+    generatorOptions.m_threadsNr = options.producersNr + options.consumersNr;
+    generatorOptions.m_queueCapacity = options.queueCapacity;
+    generatorOptions.m_randomEngine = options.randomEngine;
+    generatorOptions.m_seed = options.seed;
+
+    core::OutputSink::Writer writer(sink);
+    size_t order = 0;
+    auto lastTime = std::chrono::high_resolution_clock::now();
+    for (const uint64_t number : core::uniqueNumbers(generatorOptions))
+    {
+        // Time the caller waited for the number
+        const auto now = std::chrono::high_resolution_clock::now();
+        const auto timeTaken =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - lastTime).count();
+        writer.write(number, ++order, timeTaken);
+        lastTime = now;
+    }
+}
+
+/**
+ * @brief Runs the producers and consumers in forked processes sharing a memory segment.
+ *
+ * Every worker is a process of its own: producers are the processes
+ * 0..P-1 and consumers P..P+C-1, which decide the CPUs they are pinned to.
+ * They inherit the mapping of the segment, and each consumer process writes
+ * to the output through a sink of its own. The sink of the parent must be
+ * closed before, so that its writer thread is not running across fork().
+ * In job mode, threads of the worker pool left by earlier jobs do exist:
+ * they are parked in a condition variable wait, or about to park, and may
+ * hold the pool's mutex at fork(). The worker processes never touch the
+ * pool and leave with _exit(), so they cannot deadlock on that mutex.
+ *
+ * @param segment Reference to the segment shared by the workers.
+ * @param resultFile Pointer to the mapped result file, or nullptr to write to outputFd.
+ * @param outputFd The file descriptor the consumers write to.
+ * @param options The options of the run.
+ * @return true if every worker process finished successfully.
+ */
+bool runShared(core::SharedSegment& segment,
+               core::MappedResultFile* resultFile,
+               int outputFd,
+               const Options& options)
+{
+    initializeSharedStartTime(segment);
+    const size_t workersNr = options.producersNr + options.consumersNr;
+    std::vector<pid_t> children;
+    children.reserve(workersNr);
+    for (size_t i = 0; i < workersNr; ++i)
+    {
+        const pid_t pid = ::fork();
+        if (pid < 0)
+        {
+            break;
+        }
+        if (pid != 0)
+        {
+            children.push_back(pid);
+            continue;
+        }
+
+        // The worker process, running on the only thread left after fork()
+        if (!options.pinning.pinCurrentThread(i))
+        {
+            std::cout << std::format("Failed to pin worker {} to CPUs {}.\n", i,
+                                     options.pinning.describe(i));
+        }
+        if (i < options.producersNr)
+        {
+            produceShared(segment,
+                          core::RandomSource(options.randomEngine, segment.elements(),
+                                             options.seed, i),
+                          options.batchSize);
+        }
+        else
+        {
+            std::optional<core::OutputSink> sink;
+            if (resultFile != nullptr)
+            {
+                sink.emplace(*resultFile);
+            }
+            else
+            {
+                sink.emplace(options.outputFormat, outputFd, false);
+            }
+            consumeShared(segment, *sink, options.batchSize);
+            sink->close();
+        }
+        std::cout.flush();
+        ::_exit(0);
+    }
+
+    bool succeeded = children.size() == workersNr;
+    if (!succeeded)
+    {
+        // Some workers could not be started: stop the others
+        segment.header().m_complete.store(true);
+    }
+    for (const pid_t child : children)
+    {
+        int status = 0;
+        succeeded = ::waitpid(child, &status, 0) == child && WIFEXITED(status) &&
+                    WEXITSTATUS(status) == 0 && succeeded;
+    }
+    return succeeded;
+}
+
+/**
+ * @brief Sets the generation mode given by name with --mode.
+ *
+ * @param name The name of the mode, as the flag selecting it without its dashes.
+ * @param options The options, whose previous mode flags are cleared.
+ * @return false if the name is unknown.
+ */
+[[nodiscard]] bool applyMode(std::string_view name, Options& options)
+{
+    Options modes;
+    if (name == "lock-free")
+    {
+        modes.lockFreeMode = true;
+    }
+    else if (name == "blocking")
+    {
+        modes.blockingMode = true;
+    }
+    else if (name == "cv")
+    {
+        modes.cvMode = true;
+    }
+    else if (name == "sharded")
+    {
+        modes.shardedMode = true;
+    }
+    else if (name == "permutation" || name == "stream")
+    {
+        modes.permutationMode = true;
+        modes.streamMode = name == "stream";
+    }
+    else if (name == "work-stealing")
+    {
+        modes.workStealingMode = true;
+    }
+    else if (name == "deterministic")
+    {
+        modes.deterministicMode = true;
+    }
+    else if (name == "shm")
+    {
+        modes.sharedMemoryMode = true;
+    }
+    else if (name == "coroutines")
+    {
+        modes.coroutinesMode = true;
+    }
+    else if (name != "queue")
+    {
+        return false;
+    }
+    options.cvMode = modes.cvMode;
+    options.lockFreeMode = modes.lockFreeMode;
+    options.blockingMode = modes.blockingMode;
+    options.shardedMode = modes.shardedMode;
+    options.permutationMode = modes.permutationMode;
+    options.streamMode = modes.streamMode;
+    options.workStealingMode = modes.workStealingMode;
+    options.coroutinesMode = modes.coroutinesMode;
+    options.deterministicMode = modes.deterministicMode;
+    options.sharedMemoryMode = modes.sharedMemoryMode;
+    return true;
+}
+
+/**
+ * @brief Parses command-line arguments, or the arguments of a job, into options.
+ *
+ * Options that are not given keep their value, so that jobs start from
+ * the options of the command line.
+ *
+ * @param arguments The arguments, without the program name.
+ * @param options The options, updated with the given ones.
+ * @return The error message of the first invalid argument, or std::nullopt if all are valid.
+ */
+[[nodiscard]] std::optional<std::string> parseArguments(const std::vector<std::string>& arguments,
+                                                        Options& options)
+{
     for (const auto& arg : arguments)
     {
         if (arg == "--cv" || arg == "-cv")
         {
             // Standard approach with condition variables
-            cvMode = true;
+            options.cvMode = true;
+        }
+        else if (arg == "--lock-free" || arg == "-lock-free")
+        {
+            // Lock-free ring buffer instead of the mutex-protected queue
+            options.lockFreeMode = true;
+        }
+        else if (arg == "--blocking" || arg == "-blocking")
+        {
+            // Blocking queue: threads park instead of polling while the queue is full or empty
+            options.blockingMode = true;
+        }
+        else if (arg == "--sharded" || arg == "-sharded")
+        {
+            // One SPSC queue per producer and consumer, values routed to the consumer owning them
+            options.shardedMode = true;
+        }
+        else if (arg == "--permutation" || arg == "-permutation")
+        {
+            // Emit a random permutation directly, without drawing and rejecting duplicates
+            options.permutationMode = true;
+        }
+        else if (arg == "--stream" || arg == "-stream")
+        {
+            // Emit the permutation in constant memory, without storage, for ranges beyond RAM
+            options.permutationMode = true;
+            options.streamMode = true;
+        }
+        else if (arg == "--work-stealing" || arg == "-work-stealing")
+        {
+            // Chunks of the range generated locally by workers stealing from each other
+            options.workStealingMode = true;
+        }
+        else if (arg == "--deterministic" || arg == "-deterministic")
+        {
+            // Same seed and producer count, same sequence: blocks of draws merged in a fixed order
+            options.deterministicMode = true;
+        }
+        else if (arg == "--shm" || arg == "-shm")
+        {
+            // Producers and consumers in separate processes, sharing a memory segment
+            options.sharedMemoryMode = true;
+        }
+        else if (arg.starts_with("--seed="))
+        {
+            // Seed of the run instead of one from std::random_device, to replay a run
+            auto seed = parseSeed(optionValue(arg));
+            if (!seed)
+            {
+                return "Incorrect seed. Must be unsigned 64-bit integer.";
+            }
+            options.seed = *seed;
+            options.fixedSeed = true;
+        }
+        else if (arg == "--coroutines" || arg == "-coroutines")
+        {
+            // Pull the numbers lazily from coroutine stages suspending on their queues
+            options.coroutinesMode = true;
+        }
+        else if (arg.starts_with("--rng="))
+        {
+            // Random engine of the producers
+            auto engine = core::parseRandomEngine(optionValue(arg));
+            if (!engine)
+            {
+                return "Incorrect random engine. Must be std, xoshiro, pcg, simd or philox.";
+            }
+            options.randomEngine = *engine;
         }
+        else if (arg.starts_with("--format="))
+        {
+            // Format of the generated numbers
+            auto format = core::parseOutputFormat(optionValue(arg));
+            if (!format)
+            {
+                return "Incorrect output format. Must be text, csv, binary, mapped or quiet.";
+            }
+            options.outputFormat = *format;
+        }
+        else if (arg.starts_with("--output="))
+        {
+            options.outputPath = optionValue(arg);
+        }
+        else if (arg == "--no-times" || arg == "-no-times")
+        {
+            // Do not keep the generation time column of the storage
+            options.recordTimes = false;
+        }
+        else if (arg == "--huge-pages" || arg == "-huge-pages")
+        {
+            // Advise the storage columns to use transparent huge pages
+            options.hugePages = true;
+        }
+        else if (arg == "--metrics")
+        {
+            // Per-stage latency histograms and counters, summarized at the end
+            options.metrics = true;
+        }
+        else if (arg.starts_with("--metrics-file="))
+        {
+            options.metrics = true;
+            options.metricsPath = optionValue(arg);
+        }
+        else if (arg.starts_with("--metrics-interval="))
+        {
+            options.metricsInterval = parseCount(optionValue(arg));
+            if (options.metricsInterval == 0)
+            {
+                return "Incorrect metrics interval. Must be positive integer.";
+            }
+        }
+        else if (arg == "--adaptive" || arg.starts_with("--adaptive="))
+        {
+            // Switch the producers to the missing numbers once this share of draws misses
+            options.adaptiveMissRate = arg == "--adaptive" ? 0.9 : parseRate(optionValue(arg));
+            if (options.adaptiveMissRate == 0.0)
+            {
+                return "Incorrect adaptive miss rate. Must be a number in (0, 1].";
+            }
+        }
+        else if (arg == "--prefilter" || arg == "-prefilter")
+        {
+            // Check the draws against the dedup bitset before pushing them
+            options.prefilter = true;
+        }
+        else if (arg.starts_with("--batch="))
+        {
+            // Number of integers generated and drained with a single queue operation
+            options.batchSize = parseCount(optionValue(arg));
+            if (options.batchSize == 0)
+            {
+                return "Incorrect batch size. Must be positive integer.";
+            }
+        }
+        else if (arg.starts_with("--producers="))
+        {
+            options.producersNr = parseCount(optionValue(arg));
+            if (options.producersNr == 0)
+            {
+                return "Incorrect number of producers. Must be positive integer.";
+            }
+        }
+        else if (arg.starts_with("--consumers="))
+        {
+            options.consumersNr = parseCount(optionValue(arg));
+            if (options.consumersNr == 0)
+            {
+                return "Incorrect number of consumers. Must be positive integer.";
+            }
+        }
+        else if (arg.starts_with("--pin="))
+        {
+            // Pin the worker threads to cores or NUMA nodes
+            auto pinning = core::ThreadPinning::parse(optionValue(arg));
+            if (!pinning)
+            {
+                return "Incorrect pinning. Must be cores[:LIST] or numa[:LIST].";
+            }
+            options.pinning = std::move(*pinning);
+        }
+        else if (arg.starts_with("--mode="))
+        {
+            // Generation mode by name, as an alternative to the flags above
+            if (!applyMode(optionValue(arg), options))
+            {
+                return "Incorrect mode. Must be queue, lock-free, blocking, cv, sharded, "
+                       "permutation, stream, work-stealing, deterministic, shm or coroutines.";
+            }
+        }
+        else if (arg.starts_with("--queue-capacity="))
+        {
+            // Capacity of the queues between the producers and the consumers, or tuned
+            options.tunedCapacity = optionValue(arg) == "auto";
+            if (!options.tunedCapacity)
+            {
+                options.queueCapacity = parseCount(optionValue(arg));
+                if (options.queueCapacity == 0)
+                {
+                    return "Incorrect queue capacity. Must be positive integer or auto.";
+                }
+            }
+        }
+        else if (arg.starts_with("--queue-watermarks="))
+        {
+            // Full and empty rates from which the tuned capacity changes
+            const std::string_view value = optionValue(arg);
+            const size_t comma = value.find(',');
+            const double low = comma == std::string_view::npos ? 0.0
+                                                               : parseRate(value.substr(0, comma));
+            const double high =
+                comma == std::string_view::npos ? 0.0 : parseRate(value.substr(comma + 1));
+            if (low == 0.0 || high == 0.0 || low > high)
+            {
+                return "Incorrect queue watermarks. Must be LOW,HIGH, two numbers in (0, 1] "
+                       "with LOW <= HIGH.";
+            }
+            options.tuning.m_lowWatermark = low;
+            options.tuning.m_highWatermark = high;
+        }
+        else if (arg.starts_with("--queue-residency="))
+        {
+            // Mean time in microseconds above which the tuned capacity shrinks
+            const size_t residency = parseCount(optionValue(arg));
+            if (residency == 0)
+            {
+                return "Incorrect queue residency. Must be positive integer.";
+            }
+            options.tuning.m_maxResidency =
+                std::chrono::microseconds(static_cast<int64_t>(residency));
+        }
+        else if (arg.starts_with("--jobs="))
+        {
+            // Run specs read from a file, or from stdin with "-", run back to back
+            options.jobsPath = optionValue(arg);
+            if (options.jobsPath.empty())
+            {
+                return "Incorrect job file. Must be a path or -.";
+            }
+        }
+        else if (arg.starts_with("--elements=") || !arg.starts_with('-'))
+        {
+            // The number of elements, instead of reading it from stdin
+            options.elementsNr = parseCount(arg.starts_with('-') ? optionValue(arg) : arg);
+            if (options.elementsNr == 0)
+            {
+                return "Incorrect value. Must be positive integer.";
+            }
+        }
+        else
+        {
+            return std::format("Incorrect argument {}. See --help.", arg);
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Checks whether a run uses the Producer and Consumer classes over a shared queue.
+ *
+ * @param options The options of the run.
+ */
+[[nodiscard]] bool usesProducerClass(const Options& options)
+{
+    return !(options.cvMode || options.shardedMode || options.permutationMode ||
+             options.workStealingMode || options.coroutinesMode || options.deterministicMode ||
+             options.sharedMemoryMode);
+}
+
+/**
+ * @brief Checks that the options of a run go together.
+ *
+ * @param options The options of the run.
+ * @return The error message, or std::nullopt if the options are consistent.
+ */
+[[nodiscard]] std::optional<std::string> checkOptions(const Options& options)
+{
+    const bool producerClassMode = usesProducerClass(options);
+    if (options.metrics && !producerClassMode)
+    {
+        return "Metrics are only collected by the Producer and Consumer classes, "
+               "not with --cv, --sharded, --permutation, --work-stealing, --coroutines, "
+               "--deterministic or --shm.";
+    }
+    if (options.prefilter && !producerClassMode)
+    {
+        return "Draws are only filtered by the Producer class, "
+               "not with --cv, --sharded, --permutation, --work-stealing, --coroutines, "
+               "--deterministic or --shm.";
+    }
+    if (options.adaptiveMissRate > 0.0 && !producerClassMode)
+    {
+        return "Adaptive sampling is only done by the Producer class, "
+               "not with --cv, --sharded, --permutation, --work-stealing, --coroutines, "
+               "--deterministic or --shm.";
     }
 
-    int elementsNr{};
-    std::cout << "Please enter the number of elements to generate: ";
-    std::cin >> elementsNr;
+    if (options.tunedCapacity &&
+        (options.lockFreeMode || options.blockingMode || !(producerClassMode || options.cvMode)))
+    {
+        return "The queue capacity is only tuned on the mutex-protected queue, "
+               "not with --lock-free, --blocking, --sharded, --permutation, --work-stealing, "
+               "--coroutines, --deterministic or --shm.";
+    }
 
-    if (elementsNr <= 0 || elementsNr > RAND_MAX)
+    const bool mappedOutput = options.outputFormat == core::OutputFormat::Mapped;
+    if (mappedOutput && options.outputPath.empty())
     {
-        std::cout << "Incorrect value. Must be positive integer not larger than RAND_MAX.";
-        return -1;
+        return "The mapped output format needs a file, given with --output=PATH.";
     }
+    return std::nullopt;
+}
 
-    // Create a shared thread-safe queue
-    core::ThreadSafeQueue<int> queue(QUEUE_SIZE_MAX);
-    // Create s storage for random numbers
-    std::vector<NumberInfo> storage(elementsNr);
-    // Completion flag
-    std::atomic_bool complete(false);
-    std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
-    if (!cvMode)
+/**
+ * @brief Generates the numbers of one run and reports its times.
+ *
+ * @param workers The pool running the worker threads.
+ * @param options The options of the run, accepted by checkOptions().
+ * @param launchTime The time the run was asked for, from which the time to the first number counts.
+ * @return The error message, or std::nullopt if the run completed.
+ */
+[[nodiscard]] std::optional<std::string> runGeneration(
+    core::WorkerPool& workers,
+    Options options,
+    std::chrono::steady_clock::time_point launchTime)
+{
+    const uint64_t elementsNr = options.elementsNr;
+    const bool producerClassMode = usesProducerClass(options);
+    const bool mappedOutput = options.outputFormat == core::OutputFormat::Mapped;
+    if (elementsNr == 0)
     {
-        Consumer::setStartTime();
-        startTime = std::chrono::high_resolution_clock::now();
-        // Perform generation of random numbers asynchronously
-        Producer producerOne(queue, elementsNr, complete);
-        Producer producerTwo(queue, elementsNr, complete);
-        Consumer consumerOne(queue, storage, elementsNr, complete);
-        Consumer consumerTwo(queue, storage, elementsNr, complete);
-
-        std::thread prodThreadOne(&Producer::produce, &producerOne);
-        std::thread consThreadOne(&Consumer::consume, &consumerOne);
-        std::thread prodThreadTwo(&Producer::produce, &producerTwo);
-        std::thread consThreadTwo(&Consumer::consume, &consumerTwo);
-
-        // Wait for all threads to finish
-        prodThreadOne.join();
-        consThreadOne.join();
-        prodThreadTwo.join();
-        consThreadTwo.join();
+        return "Incorrect value. Must be positive integer.";
     }
-    else
+    // Only the Producer and Consumer classes, the permutation and the coroutines go past INT_MAX
+    if (elementsNr > INT_MAX &&
+        !(producerClassMode || options.permutationMode || options.coroutinesMode))
     {
-        initializeDistribution(elementsNr);
-        initializeStartTime();
+        return "Incorrect value. --cv, --sharded, --work-stealing, --deterministic and "
+               "--shm generate at most INT_MAX numbers.";
+    }
+    // The binary record and the mapped result file hold numbers as int32
+    if (elementsNr > INT_MAX && (options.outputFormat == core::OutputFormat::Binary ||
+                                 options.outputFormat == core::OutputFormat::Mapped))
+    {
+        return "Incorrect value. The binary and mapped formats hold at most INT_MAX "
+               "numbers.";
+    }
 
-        startTime = std::chrono::high_resolution_clock::now();
-        // Perform generation of random numbers asynchronously
-        std::thread prodThreadOne([&]() { produce(queue, elementsNr, complete); });
-        std::thread consThreadOne([&]() { consume(queue, storage, elementsNr, complete); });
-        std::thread prodThreadTwo([&]() { produce(queue, elementsNr, complete); });
-        std::thread consThreadTwo([&]() { consume(queue, storage, elementsNr, complete); });
+    // One seed for all random streams of the run
+    if (!options.fixedSeed)
+    {
+        std::random_device device;
+        options.seed = (static_cast<uint64_t>(device()) << 32) | device();
+    }
 
-        // Wait for all threads to finish
-        prodThreadOne.join();
-        consThreadOne.join();
-        prodThreadTwo.join();
-        consThreadTwo.join();
+    // Create s storage for random numbers, without the columns a mapped result file keeps.
+    // A streamed permutation keeps no storage at all, and the coroutine pipeline its own one.
+    // Worker processes share the dedup bitset of their segment instead.
+    // The columns are mapped zero-filled and faulted in by the workers' CPUs, not cleared here.
+    core::PageMemoryResource storageMemory(options.hugePages);
+    std::optional<core::NumberStorage> numberStorage;
+    if (!options.streamMode && !options.coroutinesMode && !options.sharedMemoryMode)
+    {
+        numberStorage.emplace(elementsNr, options.recordTimes && !mappedOutput, !mappedOutput,
+                              &storageMemory);
+        touchStorage(workers, *numberStorage, options);
+    }
+    // Per-stage metrics, optionally sampled to a file while the run is going
+    std::optional<core::Metrics> metrics;
+    if (options.metrics)
+    {
+        metrics.emplace(static_cast<size_t>(elementsNr));
+        if (!options.metricsPath.empty() &&
+            !metrics->startSampling(options.metricsPath,
+                                    std::chrono::milliseconds(options.metricsInterval)))
+        {
+            return std::format("Cannot open metrics file {}.", options.metricsPath);
+        }
+    }
+    core::Metrics* metricsPtr = metrics ? &*metrics : nullptr;
+    // Ring and dedup bitset shared by the worker processes, removed once the run is over
+    const std::string segmentName = std::format("/multithreaded_generator.{}", ::getpid());
+    std::optional<core::SharedSegment> segment =
+        options.sharedMemoryMode
+            ? core::SharedSegment::create(segmentName, static_cast<size_t>(elementsNr),
+                                          options.queueCapacity)
+            : std::nullopt;
+    if (options.sharedMemoryMode && !segment)
+    {
+        return std::format("Cannot create shared memory segment {}.", segmentName);
+    }
+    // Output of the generated numbers, written by a dedicated thread or stored into a mapping
+    std::optional<core::MappedResultFile> resultFile =
+        mappedOutput ? core::MappedResultFile::create(
+                           options.outputPath, static_cast<size_t>(elementsNr), options.recordTimes)
+                     : std::nullopt;
+    int outputFd = STDOUT_FILENO;
+    if (mappedOutput && !resultFile)
+    {
+        return std::format("Cannot create result file {}.", options.outputPath);
+    }
+    if (!mappedOutput && !options.outputPath.empty())
+    {
+        outputFd = ::open(options.outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (outputFd < 0)
+        {
+            return std::format("Cannot open output file {}.", options.outputPath);
+        }
+    }
+    // Status messages must not end up in the middle of the records
+    std::cout.flush();
+    std::optional<core::OutputSink> outputSink;
+    if (resultFile)
+    {
+        outputSink.emplace(*resultFile);
+    }
+    else
+    {
+        outputSink.emplace(options.outputFormat, outputFd);
+    }
+    core::OutputSink& sink = *outputSink;
+    if (options.sharedMemoryMode)
+    {
+        // Writes the header, and stops the writer thread before fork(). Pool threads stay
+        // parked; see runShared().
+        sink.close();
+    }
+    // Completion flag, polled by every worker, so alone on its cache line
+    alignas(core::kCacheLineSize) std::atomic_bool complete(false);
+    // Values drawn by the producers, when they are counted
+    uint64_t draws = 0;
+    // Capacity chosen for the queue, when it is tuned
+    std::optional<core::CapacityTuner::Summary> tuning;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (options.sharedMemoryMode)
+    {
+        // Fork the workers, exchanging the numbers through the segment
+        if (!runShared(*segment, resultFile ? &*resultFile : nullptr, outputFd, options))
+        {
+            if (outputFd != STDOUT_FILENO)
+            {
+                ::close(outputFd);
+            }
+            return "A worker process failed.";
+        }
+    }
+    else if (options.workStealingMode)
+    {
+        // Deal chunks of the range to workers that steal from each other
+        runWorkStealing(workers, *numberStorage, sink, static_cast<int>(elementsNr), options);
+    }
+    else if (options.deterministicMode)
+    {
+        // Merge blocks of the producers' draws in a fixed order
+        draws = runDeterministic(workers, *numberStorage, sink, static_cast<int>(elementsNr),
+                                 options);
+    }
+    else if (options.coroutinesMode)
+    {
+        // Pull the numbers from the generator, its stages running on a thread pool
+        runCoroutines(sink, elementsNr, options);
+    }
+    else if (options.permutationMode)
+    {
+        // Split a keyed permutation of the range between the workers
+        runPermutation(workers, numberStorage ? &*numberStorage : nullptr, sink, elementsNr,
+                       options);
+    }
+    else if (options.shardedMode)
+    {
+        // Create the per-consumer queues of the sharded pipeline
+        runSharded(workers, *numberStorage, sink, static_cast<int>(elementsNr), complete,
+                   options);
+    }
+    else if (options.blockingMode)
+    {
+        // Create a shared blocking queue
+        draws = runOnQueue<core::BlockingQueue>(workers, *numberStorage, sink, metricsPtr,
+                                                elementsNr, complete, options, tuning);
+    }
+    else if (options.lockFreeMode)
+    {
+        // Create a shared lock-free queue
+        draws = runOnQueue<core::LockFreeQueue>(workers, *numberStorage, sink, metricsPtr,
+                                                elementsNr, complete, options, tuning);
+    }
+    else
+    {
+        // Create a shared thread-safe queue
+        draws = runOnQueue<core::ThreadSafeQueue>(workers, *numberStorage, sink, metricsPtr,
+                                                  elementsNr, complete, options, tuning);
     }
 
     auto endTime = std::chrono::high_resolution_clock::now();
     auto totalWorkTime =
         std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
 
-    auto totalTime =
-        std::accumulate(storage.begin(), storage.end(), 0, [](int sum, const NumberInfo& element)
-                        { return sum + element.m_generationTime; });
+    // Let the writer thread finish outside of the measured time
+    sink.close();
+    if (outputFd != STDOUT_FILENO)
+    {
+        ::close(outputFd);
+    }
+    if (resultFile)
+    {
+        resultFile->finish(static_cast<size_t>(elementsNr));
+    }
 
-    std::cout << "Generation completed. Total generation time: " << totalTime << " microseconds."
-              << std::endl;
+    if (resultFile && resultFile->recordsTimes())
+    {
+        std::cout << "Generation completed. Total generation time: "
+                  << resultFile->totalGenerationTime() << " microseconds." << std::endl;
+    }
+    else if (numberStorage && numberStorage->recordsTimes())
+    {
+        std::cout << "Generation completed. Total generation time: "
+                  << numberStorage->totalGenerationTime() << " microseconds." << std::endl;
+    }
+    else if (segment && options.recordTimes)
+    {
+        std::cout << "Generation completed. Total generation time: "
+                  << segment->header().m_totalTime.load() << " microseconds." << std::endl;
+    }
+    else
+    {
+        std::cout << "Generation completed." << std::endl;
+    }
     std::cout << "Total execution time: " << totalWorkTime << " microseconds." << std::endl;
+    if (const auto firstNumberTime = sink.firstNumberTime())
+    {
+        std::cout << std::format(
+            "Time to first number: {} microseconds.\n",
+            std::chrono::duration_cast<std::chrono::microseconds>(*firstNumberTime - launchTime)
+                .count());
+    }
+    std::cout << std::format("Seed: {}.\n", options.seed);
+    if (draws > 0)
+    {
+        std::cout << std::format("Draws per emitted number: {:.3f} ({} draws).\n",
+                                 static_cast<double>(draws) / elementsNr, draws);
+    }
+    if (tuning)
+    {
+        std::cout << std::format(
+            "Queue capacity: {} in steady state, tuned from {} with {} resizes. In the last "
+            "window, {:.1f}% of the pushes found the queue full, {:.1f}% of the pops found it "
+            "empty, and numbers stayed {} microseconds in it. Pin it with --queue-capacity={}.\n",
+            tuning->m_capacity, tuning->m_initialCapacity, tuning->m_resizes,
+            tuning->m_fullRate * 100.0, tuning->m_emptyRate * 100.0,
+            std::chrono::duration_cast<std::chrono::microseconds>(tuning->m_residency).count(),
+            tuning->m_capacity);
+    }
+    if (metrics)
+    {
+        metrics->stopSampling();
+        metrics->printSummary(std::cout);
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Runs the jobs of a job file back to back, on the same worker threads.
+ *
+ * Every line of the file holds the arguments of one run, N included, on
+ * top of the options of the command line. Blank lines and lines starting
+ * with '#' are skipped. A job that fails is reported, and the next one
+ * runs anyway.
+ *
+ * @param workers The pool running the worker threads of every job.
+ * @param defaults The options of the command line.
+ * @return 0 if every job completed, -1 otherwise.
+ */
+int runJobs(core::WorkerPool& workers, const Options& defaults)
+{
+    std::ifstream file;
+    if (defaults.jobsPath != "-")
+    {
+        file.open(defaults.jobsPath);
+        if (!file)
+        {
+            std::cout << std::format("Cannot open job file {}.", defaults.jobsPath);
+            return -1;
+        }
+    }
+    std::istream& input = defaults.jobsPath == "-" ? std::cin : file;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    size_t jobsNr = 0;
+    size_t failedNr = 0;
+    size_t lineNr = 0;
+    std::string line;
+    while (std::getline(input, line))
+    {
+        ++lineNr;
+        std::istringstream words(line);
+        const std::vector<std::string> arguments{std::istream_iterator<std::string>(words),
+                                                 std::istream_iterator<std::string>()};
+        if (arguments.empty() || arguments.front().starts_with('#'))
+        {
+            continue;
+        }
+        ++jobsNr;
+
+        const auto jobTime = std::chrono::steady_clock::now();
+        Options options = defaults;
+        options.jobsPath.clear();
+        std::optional<std::string> error = parseArguments(arguments, options);
+        if (!error && !options.jobsPath.empty())
+        {
+            error = "Incorrect argument --jobs. Jobs cannot run other jobs.";
+        }
+        if (!error)
+        {
+            error = checkOptions(options);
+        }
+        if (!error)
+        {
+            error = runGeneration(workers, std::move(options), jobTime);
+        }
+        if (error)
+        {
+            std::cout << *error << '\n';
+            ++failedNr;
+        }
+        const auto jobDuration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - jobTime);
+        std::cout << std::format("Job {} (line {}) {} in {} microseconds.\n", jobsNr, lineNr,
+                                 error ? "failed" : "completed", jobDuration.count());
+    }
+
+    const auto totalDuration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    std::cout << std::format("Jobs: {} run, {} failed, in {} microseconds on {} worker threads.\n",
+                             jobsNr, failedNr, totalDuration.count(), workers.threadsNr());
+    return failedNr == 0 ? 0 : -1;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    // Startup costs count towards the time to the first number
+    const auto launchTime = std::chrono::steady_clock::now();
+
+    // Check command-line arguments
+    const std::vector<std::string> arguments(argv + 1, argv + argc);
+    if (std::ranges::any_of(arguments,
+                            [](const std::string& arg) { return arg == "--help" || arg == "-h"; }))
+    {
+        std::cout << kUsage;
+        return 0;
+    }
+    Options options;
+    if (auto error = parseArguments(arguments, options))
+    {
+        std::cout << *error;
+        return -1;
+    }
+
+    // Worker threads, kept from one job to the next
+    core::WorkerPool workers;
+    if (!options.jobsPath.empty())
+    {
+        return runJobs(workers, options);
+    }
+    if (auto error = checkOptions(options))
+    {
+        std::cout << *error;
+        return -1;
+    }
+    if (options.elementsNr == 0)
+    {
+        // Interactive use: the number of elements was not given as an argument
+        std::string elementsText;
+        std::cout << "Please enter the number of elements to generate: ";
+        std::cin >> elementsText;
+        options.elementsNr = parseCount(elementsText);
+    }
+    if (auto error = runGeneration(workers, std::move(options), launchTime))
+    {
+        std::cout << *error;
+        return -1;
+    }
     return 0;
-}
\ No newline at end of file
+}
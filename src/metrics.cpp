@@ -0,0 +1,150 @@
+#include "metrics.h"
+
+#include <format>
+
+namespace core
+{
+
+namespace
+{
+
+/**
+ * @brief Writes one line of the summary table.
+ */
+void printRow(std::ostream& out, const char* stage, const LatencyHistogram& histogram)
+{
+    out << std::format("{:<16}{:>12}{:>12}{:>12}{:>12}{:>12}{:>12}\n", stage, histogram.count(),
+                       histogram.percentile(50), histogram.percentile(90),
+                       histogram.percentile(99), histogram.percentile(99.9), histogram.max());
+}
+
+/**
+ * @brief Returns part / total in percent, 0 if total is 0.
+ */
+double percentOf(uint64_t part, uint64_t total)
+{
+    return total == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+}
+
+}  // namespace
+
+Metrics::Metrics(size_t elements)
+    : m_probes(elements / kProbeStride + 1), m_startTime(std::chrono::steady_clock::now())
+{
+}
+
+Metrics::~Metrics()
+{
+    stopSampling();
+}
+
+ThreadMetrics& Metrics::registerThread()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threads.push_back(std::make_unique<ThreadMetrics>());
+    return *m_threads.back();
+}
+
+std::unique_ptr<ThreadMetrics> Metrics::total() const
+{
+    auto total = std::make_unique<ThreadMetrics>();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& thread : m_threads)
+    {
+        total->m_enqueueWait.merge(thread->m_enqueueWait);
+        total->m_residency.merge(thread->m_residency);
+        total->m_acceptLatency.merge(thread->m_acceptLatency);
+        total->m_pushes.add(thread->m_pushes.value());
+        total->m_pushFailures.add(thread->m_pushFailures.value());
+        total->m_pops.add(thread->m_pops.value());
+        total->m_emptyPops.add(thread->m_emptyPops.value());
+        total->m_accepted.add(thread->m_accepted.value());
+        total->m_duplicates.add(thread->m_duplicates.value());
+        total->m_filtered.add(thread->m_filtered.value());
+    }
+    return total;
+}
+
+void Metrics::printSummary(std::ostream& out) const
+{
+    const auto total = this->total();
+
+    out << std::format("{:<16}{:>12}{:>12}{:>12}{:>12}{:>12}{:>12}\n", "Stage (ns)", "count",
+                       "p50", "p90", "p99", "p99.9", "max");
+    printRow(out, "enqueue wait", total->m_enqueueWait);
+    printRow(out, "queue residency", total->m_residency);
+    printRow(out, "accept latency", total->m_acceptLatency);
+
+    const uint64_t pushAttempts = total->m_pushes.value() + total->m_pushFailures.value();
+    const uint64_t popAttempts = total->m_pops.value() + total->m_emptyPops.value();
+    out << std::format("Pushes: {}, push failures: {} ({:.1f}% of attempts).\n",
+                       total->m_pushes.value(), total->m_pushFailures.value(),
+                       percentOf(total->m_pushFailures.value(), pushAttempts));
+    out << std::format("Pops: {}, empty pops: {} ({:.1f}% of attempts).\n",
+                       total->m_pops.value(), total->m_emptyPops.value(),
+                       percentOf(total->m_emptyPops.value(), popAttempts));
+    out << std::format("Accepted: {}, duplicates: {} ({:.1f}% of pops rejected).\n",
+                       total->m_accepted.value(), total->m_duplicates.value(),
+                       percentOf(total->m_duplicates.value(), total->m_pops.value()));
+    // Every filtered draw is a push and a pop saved
+    out << std::format("Filtered by producers: {} ({:.1f}% of the draws kept out of the queue).\n",
+                       total->m_filtered.value(),
+                       percentOf(total->m_filtered.value(),
+                                 total->m_filtered.value() + total->m_pops.value()));
+}
+
+bool Metrics::startSampling(const std::string& path, std::chrono::milliseconds interval)
+{
+    m_sampleFile.open(path, std::ios::out | std::ios::trunc);
+    if (!m_sampleFile)
+    {
+        return false;
+    }
+    m_sampleFile << "elapsed_ms,pushes,push_failures,pops,empty_pops,accepted,duplicates,"
+                    "enqueue_wait_p50_ns,enqueue_wait_p99_ns,residency_p50_ns,residency_p99_ns,"
+                    "accept_latency_p50_ns,accept_latency_p99_ns,filtered\n";
+    m_sampler = std::thread(
+        [this, interval]()
+        {
+            std::unique_lock<std::mutex> lock(m_samplingMutex);
+            while (!m_samplingCv.wait_for(lock, interval, [this]() { return m_stopSampling; }))
+            {
+                writeSample();
+            }
+            writeSample();
+        });
+    return true;
+}
+
+void Metrics::stopSampling()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_samplingMutex);
+        m_stopSampling = true;
+    }
+    m_samplingCv.notify_one();
+    if (m_sampler.joinable())
+    {
+        m_sampler.join();
+    }
+}
+
+void Metrics::writeSample()
+{
+    // The histograms are cumulative, so every line covers the run up to its time
+    const auto total = this->total();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - m_startTime)
+                             .count();
+    m_sampleFile << std::format(
+        "{},{},{},{},{},{},{},{},{},{},{},{},{},{}\n", elapsed, total->m_pushes.value(),
+        total->m_pushFailures.value(), total->m_pops.value(), total->m_emptyPops.value(),
+        total->m_accepted.value(), total->m_duplicates.value(),
+        total->m_enqueueWait.percentile(50), total->m_enqueueWait.percentile(99),
+        total->m_residency.percentile(50), total->m_residency.percentile(99),
+        total->m_acceptLatency.percentile(50), total->m_acceptLatency.percentile(99),
+        total->m_filtered.value());
+    m_sampleFile.flush();
+}
+
+}  // namespace core
@@ -0,0 +1,201 @@
+#include "output_sink.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <iterator>
+
+namespace core
+{
+
+std::optional<OutputFormat> parseOutputFormat(std::string_view name)
+{
+    if (name == "text")
+    {
+        return OutputFormat::Text;
+    }
+    if (name == "csv")
+    {
+        return OutputFormat::Csv;
+    }
+    if (name == "binary")
+    {
+        return OutputFormat::Binary;
+    }
+    if (name == "mapped")
+    {
+        return OutputFormat::Mapped;
+    }
+    if (name == "quiet")
+    {
+        return OutputFormat::Quiet;
+    }
+    return std::nullopt;
+}
+
+OutputSink::Writer::Writer(OutputSink& sink) : m_sink(&sink)
+{
+    if (sink.format() != OutputFormat::Mapped)
+    {
+        m_buffer.reserve(kBufferSize);
+    }
+}
+
+void OutputSink::Writer::write(uint64_t number, size_t order, long long generationTime)
+{
+    if (order == 1)
+    {
+        m_sink->m_firstNumberTime.store(
+            std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    switch (m_sink->format())
+    {
+        case OutputFormat::Text:
+            std::format_to(std::back_inserter(m_buffer),
+                           "number = {:05}, order = {:05}, generation_time = {:010}\n", number,
+                           order, generationTime);
+            break;
+        case OutputFormat::Csv:
+            std::format_to(std::back_inserter(m_buffer), "{},{},{}\n", number, order,
+                           generationTime);
+            break;
+        case OutputFormat::Binary:
+        {
+            const BinaryRecord record{static_cast<int32_t>(number), static_cast<uint32_t>(order),
+                                      static_cast<int64_t>(generationTime)};
+            const size_t size = m_buffer.size();
+            m_buffer.resize(size + sizeof(record));
+            std::memcpy(&m_buffer[size], &record, sizeof(record));
+            break;
+        }
+        case OutputFormat::Mapped:
+            m_sink->m_file->record(number, order, generationTime);
+            return;
+        case OutputFormat::Quiet:
+            return;
+    }
+    if (m_buffer.size() >= kBufferSize)
+    {
+        flush();
+    }
+}
+
+void OutputSink::Writer::flush()
+{
+    if (m_buffer.empty())
+    {
+        return;
+    }
+    m_buffer = m_sink->submit(std::move(m_buffer));
+}
+
+std::optional<std::chrono::steady_clock::time_point> OutputSink::firstNumberTime() const noexcept
+{
+    const int64_t ticks = m_firstNumberTime.load(std::memory_order_relaxed);
+    if (ticks == 0)
+    {
+        return std::nullopt;
+    }
+    return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(ticks));
+}
+
+OutputSink::OutputSink(OutputFormat format, int fd, bool writeHeader)
+    : m_format(format), m_fd(fd), m_pending(kMaxPendingBuffers)
+{
+    m_free.reserve(kMaxPendingBuffers);
+    if (m_format == OutputFormat::Csv && writeHeader)
+    {
+        const std::string_view header = "number,order,generation_time\n";
+        pushPending(std::vector<char>(header.begin(), header.end()));
+    }
+    m_thread = std::thread([this]() { run(); });
+}
+
+OutputSink::OutputSink(MappedResultFile& file)
+    : m_format(OutputFormat::Mapped), m_fd(-1), m_file(&file)
+{
+}
+
+void OutputSink::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+std::vector<char> OutputSink::submit(std::vector<char> buffer)
+{
+    std::vector<char> empty;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_roomCv.wait(lock, [this]() { return m_pendingCount < kMaxPendingBuffers; });
+        pushPending(std::move(buffer));
+        if (!m_free.empty())
+        {
+            empty = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+    m_cv.notify_one();
+    empty.clear();
+    empty.reserve(kBufferSize);
+    return empty;
+}
+
+void OutputSink::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this]() { return m_stopping || m_pendingCount != 0; });
+        if (m_pendingCount == 0)
+        {
+            // Stopping and everything is written
+            return;
+        }
+        std::vector<char> buffer = std::move(m_pending[m_pendingHead]);
+        m_pendingHead = (m_pendingHead + 1) % kMaxPendingBuffers;
+        --m_pendingCount;
+        m_roomCv.notify_all();
+
+        lock.unlock();
+        writeAll(buffer);
+        lock.lock();
+        m_free.push_back(std::move(buffer));
+    }
+}
+
+void OutputSink::pushPending(std::vector<char> buffer)
+{
+    m_pending[(m_pendingHead + m_pendingCount) % kMaxPendingBuffers] = std::move(buffer);
+    ++m_pendingCount;
+}
+
+void OutputSink::writeAll(const std::vector<char>& buffer)
+{
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        const ssize_t result = ::write(m_fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // The output is gone (closed pipe, full disk): drop the buffer
+            return;
+        }
+        written += static_cast<size_t>(result);
+    }
+}
+
+}  // namespace core
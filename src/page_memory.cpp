@@ -0,0 +1,74 @@
+#include "page_memory.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+namespace core
+{
+
+namespace
+{
+
+/**
+ * @brief Rounds a size up to a multiple of a power of two.
+ */
+[[nodiscard]] size_t roundUp(size_t size, size_t multiple)
+{
+    return (size + multiple - 1) & ~(multiple - 1);
+}
+
+}  // namespace
+
+size_t PageMemoryResource::pageSize() noexcept
+{
+    static const auto size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+void* PageMemoryResource::do_allocate(size_t bytes, size_t alignment)
+{
+    if (alignment > pageSize())
+    {
+        throw std::bad_alloc();
+    }
+    const size_t size = roundUp(bytes, pageSize());
+    const bool huge = m_hugePages && size >= kHugePageSize;
+    // Huge blocks are mapped with a huge page of slack, trimmed to an aligned range below
+    const size_t mapped = huge ? size + kHugePageSize : size;
+    void* data = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    if (!huge)
+    {
+        return data;
+    }
+
+    const auto start = reinterpret_cast<uintptr_t>(data);
+    const uintptr_t aligned = roundUp(start, kHugePageSize);
+    if (aligned != start)
+    {
+        ::munmap(data, aligned - start);
+    }
+    const size_t tail = start + mapped - (aligned + size);
+    if (tail != 0)
+    {
+        ::munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+#ifdef MADV_HUGEPAGE
+    // Only advice: without transparent huge pages the block stays on small pages
+    ::madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<void*>(aligned);
+}
+
+void PageMemoryResource::do_deallocate(void* pointer, size_t bytes, size_t /*alignment*/)
+{
+    ::munmap(pointer, roundUp(bytes, pageSize()));
+}
+
+}  // namespace core
@@ -0,0 +1,30 @@
+#include "permutation_worker.h"
+
+#include <iostream>
+
+#include "current_time.h"
+
+void PermutationWorker::generate()
+{
+    long long lastTime = core::getCurrentTimeInMicroseconds();
+    for (uint64_t index = m_first; index < m_last; ++index)
+    {
+        const uint64_t randValue = (*m_permutation)(index) + 1;
+
+        // Calculate time it took to generate the value
+        const auto endTime = core::getCurrentTimeInMicroseconds();
+        const auto timeTaken = endTime - lastTime;
+
+        // Every number is emitted exactly once, the bitset is only kept up to date
+        if (m_storage != nullptr)
+        {
+            (void)m_storage->tryMark(randValue);
+            m_storage->record(randValue, index + 1, timeTaken);
+        }
+
+        m_writer.write(randValue, index + 1, timeTaken);
+        lastTime = core::getCurrentTimeInMicroseconds();
+    }
+    m_writer.flush();
+    std::cout << "Permutation worker finished task.\n";
+}
@@ -1,18 +1,183 @@
 #include "producer.h"
 
+#include <algorithm>
 #include <iostream>
+#include <span>
 #include <thread>
+#include <vector>
 
-void Producer::produce()
+template <typename Queue>
+void Producer<Queue>::produce()
 {
-    while (!m_completed->load())
+    if constexpr (core::BlockingQueueType<Queue>)
     {
-        if (!m_queue->tryPush(m_distribution(m_generator)))
+        // push() parks the thread while the queue is full and fails once the queue is closed.
+        while (!m_completion.done() && !remainingActive())
         {
-            // If the queue is full and the push operation fails, yield the current thread
-            // to allow other threads to run.
-            std::this_thread::yield();
+            const value_type value = m_random.next<value_type>();
+            onDrawn(value);
+            if (filterOut(value))
+            {
+                continue;
+            }
+            if (!pushWaiting(value))
+            {
+                break;
+            }
         }
     }
+    else if (m_batchSize > 1)
+    {
+        produceBatches();
+    }
+    else
+    {
+        uint64_t waitStart = 0;
+        while (!m_completion.done() && !remainingActive())
+        {
+            const value_type value = m_random.next<value_type>();
+            onDrawn(value);
+            if (filterOut(value))
+            {
+                continue;
+            }
+            if (m_queue->tryPush(value))
+            {
+                if (m_threadMetrics != nullptr)
+                {
+                    m_metrics->onPushed(*m_threadMetrics, std::span<const value_type>(&value, 1),
+                                        waitStart);
+                    waitStart = 0;
+                }
+            }
+            else
+            {
+                waitStart = onPushFailed(waitStart);
+                // If the queue is full and the push operation fails, yield the current thread
+                // to allow other threads to run.
+                std::this_thread::yield();
+            }
+        }
+    }
+    if (!m_completion.doneNow() && remainingActive())
+    {
+        produceRemaining();
+    }
     std::cout << "Producer finished task.\n";
-}
\ No newline at end of file
+}
+
+template <typename Queue>
+void Producer<Queue>::produceBatches()
+{
+    std::span<value_type> batch(m_batch);
+    uint64_t waitStart = 0;
+    while (!m_completion.doneNow() && !remainingActive())
+    {
+        m_random.fill(batch);
+        size_t kept = 0;
+        for (const value_type value : batch)
+        {
+            onDrawn(value);
+            if (!filterOut(value))
+            {
+                batch[kept++] = value;
+            }
+        }
+
+        std::span<const value_type> pending = batch.first(kept);
+        while (!pending.empty() && !m_completion.done())
+        {
+            const size_t pushed = m_queue->tryPushBulk(pending);
+            if (pushed == 0)
+            {
+                waitStart = onPushFailed(waitStart);
+                // The queue is full, let the consumers drain it.
+                std::this_thread::yield();
+            }
+            else if (m_threadMetrics != nullptr)
+            {
+                m_metrics->onPushed(*m_threadMetrics, pending.first(pushed), waitStart);
+                waitStart = 0;
+            }
+            pending = pending.subspan(pushed);
+        }
+    }
+}
+
+template <typename Queue>
+void Producer<Queue>::produceRemaining()
+{
+    // Unlike uniform draws, these values must not be dropped when the queue is full
+    const std::vector<uint64_t> slice = m_remaining->takeSlice();
+    const std::vector<value_type> values(slice.begin(), slice.end());
+    std::span<const value_type> pending(values);
+    uint64_t waitStart = 0;
+    while (!pending.empty() && !m_completion.doneNow())
+    {
+        size_t pushed = 0;
+        if constexpr (core::BlockingQueueType<Queue>)
+        {
+            if (!pushWaiting(pending.front()))
+            {
+                break;
+            }
+            pushed = 1;
+        }
+        else
+        {
+            pushed = m_queue->tryPushBulk(pending.first(std::min(pending.size(), m_batchSize)));
+            if (pushed == 0)
+            {
+                waitStart = onPushFailed(waitStart);
+                std::this_thread::yield();
+                continue;
+            }
+            if (m_threadMetrics != nullptr)
+            {
+                m_metrics->onPushed(*m_threadMetrics, pending.first(pushed), waitStart);
+                waitStart = 0;
+            }
+        }
+        m_draws += pushed;
+        pending = pending.subspan(pushed);
+    }
+}
+
+template <typename Queue>
+bool Producer<Queue>::pushWaiting(value_type value)
+    requires core::BlockingQueueType<Queue>
+{
+    if (m_threadMetrics == nullptr)
+    {
+        return m_queue->push(value);
+    }
+    uint64_t waitStart = 0;
+    if (!m_queue->tryPush(value))
+    {
+        waitStart = onPushFailed(waitStart);
+        if (!m_queue->push(value))
+        {
+            return false;
+        }
+    }
+    m_metrics->onPushed(*m_threadMetrics, std::span<const value_type>(&value, 1), waitStart);
+    return true;
+}
+
+template <typename Queue>
+uint64_t Producer<Queue>::onPushFailed(uint64_t waitStart)
+{
+    if (m_threadMetrics == nullptr)
+    {
+        return 0;
+    }
+    m_threadMetrics->m_pushFailures.add(1);
+    return waitStart != 0 ? waitStart : core::Metrics::now();
+}
+
+template class Producer<core::ThreadSafeQueue<int>>;
+template class Producer<core::LockFreeQueue<int>>;
+template class Producer<core::BlockingQueue<int>>;
+template class Producer<core::ThreadSafeQueue<uint64_t>>;
+template class Producer<core::LockFreeQueue<uint64_t>>;
+template class Producer<core::BlockingQueue<uint64_t>>;
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "random_source.h"
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace core
+{
+
+namespace
+{
+
+/**
+ * @brief Steps the four lanes of a Xoshiro256x4 with plain code.
+ *
+ * @param state State word i of lane j.
+ * @param values The buffer receiving the outputs, lane by lane.
+ */
+void fillLanes(std::array<std::array<uint64_t, Xoshiro256x4::kLanes>, 4>& state,
+               std::span<uint64_t> values) noexcept
+{
+    for (size_t i = 0; i < values.size(); i += Xoshiro256x4::kLanes)
+    {
+        for (size_t lane = 0; lane < Xoshiro256x4::kLanes; ++lane)
+        {
+            const uint64_t result = std::rotl(state[1][lane] * 5, 7) * 9;
+            const uint64_t shifted = state[1][lane] << 17;
+            state[2][lane] ^= state[0][lane];
+            state[3][lane] ^= state[1][lane];
+            state[1][lane] ^= state[2][lane];
+            state[0][lane] ^= state[3][lane];
+            state[2][lane] ^= shifted;
+            state[3][lane] = std::rotl(state[3][lane], 45);
+            if (i + lane < values.size())
+            {
+                values[i + lane] = result;
+            }
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * @brief Rotates the 64-bit lanes of a vector left.
+ */
+template <int Bits>
+__attribute__((target("avx2"))) __m256i rotl256(__m256i value) noexcept
+{
+    return _mm256_or_si256(_mm256_slli_epi64(value, Bits), _mm256_srli_epi64(value, 64 - Bits));
+}
+
+/**
+ * @brief Steps the four lanes of a Xoshiro256x4 in AVX2 registers.
+ *
+ * AVX2 has no 64-bit multiplication, but the multiplications by 5 and 9
+ * of xoshiro256** are a shift and an addition.
+ *
+ * @param state State word i of lane j.
+ * @param values The buffer receiving the outputs, lane by lane.
+ */
+__attribute__((target("avx2"))) void fillLanesAvx2(
+    std::array<std::array<uint64_t, Xoshiro256x4::kLanes>, 4>& state,
+    std::span<uint64_t> values) noexcept
+{
+    __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[0].data()));
+    __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[1].data()));
+    __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[2].data()));
+    __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[3].data()));
+
+    for (size_t i = 0; i < values.size(); i += Xoshiro256x4::kLanes)
+    {
+        const __m256i times5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+        const __m256i rotated = rotl256<7>(times5);
+        const __m256i result = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+        const __m256i shifted = _mm256_slli_epi64(s1, 17);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, shifted);
+        s3 = rotl256<45>(s3);
+
+        if (i + Xoshiro256x4::kLanes <= values.size())
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&values[i]), result);
+        }
+        else
+        {
+            // Partial tail, the outputs past the end are dropped
+            alignas(32) std::array<uint64_t, Xoshiro256x4::kLanes> tail{};
+            _mm256_store_si256(reinterpret_cast<__m256i*>(tail.data()), result);
+            std::copy_n(tail.begin(), values.size() - i, values.begin() + i);
+        }
+    }
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(state[0].data()), s0);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(state[1].data()), s1);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(state[2].data()), s2);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(state[3].data()), s3);
+}
+
+#endif
+
+/**
+ * @brief Returns the start of a stream of a seed of xoshiro256**.
+ *
+ * @param seed The seed.
+ * @param stream The index of the stream, i.e. the number of jumps.
+ */
+Xoshiro256StarStar xoshiroStream(uint64_t seed, uint64_t stream) noexcept
+{
+    Xoshiro256StarStar generator(seed);
+    for (uint64_t i = 0; i < stream; ++i)
+    {
+        generator.jump();
+    }
+    return generator;
+}
+
+}  // namespace
+
+Xoshiro256x4::Xoshiro256x4(uint64_t seed, uint64_t stream) noexcept
+{
+    Xoshiro256StarStar generator = xoshiroStream(seed, stream * kLanes);
+    for (size_t lane = 0; lane < kLanes; ++lane)
+    {
+        for (size_t word = 0; word < m_state.size(); ++word)
+        {
+            m_state[word][lane] = generator.state()[word];
+        }
+        generator.jump();
+    }
+}
+
+void Xoshiro256x4::fill(std::span<uint64_t> values) noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2") != 0;
+    if (hasAvx2)
+    {
+        fillLanesAvx2(m_state, values);
+        return;
+    }
+#endif
+    fillLanes(m_state, values);
+}
+
+std::optional<RandomEngine> parseRandomEngine(std::string_view name)
+{
+    if (name == "std")
+    {
+        return RandomEngine::Standard;
+    }
+    if (name == "xoshiro")
+    {
+        return RandomEngine::Xoshiro256;
+    }
+    if (name == "pcg")
+    {
+        return RandomEngine::Pcg64;
+    }
+    if (name == "simd")
+    {
+        return RandomEngine::Xoshiro256x4;
+    }
+    if (name == "philox")
+    {
+        return RandomEngine::Philox;
+    }
+    return std::nullopt;
+}
+
+RandomSource::RandomSource(RandomEngine engine,
+                           uint64_t elements,
+                           uint64_t seed,
+                           uint64_t stream)
+    : m_elements(elements)
+    , m_range(static_cast<uint32_t>(std::min<uint64_t>(elements, UINT32_MAX)))
+    , m_threshold((0U - m_range) % m_range)
+    , m_wideThreshold((0 - elements) % elements)
+    , m_engine(StandardEngine{})
+{
+    switch (engine)
+    {
+        case RandomEngine::Standard:
+        {
+            // One seed per stream, derived from the seed of the run so that runs can be replayed
+            const auto intElements = static_cast<int>(std::min<uint64_t>(elements, INT_MAX));
+            uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+            m_engine = StandardEngine{
+                std::default_random_engine(static_cast<uint32_t>(splitMix64(state))),
+                std::uniform_int_distribution<int>(1, intElements)};
+            break;
+        }
+        case RandomEngine::Xoshiro256:
+            m_engine = xoshiroStream(seed, stream);
+            break;
+        case RandomEngine::Pcg64:
+            m_engine = Pcg64(seed, stream);
+            break;
+        case RandomEngine::Xoshiro256x4:
+            m_engine = Xoshiro256x4(seed, stream);
+            break;
+        case RandomEngine::Philox:
+            m_engine = Philox4x32(seed, stream);
+            break;
+    }
+}
+
+template <typename Generate>
+void RandomSource::fillBounded(std::span<int> values, Generate generate)
+{
+    constexpr size_t kLanes = Xoshiro256x4::kLanes;
+    size_t filled = 0;
+    while (filled < values.size())
+    {
+        // Two numbers per raw output, rounded up to whole vectors of lanes
+        const size_t wanted = (values.size() - filled + 1) / 2;
+        const size_t words = std::min(m_raw.size(), (wanted + kLanes - 1) / kLanes * kLanes);
+        const std::span<uint64_t> raw(m_raw.data(), words);
+        generate(raw);
+
+        // Lemire: the high half of sample * range is uniform in 0..range-1 once the few
+        // samples whose low half falls below the threshold are rejected.
+        if (2 * words <= values.size() - filled)
+        {
+            // Every sample fits, so write unconditionally and only advance on acceptance
+            for (uint64_t word : raw)
+            {
+                for (const uint64_t sample : {word & uint64_t{0xFFFFFFFF}, word >> 32})
+                {
+                    const uint64_t product = sample * m_range;
+                    values[filled] = static_cast<int>(product >> 32) + 1;
+                    filled += static_cast<uint32_t>(product) >= m_threshold ? 1 : 0;
+                }
+            }
+            continue;
+        }
+        for (size_t i = 0; i < 2 * words && filled < values.size(); ++i)
+        {
+            const uint64_t sample = (raw[i / 2] >> (32 * (i % 2))) & uint64_t{0xFFFFFFFF};
+            const uint64_t product = sample * m_range;
+            if (static_cast<uint32_t>(product) >= m_threshold)
+            {
+                values[filled++] = static_cast<int>(product >> 32) + 1;
+            }
+        }
+    }
+}
+
+template <typename Generate>
+void RandomSource::fillBoundedWide(std::span<uint64_t> values, Generate generate)
+{
+    size_t filled = 0;
+    while (filled < values.size())
+    {
+        const size_t words = std::min(m_raw.size(), values.size() - filled);
+        const std::span<uint64_t> raw(m_raw.data(), words);
+        generate(raw);
+
+        // Lemire over 64 bits: the high half of the 128-bit product is the number
+        for (const uint64_t sample : raw)
+        {
+            const unsigned __int128 product = static_cast<unsigned __int128>(sample) * m_elements;
+            if (static_cast<uint64_t>(product) >= m_wideThreshold)
+            {
+                values[filled++] = static_cast<uint64_t>(product >> 64) + 1;
+            }
+        }
+    }
+}
+
+void RandomSource::fill(std::span<int> values)
+{
+    std::visit(
+        [this, values](auto& engine)
+        {
+            using Engine = std::decay_t<decltype(engine)>;
+            if constexpr (std::is_same_v<Engine, StandardEngine>)
+            {
+                std::generate(values.begin(), values.end(),
+                              [&engine]() { return engine.m_distribution(engine.m_generator); });
+            }
+            else if constexpr (std::is_same_v<Engine, Xoshiro256x4>)
+            {
+                fillBounded(values, [&engine](std::span<uint64_t> raw) { engine.fill(raw); });
+            }
+            else
+            {
+                fillBounded(values, [&engine](std::span<uint64_t> raw)
+                            { std::generate(raw.begin(), raw.end(), std::ref(engine)); });
+            }
+        },
+        m_engine);
+}
+
+void RandomSource::fill(std::span<uint64_t> values)
+{
+    std::visit(
+        [this, values](auto& engine)
+        {
+            using Engine = std::decay_t<decltype(engine)>;
+            if constexpr (std::is_same_v<Engine, StandardEngine>)
+            {
+                std::uniform_int_distribution<uint64_t> distribution(1, m_elements);
+                std::generate(values.begin(), values.end(),
+                              [&]() { return distribution(engine.m_generator); });
+            }
+            else if constexpr (std::is_same_v<Engine, Xoshiro256x4>)
+            {
+                fillBoundedWide(values, [&engine](std::span<uint64_t> raw) { engine.fill(raw); });
+            }
+            else
+            {
+                fillBoundedWide(values, [&engine](std::span<uint64_t> raw)
+                                { std::generate(raw.begin(), raw.end(), std::ref(engine)); });
+            }
+        },
+        m_engine);
+}
+
+}  // namespace core
@@ -0,0 +1,50 @@
+#include "remaining_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace core
+{
+
+RemainingSampler::RemainingSampler(const NumberStorage& storage,
+                                   size_t producersNr,
+                                   double missRate,
+                                   uint64_t seed)
+    : m_storage(&storage)
+    , m_producersNr(std::max<size_t>(producersNr, 1))
+    , m_missThreshold(static_cast<unsigned>(std::ceil(std::clamp(missRate, 0.0, 1.0) * kWindow)))
+    , m_seed(seed)
+{
+}
+
+void RemainingSampler::activate()
+{
+    std::call_once(m_once,
+                   [this]()
+                   {
+                       std::vector<uint64_t> missing = m_storage->unmarked();
+                       std::mt19937_64 generator(m_seed);
+                       std::shuffle(missing.begin(), missing.end(), generator);
+
+                       m_slices.resize(m_producersNr);
+                       for (size_t i = 0; i < missing.size(); ++i)
+                       {
+                           m_slices[i % m_producersNr].push_back(missing[i]);
+                       }
+                       m_active.store(true, std::memory_order_release);
+                   });
+}
+
+std::vector<uint64_t> RemainingSampler::takeSlice()
+{
+    activate();
+    const size_t slice = m_nextSlice.fetch_add(1, std::memory_order_relaxed);
+    if (slice >= m_slices.size())
+    {
+        return {};
+    }
+    return std::move(m_slices[slice]);
+}
+
+}  // namespace core
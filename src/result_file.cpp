@@ -0,0 +1,196 @@
+#include "result_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <format>
+#include <numeric>
+#include <vector>
+
+namespace core
+{
+
+namespace
+{
+
+/// Magic bytes at the start of a result file.
+constexpr char kMagic[8] = {'R', 'N', 'D', 'S', 'E', 'Q', '\0', '\0'};
+
+/**
+ * @brief Checks that an array of a header lies within a file.
+ *
+ * @param offset The offset of the array.
+ * @param bytes The size of the array.
+ * @param fileSize The size of the file.
+ */
+[[nodiscard]] bool fits(uint64_t offset, uint64_t bytes, uint64_t fileSize)
+{
+    return offset >= sizeof(ResultFileHeader) && offset <= fileSize &&
+           bytes <= fileSize - offset;
+}
+
+}  // namespace
+
+std::optional<MappedResultFile> MappedResultFile::create(const std::string& path,
+                                                         size_t elements,
+                                                         bool recordTimes)
+{
+    // Header, then the sequence and the orders (4 bytes each), then the 8-byte aligned times
+    ResultFileHeader header{};
+    std::memcpy(header.m_magic, kMagic, sizeof(kMagic));
+    header.m_version = kVersion;
+    header.m_flags = recordTimes ? ResultFileHeader::kHasTimes : 0;
+    header.m_elements = elements;
+    header.m_sequenceOffset = sizeof(ResultFileHeader);
+    header.m_ordersOffset = header.m_sequenceOffset + elements * sizeof(int32_t);
+    const uint64_t ordersEnd = header.m_ordersOffset + elements * sizeof(uint32_t);
+    header.m_timesOffset = recordTimes ? ordersEnd : 0;
+    const uint64_t size = recordTimes ? ordersEnd + elements * sizeof(int64_t) : ordersEnd;
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return std::nullopt;
+    }
+    // The file is sparse until written, so pre-sizing it costs nothing
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+    std::memcpy(data, &header, sizeof(header));
+    return MappedResultFile(fd, data, size);
+}
+
+std::optional<MappedResultFile> MappedResultFile::open(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return std::nullopt;
+    }
+    struct stat status{};
+    if (::fstat(fd, &status) != 0 ||
+        static_cast<uint64_t>(status.st_size) < sizeof(ResultFileHeader))
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const auto size = static_cast<size_t>(status.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    ResultFileHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    const uint64_t elements = header.m_elements;
+    const bool hasTimes = (header.m_flags & ResultFileHeader::kHasTimes) != 0;
+    const bool valid =
+        std::memcmp(header.m_magic, kMagic, sizeof(kMagic)) == 0 &&
+        header.m_version == kVersion && elements <= size &&
+        fits(header.m_sequenceOffset, elements * sizeof(int32_t), size) &&
+        fits(header.m_ordersOffset, elements * sizeof(uint32_t), size) &&
+        (!hasTimes || (header.m_timesOffset % alignof(int64_t) == 0 &&
+                       fits(header.m_timesOffset, elements * sizeof(int64_t), size)));
+    if (!valid)
+    {
+        ::munmap(data, size);
+        ::close(fd);
+        return std::nullopt;
+    }
+    return MappedResultFile(fd, data, size);
+}
+
+MappedResultFile::MappedResultFile(int fd, void* data, size_t size)
+    : m_fd(fd), m_data(data), m_size(size), m_header(static_cast<ResultFileHeader*>(data))
+{
+    auto* bytes = static_cast<char*>(data);
+    m_sequence = reinterpret_cast<int32_t*>(bytes + m_header->m_sequenceOffset);
+    m_orders = reinterpret_cast<uint32_t*>(bytes + m_header->m_ordersOffset);
+    m_times = (m_header->m_flags & ResultFileHeader::kHasTimes) != 0
+                  ? reinterpret_cast<int64_t*>(bytes + m_header->m_timesOffset)
+                  : nullptr;
+}
+
+MappedResultFile::MappedResultFile(MappedResultFile&& other) noexcept
+    : m_fd(other.m_fd)
+    , m_data(other.m_data)
+    , m_size(other.m_size)
+    , m_header(other.m_header)
+    , m_sequence(other.m_sequence)
+    , m_orders(other.m_orders)
+    , m_times(other.m_times)
+{
+    other.m_fd = -1;
+    other.m_data = nullptr;
+}
+
+MappedResultFile::~MappedResultFile()
+{
+    if (m_data != nullptr)
+    {
+        ::munmap(m_data, m_size);
+    }
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+}
+
+void MappedResultFile::finish(size_t emitted) noexcept
+{
+    m_header->m_emitted = emitted;
+}
+
+std::optional<std::string> MappedResultFile::verify() const
+{
+    const size_t elementsNr = elements();
+    if (emitted() != elementsNr)
+    {
+        return std::format("{} of {} numbers emitted", emitted(), elementsNr);
+    }
+
+    std::vector<bool> seen(elementsNr);
+    for (size_t position = 0; position < elementsNr; ++position)
+    {
+        const int32_t number = m_sequence[position];
+        if (number < 1 || static_cast<size_t>(number) > elementsNr)
+        {
+            return std::format("number {} at order {} is out of range", number, position + 1);
+        }
+        const auto index = static_cast<size_t>(number - 1);
+        if (seen[index])
+        {
+            return std::format("number {} emitted twice, again at order {}", number,
+                               position + 1);
+        }
+        seen[index] = true;
+        if (m_orders[index] != position + 1)
+        {
+            return std::format("number {} at order {} has order {}", number, position + 1,
+                               m_orders[index]);
+        }
+    }
+    // N distinct numbers in 1..N: every number is there
+    return std::nullopt;
+}
+
+long long MappedResultFile::totalGenerationTime() const noexcept
+{
+    const auto values = times();
+    return std::accumulate(values.begin(), values.end(), 0LL);
+}
+
+}  // namespace core
@@ -0,0 +1,120 @@
+#include "sharded_pipeline.h"
+
+#include <algorithm>
+#include <iostream>
+#include <span>
+#include <thread>
+
+#include "current_time.h"
+
+ShardedQueues::ShardedQueues(size_t producers, size_t consumers, size_t capacity)
+    : m_producersNr(producers), m_consumersNr(consumers), m_shardDone(consumers)
+{
+    m_queues.reserve(producers * consumers);
+    for (size_t i = 0; i < producers * consumers; ++i)
+    {
+        m_queues.push_back(std::make_unique<core::SpscQueue<int>>(capacity));
+    }
+}
+
+size_t ShardedQueues::shardSize(size_t consumer, size_t elements) const noexcept
+{
+    const size_t groups = (elements + kGroupSize - 1) / kGroupSize;
+    const size_t ownedGroups = groups / m_consumersNr + (consumer < groups % m_consumersNr ? 1 : 0);
+    size_t values = ownedGroups * kGroupSize;
+    if (groups > 0 && (groups - 1) % m_consumersNr == consumer)
+    {
+        // The last group may be partial
+        values -= groups * kGroupSize - elements;
+    }
+    return values;
+}
+
+bool ShardedQueues::markShardDone(size_t consumer)
+{
+    m_shardDone[consumer].store(true, std::memory_order_relaxed);
+    return m_shardsDone.fetch_add(1, std::memory_order_acq_rel) + 1 == m_consumersNr;
+}
+
+void ShardedProducer::produce()
+{
+    while (!m_completion.done())
+    {
+        const int randValue = m_random.next();
+        const size_t shard = m_queues->shardOf(randValue);
+        if (m_queues->isShardDone(shard))
+        {
+            // Every value of this shard is already generated, no need to send it
+            continue;
+        }
+        if (!m_queues->queue(m_index, shard).tryPush(randValue))
+        {
+            // The consumer lags behind, let it run.
+            std::this_thread::yield();
+        }
+    }
+    std::cout << "Sharded producer finished task.\n";
+}
+
+void ShardedConsumer::consume()
+{
+    std::vector<int> batch(m_batchSize);
+    m_lastTime = core::getCurrentTimeInMicroseconds();
+
+    while (m_remaining > 0 && !m_completion.done())
+    {
+        bool idle = true;
+        for (size_t producer = 0; producer < m_queues->producersNr() && m_remaining > 0;
+             ++producer)
+        {
+            auto& queue = m_queues->queue(producer, m_index);
+            const size_t popped = queue.tryPopBulk(std::span<int>(batch));
+            for (size_t i = 0; i < popped && m_remaining > 0; ++i)
+            {
+                accept(batch[i]);
+            }
+            idle = idle && popped == 0;
+        }
+        if (idle)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    m_writer.flush();
+    if (m_queues->markShardDone(m_index))
+    {
+        // All the shards are complete
+        m_completed->store(true);
+    }
+    std::cout << "Sharded consumer finished task.\n";
+}
+
+void ShardedConsumer::accept(int randValue)
+{
+    // Only this consumer receives the values of its shard, so it alone writes their bitset lines
+    if (!m_storage->tryMarkOwned(randValue))
+    {
+        return;
+    }
+
+    // Calculate time it took to generate the value
+    const auto endTime = core::getCurrentTimeInMicroseconds();
+    const auto timeTaken = endTime - m_lastTime;
+
+    // Save the generated number
+    // Take a block of orders at once, no larger than the rest of the shard
+    if (m_ordersLeft == 0)
+    {
+        m_ordersLeft = std::min(kOrderBlock, m_remaining);
+        m_nextOrder = m_queues->claimOrders(m_ordersLeft);
+    }
+    const size_t order = m_nextOrder++;
+    --m_ordersLeft;
+    m_storage->record(randValue, order, timeTaken);
+
+    m_writer.write(randValue, order, timeTaken);
+
+    --m_remaining;
+    m_lastTime = core::getCurrentTimeInMicroseconds();
+}
@@ -0,0 +1,80 @@
+#include "shared_pipeline.h"
+
+#include <iostream>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "completion_poll.h"
+#include "current_time.h"
+
+void initializeSharedStartTime(core::SharedSegment& segment)
+{
+    segment.header().m_startTime = core::getCurrentTimeInMicroseconds();
+    segment.header().m_order = 0;
+    segment.header().m_totalTime = 0;
+}
+
+void produceShared(core::SharedSegment& segment, core::RandomSource random, size_t batchSize)
+{
+    core::CompletionPoll completion(segment.completed());
+    std::vector<int> batch(batchSize);
+    while (!completion.doneNow())
+    {
+        random.fill(std::span<int>(batch));
+        std::span<const int> pending(batch);
+        while (!pending.empty() && !completion.done())
+        {
+            const size_t pushed = segment.tryPushBulk(pending);
+            if (pushed == 0)
+            {
+                // The ring is full, let the consumer processes drain it.
+                std::this_thread::yield();
+            }
+            pending = pending.subspan(pushed);
+        }
+    }
+    std::cout << "Shared-memory producer finished task.\n";
+}
+
+void consumeShared(core::SharedSegment& segment, core::OutputSink& sink, size_t batchSize)
+{
+    core::SharedSegmentHeader& header = segment.header();
+    const size_t elements = segment.elements();
+    core::CompletionPoll completion(segment.completed());
+    core::OutputSink::Writer writer(sink);
+    std::vector<int> batch(batchSize);
+    long long totalTime = 0;
+    while (!completion.doneNow())
+    {
+        const size_t popped = segment.tryPopBulk(std::span<int>(batch));
+        if (popped == 0)
+        {
+            // The ring is empty, let the producer processes fill it.
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < popped; ++i)
+        {
+            const int randValue = batch[i];
+            if (!segment.tryMark(randValue))
+            {
+                continue;
+            }
+            // The clock and the order counter are shared by the consumers of all processes
+            const auto endTime = core::getCurrentTimeInMicroseconds();
+            const auto timeTaken = endTime - header.m_startTime.exchange(endTime);
+            const size_t order = header.m_order.fetch_add(1) + 1;
+            totalTime += timeTaken;
+            writer.write(static_cast<uint64_t>(randValue), order, timeTaken);
+            if (order == elements)
+            {
+                // All the numbers are generated
+                header.m_complete.store(true);
+            }
+        }
+    }
+    header.m_totalTime.fetch_add(totalTime);
+    writer.flush();
+    std::cout << "Shared-memory consumer finished task.\n";
+}
@@ -0,0 +1,267 @@
+#include "shared_segment.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace core
+{
+
+namespace
+{
+
+/// Magic bytes at the start of a shared segment.
+constexpr char kMagic[8] = {'R', 'N', 'D', 'S', 'H', 'M', '\0', '\0'};
+
+/**
+ * @brief Rounds a size up to a whole number of cache lines.
+ */
+[[nodiscard]] constexpr uint64_t alignToLine(uint64_t size)
+{
+    return (size + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+}
+
+/**
+ * @brief Returns the offset of the ring cells.
+ */
+[[nodiscard]] constexpr uint64_t cellsOffset()
+{
+    return alignToLine(sizeof(SharedSegmentHeader));
+}
+
+/**
+ * @brief Returns the number of 64-bit words of the bitset of a segment.
+ */
+[[nodiscard]] constexpr uint64_t bitWords(uint64_t elements)
+{
+    return (elements + 63) / 64;
+}
+
+}  // namespace
+
+std::optional<SharedSegment> SharedSegment::create(const std::string& name,
+                                                   size_t elements,
+                                                   size_t capacity)
+{
+    // Header, then the ring cells and the bitset, each starting on a cache line
+    const uint64_t cells = std::bit_ceil(std::max<size_t>(capacity, 2));
+    const uint64_t bitsOffset = alignToLine(cellsOffset() + cells * sizeof(Cell));
+    const uint64_t size = bitsOffset + bitWords(elements) * sizeof(uint64_t);
+
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+    {
+        return std::nullopt;
+    }
+    // A new segment is zero-filled, so the bitset starts empty
+    void* data = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0)
+    {
+        data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (data == MAP_FAILED)
+    {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+
+    auto* header = new (data) SharedSegmentHeader{};
+    header->m_version = kVersion;
+    header->m_elements = elements;
+    header->m_capacity = cells;
+    header->m_size = size;
+    auto* bytes = static_cast<char*>(data);
+    auto* cell = reinterpret_cast<Cell*>(bytes + cellsOffset());
+    for (uint64_t i = 0; i < cells; ++i)
+    {
+        new (&cell[i]) Cell{{i}, 0};
+    }
+    auto* bits = reinterpret_cast<std::atomic<uint64_t>*>(bytes + bitsOffset);
+    for (uint64_t i = 0; i < bitWords(elements); ++i)
+    {
+        new (&bits[i]) std::atomic<uint64_t>(0);
+    }
+
+    // Processes opening the segment by name check the magic bytes last
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->m_magic, kMagic, sizeof(kMagic));
+    return SharedSegment(name, fd, data);
+}
+
+std::optional<SharedSegment> SharedSegment::open(const std::string& name)
+{
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+    {
+        return std::nullopt;
+    }
+    struct stat status{};
+    if (::fstat(fd, &status) != 0 ||
+        static_cast<uint64_t>(status.st_size) < sizeof(SharedSegmentHeader))
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const auto size = static_cast<size_t>(status.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    const auto* header = static_cast<const SharedSegmentHeader*>(data);
+    const uint64_t cells = header->m_capacity;
+    const bool valid =
+        std::memcmp(header->m_magic, kMagic, sizeof(kMagic)) == 0 &&
+        header->m_version == kVersion && header->m_size == size && std::has_single_bit(cells) &&
+        cells <= size && header->m_elements <= size * 8 &&
+        alignToLine(cellsOffset() + cells * sizeof(Cell)) +
+                bitWords(header->m_elements) * sizeof(uint64_t) ==
+            size;
+    if (!valid)
+    {
+        ::munmap(data, size);
+        ::close(fd);
+        return std::nullopt;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return SharedSegment(std::string(), fd, data);
+}
+
+SharedSegment::SharedSegment(std::string name, int fd, void* data)
+    : m_name(std::move(name)), m_fd(fd), m_header(static_cast<SharedSegmentHeader*>(data))
+{
+    auto* bytes = static_cast<char*>(data);
+    m_cells = reinterpret_cast<Cell*>(bytes + cellsOffset());
+    m_bits = reinterpret_cast<std::atomic<uint64_t>*>(
+        bytes + alignToLine(cellsOffset() + m_header->m_capacity * sizeof(Cell)));
+}
+
+SharedSegment::SharedSegment(SharedSegment&& other) noexcept
+    : m_name(std::move(other.m_name))
+    , m_fd(other.m_fd)
+    , m_header(other.m_header)
+    , m_cells(other.m_cells)
+    , m_bits(other.m_bits)
+{
+    other.m_name.clear();
+    other.m_fd = -1;
+    other.m_header = nullptr;
+}
+
+SharedSegment::~SharedSegment()
+{
+    if (m_header != nullptr)
+    {
+        ::munmap(m_header, m_header->m_size);
+    }
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+    if (!m_name.empty())
+    {
+        ::shm_unlink(m_name.c_str());
+    }
+}
+
+size_t SharedSegment::tryPushBulk(std::span<const int> vals) noexcept
+{
+    if (vals.empty())
+    {
+        return 0;
+    }
+    const uint64_t mask = m_header->m_capacity - 1;
+    size_t count = 0;
+    uint64_t pos = m_header->m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        const uint64_t seq = m_cells[pos & mask].m_sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<int64_t>(seq - pos);
+        if (diff < 0)
+        {
+            return 0;
+        }
+        if (diff > 0)
+        {
+            pos = m_header->m_enqueuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+        // Extend the claim over the following slots that are free for this lap as well.
+        count = 1;
+        while (count < vals.size() &&
+               m_cells[(pos + count) & mask].m_sequence.load(std::memory_order_acquire) ==
+                   pos + count)
+        {
+            ++count;
+        }
+        if (m_header->m_enqueuePos.compare_exchange_weak(pos, pos + count,
+                                                         std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        Cell& cell = m_cells[(pos + i) & mask];
+        cell.m_value = vals[i];
+        cell.m_sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return count;
+}
+
+size_t SharedSegment::tryPopBulk(std::span<int> vals) noexcept
+{
+    if (vals.empty())
+    {
+        return 0;
+    }
+    const uint64_t mask = m_header->m_capacity - 1;
+    size_t count = 0;
+    uint64_t pos = m_header->m_dequeuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        const uint64_t seq = m_cells[pos & mask].m_sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<int64_t>(seq - (pos + 1));
+        if (diff < 0)
+        {
+            return 0;
+        }
+        if (diff > 0)
+        {
+            pos = m_header->m_dequeuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+        // Extend the claim over the following slots that are already published.
+        count = 1;
+        while (count < vals.size() &&
+               m_cells[(pos + count) & mask].m_sequence.load(std::memory_order_acquire) ==
+                   pos + count + 1)
+        {
+            ++count;
+        }
+        if (m_header->m_dequeuePos.compare_exchange_weak(pos, pos + count,
+                                                         std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        Cell& cell = m_cells[(pos + i) & mask];
+        vals[i] = cell.m_value;
+        cell.m_sequence.store(pos + i + mask + 1, std::memory_order_release);
+    }
+    return count;
+}
+
+}  // namespace core
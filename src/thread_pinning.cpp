@@ -0,0 +1,216 @@
+#include "thread_pinning.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace core
+{
+
+namespace
+{
+
+/**
+ * @brief Parses a non-negative integer.
+ *
+ * @param text The text to parse.
+ * @return The parsed number, or std::nullopt if the text is not a non-negative integer.
+ */
+[[nodiscard]] std::optional<int> parseNumber(std::string_view text)
+{
+    int value = 0;
+    const char* last = std::next(text.data(), static_cast<std::ptrdiff_t>(text.size()));
+    const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+    if (text.empty() || ec != std::errc() || ptr != last || value < 0)
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/**
+ * @brief Returns the CPUs the process is allowed to run on.
+ *
+ * @return The CPU numbers, falling back to 0..hardware_concurrency-1.
+ */
+[[nodiscard]] std::vector<int> allowedCpus()
+{
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty())
+    {
+        const int count = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < count; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @brief Reads a list file from sysfs, such as /sys/devices/system/node/online.
+ *
+ * @param path The path of the file.
+ * @return The listed numbers, or an empty vector if the file is missing or invalid.
+ */
+[[nodiscard]] std::vector<int> readList(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!std::getline(file, line))
+    {
+        return {};
+    }
+    return parseCpuList(line);
+}
+
+}  // namespace
+
+std::vector<int> parseCpuList(std::string_view text)
+{
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())) != 0)
+    {
+        text.remove_suffix(1);
+    }
+    if (text.empty())
+    {
+        return {};
+    }
+
+    std::vector<int> result;
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        const size_t end = std::min(text.find(',', start), text.size());
+        const std::string_view item = text.substr(start, end - start);
+        const size_t dash = item.find('-');
+        const auto first = parseNumber(item.substr(0, dash));
+        const auto last =
+            dash == std::string_view::npos ? first : parseNumber(item.substr(dash + 1));
+        if (!first || !last || *last < *first)
+        {
+            return {};
+        }
+        for (int number = *first; number <= *last; ++number)
+        {
+            result.push_back(number);
+        }
+        start = end + 1;
+    }
+    return result;
+}
+
+std::optional<ThreadPinning> ThreadPinning::parse(std::string_view spec)
+{
+    const size_t colon = spec.find(':');
+    const std::string_view kind = spec.substr(0, colon);
+    std::vector<int> list;
+    if (colon != std::string_view::npos)
+    {
+        list = parseCpuList(spec.substr(colon + 1));
+        if (list.empty())
+        {
+            return std::nullopt;
+        }
+    }
+
+    ThreadPinning pinning;
+    if (kind == "cores")
+    {
+        for (int cpu : list.empty() ? allowedCpus() : list)
+        {
+            pinning.m_cpuSets.push_back({cpu});
+        }
+    }
+    else if (kind == "numa")
+    {
+        const std::vector<int> nodes =
+            list.empty() ? readList("/sys/devices/system/node/online") : list;
+        for (int node : nodes)
+        {
+            auto cpus =
+                readList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (cpus.empty())
+            {
+                // Unknown node, or a node without CPUs
+                return std::nullopt;
+            }
+            pinning.m_cpuSets.push_back(std::move(cpus));
+        }
+        if (pinning.m_cpuSets.empty())
+        {
+            // No NUMA information is available: treat the machine as a single node
+            pinning.m_cpuSets.push_back(allowedCpus());
+        }
+    }
+    else
+    {
+        return std::nullopt;
+    }
+    return pinning;
+}
+
+bool ThreadPinning::pinCurrentThread(size_t workerIndex) const
+{
+    if (!enabled())
+    {
+        return true;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : m_cpuSets[workerIndex % m_cpuSets.size()])
+    {
+        if (cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)workerIndex;
+    return false;
+#endif
+}
+
+std::string ThreadPinning::describe(size_t workerIndex) const
+{
+    if (!enabled())
+    {
+        return "any";
+    }
+    std::string result;
+    for (int cpu : m_cpuSets[workerIndex % m_cpuSets.size()])
+    {
+        if (!result.empty())
+        {
+            result += ',';
+        }
+        result += std::to_string(cpu);
+    }
+    return result;
+}
+
+}  // namespace core
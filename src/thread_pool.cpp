@@ -0,0 +1,60 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace core
+{
+
+ThreadPool::ThreadPool(size_t threadsNr)
+{
+    threadsNr = std::max<size_t>(threadsNr, 1);
+    m_threads.reserve(threadsNr);
+    for (size_t i = 0; i < threadsNr; ++i)
+    {
+        m_threads.emplace_back([this]() { run(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::schedule(std::coroutine_handle<> handle)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.push_back(handle);
+    }
+    m_cv.notify_one();
+}
+
+void ThreadPool::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this]() { return m_stopping || !m_ready.empty(); });
+        if (m_ready.empty())
+        {
+            // Stopping and every scheduled coroutine ran
+            return;
+        }
+        const std::coroutine_handle<> handle = m_ready.front();
+        m_ready.pop_front();
+
+        lock.unlock();
+        handle.resume();
+        lock.lock();
+    }
+}
+
+}  // namespace core
@@ -0,0 +1,165 @@
+#include "unique_numbers.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "async_queue.h"
+#include "number_storage.h"
+#include "thread_pool.h"
+
+namespace core
+{
+
+namespace
+{
+
+/**
+ * @class Pipeline
+ * @brief The stages behind uniqueNumbers(), alive while its generator runs.
+ */
+class Pipeline
+{
+   public:
+    /**
+     * @brief Starts the stages on a new pool.
+     *
+     * @param options The options of the sequence.
+     */
+    explicit Pipeline(const UniqueNumbersOptions& options)
+        : m_pool(options.m_threadsNr)
+        , m_elementsNr(options.m_elements)
+        , m_storage(options.m_elements, false, false)
+        , m_drawn(options.m_queueCapacity, m_pool)
+        , m_accepted(options.m_queueCapacity, m_pool)
+        , m_running(options.m_producersNr + options.m_consumersNr)
+    {
+        m_randoms.reserve(options.m_producersNr);
+        for (size_t i = 0; i < options.m_producersNr; ++i)
+        {
+            m_randoms.emplace_back(options.m_randomEngine, m_elementsNr, options.m_seed, i);
+        }
+        for (RandomSource& random : m_randoms)
+        {
+            produce(random).start(m_pool);
+        }
+        for (size_t i = 0; i < options.m_consumersNr; ++i)
+        {
+            consume().start(m_pool);
+        }
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /**
+     * @brief Stops the stages, waits for them to return, then stops the pool.
+     */
+    ~Pipeline()
+    {
+        m_drawn.close();
+        m_accepted.close();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_running == 0; });
+    }
+
+    /**
+     * @brief Returns the next new number, blocking until there is one.
+     *
+     * @return The number, or std::nullopt once all the numbers were returned.
+     */
+    [[nodiscard]] std::optional<uint64_t> next() { return m_accepted.popWait(); }
+
+   private:
+    /**
+     * @brief A producer stage: draws numbers until the drawn queue closes.
+     *
+     * The source lives in the pipeline rather than in the coroutine frame,
+     * which GCC does not align for its AVX2 lanes.
+     *
+     * @param random The source of random numbers of this stage.
+     */
+    Task produce(RandomSource& random)
+    {
+        // GCC 12 miscompiles a co_await in a loop condition, hence the awaits in statements
+        while (true)
+        {
+            const uint64_t value = random.next<uint64_t>();
+            if (!co_await m_drawn.push(value))
+            {
+                break;
+            }
+        }
+        onStageDone();
+    }
+
+    /**
+     * @brief A consumer stage: forwards the new numbers until all of them are found.
+     */
+    Task consume()
+    {
+        while (true)
+        {
+            const std::optional<uint64_t> value = co_await m_drawn.pop();
+            if (!value)
+            {
+                break;
+            }
+            if (!m_storage.tryMark(*value))
+            {
+                continue;
+            }
+            if (!co_await m_accepted.push(*value))
+            {
+                break;
+            }
+            if (m_acceptedNr.fetch_add(1, std::memory_order_relaxed) + 1 == m_elementsNr)
+            {
+                // The last number: stop drawing, and let the generator drain what is left
+                m_drawn.close();
+                m_accepted.close();
+            }
+        }
+        onStageDone();
+    }
+
+    /**
+     * @brief Reports the end of a stage. The stage must not touch the pipeline afterwards.
+     */
+    void onStageDone()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_running;
+        m_cv.notify_all();
+    }
+
+    ThreadPool m_pool;                      ///< Runs the stages; destroyed last.
+    uint64_t m_elementsNr;                  ///< The number of elements.
+    NumberStorage m_storage;                ///< Dedup bitset of the drawn numbers.
+    std::vector<RandomSource> m_randoms;    ///< Random sources of the producers.
+    AsyncQueue<uint64_t> m_drawn;           ///< Drawn numbers, from producers to consumers.
+    AsyncQueue<uint64_t> m_accepted;        ///< New numbers, from consumers to the generator.
+    std::atomic<uint64_t> m_acceptedNr{0};  ///< New numbers pushed so far.
+    std::mutex m_mutex;                     ///< Protects m_running.
+    std::condition_variable m_cv;           ///< Signals the end of a stage.
+    size_t m_running;                       ///< Stages that did not return yet.
+};
+
+}  // namespace
+
+Generator<uint64_t> uniqueNumbers(UniqueNumbersOptions options)
+{
+    if (options.m_elements == 0)
+    {
+        co_return;
+    }
+    Pipeline pipeline(options);
+    while (const std::optional<uint64_t> value = pipeline.next())
+    {
+        co_yield *value;
+    }
+}
+
+}  // namespace core
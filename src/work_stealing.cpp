@@ -0,0 +1,117 @@
+#include "work_stealing.h"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <thread>
+
+#include "current_time.h"
+#include "random_engines.h"
+
+WorkStealingScheduler::WorkStealingScheduler(core::NumberStorage& storage,
+                                             core::OutputSink& sink,
+                                             int elements,
+                                             core::RandomEngine engine,
+                                             uint64_t seed,
+                                             size_t workersNr)
+    : m_storage(&storage)
+    , m_elementsNr(static_cast<size_t>(elements))
+    , m_chunksNr((m_elementsNr + kChunkSize - 1) / kChunkSize)
+    , m_engine(engine)
+    , m_seed(seed)
+{
+    // Worker w starts with the contiguous chunks [w * K / W, (w + 1) * K / W)
+    m_workers.reserve(workersNr);
+    for (size_t w = 0; w < workersNr; ++w)
+    {
+        const size_t first = m_chunksNr * w / workersNr;
+        const size_t last = m_chunksNr * (w + 1) / workersNr;
+        auto worker = std::make_unique<Worker>(last - first, sink);
+        for (size_t chunk = first; chunk < last; ++chunk)
+        {
+            (void)worker->m_deque.push(chunk);
+        }
+        m_workers.push_back(std::move(worker));
+    }
+}
+
+void WorkStealingScheduler::work(size_t worker)
+{
+    Worker& self = *m_workers[worker];
+    while (true)
+    {
+        std::optional<uint64_t> chunk = self.m_deque.pop();
+        if (!chunk)
+        {
+            chunk = steal(worker);
+            if (!chunk)
+            {
+                break;
+            }
+            self.m_chunksStolen++;
+        }
+        runChunk(self, *chunk);
+        self.m_chunksRun++;
+    }
+    self.m_writer.flush();
+    std::cout << std::format("Work-stealing worker finished task: {} chunks, {} stolen.\n",
+                             self.m_chunksRun, self.m_chunksStolen);
+}
+
+std::optional<uint64_t> WorkStealingScheduler::steal(size_t thief)
+{
+    const size_t workersNr = m_workers.size();
+    while (true)
+    {
+        // Chunks are never added once the run started, so a pass finding every deque empty
+        // means there is nothing left to steal. A failed steal from a non-empty deque only
+        // lost a race with another thread, and is retried.
+        bool anyLeft = false;
+        for (size_t i = 1; i < workersNr; ++i)
+        {
+            auto& victim = m_workers[(thief + i) % workersNr]->m_deque;
+            if (auto chunk = victim.steal())
+            {
+                return chunk;
+            }
+            anyLeft = anyLeft || !victim.empty();
+        }
+        if (!anyLeft)
+        {
+            return std::nullopt;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void WorkStealingScheduler::runChunk(Worker& worker, uint64_t chunk)
+{
+    const size_t first = chunk * kChunkSize;
+    const size_t size = std::min(kChunkSize, m_elementsNr - first);
+
+    // Draw offsets in 1..size from a seed of this chunk, whichever worker runs it
+    uint64_t chunkSeed = m_seed ^ chunk;
+    core::RandomSource random(m_engine, static_cast<int>(size), core::splitMix64(chunkSeed), 0);
+
+    long long lastTime = core::getCurrentTimeInMicroseconds();
+    size_t remaining = size;
+    while (remaining > 0)
+    {
+        // A chunk spans whole bitset words, so only the worker running it marks their numbers
+        const int value = static_cast<int>(first) + random.next();
+        if (!m_storage->tryMarkOwned(value))
+        {
+            continue;
+        }
+        --remaining;
+
+        // Calculate time it took to generate the value
+        const auto endTime = core::getCurrentTimeInMicroseconds();
+        const auto timeTaken = endTime - lastTime;
+        lastTime = endTime;
+
+        const size_t order = m_order.fetch_add(1, std::memory_order_relaxed);
+        m_storage->record(value, order, timeTaken);
+        worker.m_writer.write(value, order, timeTaken);
+    }
+}
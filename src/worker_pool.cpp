@@ -0,0 +1,74 @@
+#include "worker_pool.h"
+
+#include <utility>
+
+namespace core
+{
+
+WorkerPool::~WorkerPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    for (auto& slot : m_slots)
+    {
+        slot->m_cv.notify_one();
+    }
+    for (auto& slot : m_slots)
+    {
+        slot->m_thread.join();
+    }
+}
+
+void WorkerPool::start(std::function<void()> work)
+{
+    Slot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_started == m_slots.size())
+        {
+            // The round needs one more thread than any round before
+            Slot& added = *m_slots.emplace_back(std::make_unique<Slot>());
+            added.m_thread = std::thread([this, &added]() { run(added); });
+        }
+        slot = m_slots[m_started].get();
+        slot->m_work = std::move(work);
+        ++m_started;
+        ++m_running;
+    }
+    slot->m_cv.notify_one();
+}
+
+void WorkerPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this]() { return m_running == 0; });
+    m_started = 0;
+}
+
+void WorkerPool::run(Slot& slot)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        slot.m_cv.wait(lock, [this, &slot]() { return m_stopping || slot.m_work; });
+        if (!slot.m_work)
+        {
+            // Stopping, and the last round is over
+            return;
+        }
+        const std::function<void()> work = std::exchange(slot.m_work, nullptr);
+
+        lock.unlock();
+        work();
+        lock.lock();
+        if (--m_running == 0)
+        {
+            m_doneCv.notify_all();
+        }
+    }
+}
+
+}  // namespace core
@@ -0,0 +1,141 @@
+#pragma once
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "consumer.h"
+#include "metrics.h"
+#include "number_storage.h"
+#include "output_sink.h"
+#include "producer.h"
+#include "random_source.h"
+#include "remaining_sampler.h"
+
+/**
+ * @struct PipelineSetup
+ * @brief Options of a test pipeline of producers and consumers over a shared queue.
+ */
+struct PipelineSetup
+{
+    size_t m_capacity = 1000;                       ///< Capacity of the queue.
+    uint64_t m_seed = 3;                            ///< Seed of the producers' random streams.
+    size_t m_workersNr = 2;                         ///< Number of producers, and of consumers.
+    size_t m_batchSize = 1;                         ///< Batch size of the producers and consumers.
+    bool m_staggeredBatches = false;                ///< Give worker i a batch of m_batchSize + i.
+    core::Metrics* m_metrics = nullptr;             ///< Metrics the workers record into, if any.
+    core::RemainingSampler* m_remaining = nullptr;  ///< Sampler of the producers, if any.
+    bool m_prefilter = false;                       ///< Producers drop the draws already generated.
+};
+
+/**
+ * @class TestPipeline
+ * @brief Producers and consumers generating 1..N over a shared queue, as main runs them.
+ *
+ * Writes the numbers to a Quiet sink and keeps them in a storage that the
+ * test can inspect once the run is joined.
+ *
+ * @tparam Queue The queue type shared by the producers and consumers.
+ */
+template <typename Queue>
+class TestPipeline
+{
+   public:
+    /**
+     * @brief Constructs the queue, the storage and the workers of a run.
+     *
+     * @param elements The number of elements to generate.
+     * @param setup The options of the run.
+     * @param storage Pointer to the storage to record into, or nullptr to use one of its own.
+     */
+    TestPipeline(int elements, const PipelineSetup& setup, core::NumberStorage* storage = nullptr)
+        : m_queue(setup.m_capacity)
+        , m_ownStorage(storage == nullptr ? static_cast<size_t>(elements) : 0)
+        , m_storage(storage == nullptr ? &m_ownStorage : storage)
+        , m_sink(core::OutputFormat::Quiet, STDOUT_FILENO)
+    {
+        Consumer<Queue>::setStartTime();
+        m_producers.reserve(setup.m_workersNr);
+        m_consumers.reserve(setup.m_workersNr);
+        for (uint64_t i = 0; i < setup.m_workersNr; ++i)
+        {
+            const size_t batchSize = setup.m_batchSize + (setup.m_staggeredBatches ? i : 0);
+            const core::RandomSource random(core::RandomEngine::Xoshiro256, elements, setup.m_seed,
+                                            i);
+            m_producers.emplace_back(m_queue, random, m_completed, batchSize, setup.m_metrics,
+                                     setup.m_remaining, setup.m_prefilter ? m_storage : nullptr);
+            m_consumers.emplace_back(m_queue, *m_storage, m_sink, elements, m_completed, batchSize,
+                                     setup.m_metrics);
+        }
+    }
+
+    TestPipeline(const TestPipeline&) = delete;
+    TestPipeline& operator=(const TestPipeline&) = delete;
+
+    /**
+     * @brief Starts one thread per producer and per consumer.
+     */
+    void start()
+    {
+        m_threads.reserve(m_producers.size() + m_consumers.size());
+        for (auto& producer : m_producers)
+        {
+            m_threads.emplace_back([&producer]() { producer.produce(); });
+        }
+        for (auto& consumer : m_consumers)
+        {
+            m_threads.emplace_back([&consumer]() { consumer.consume(); });
+        }
+    }
+
+    /**
+     * @brief Waits for every worker thread to finish.
+     */
+    void join()
+    {
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+    /**
+     * @brief Runs the workers until every number is generated.
+     */
+    void run()
+    {
+        start();
+        join();
+    }
+
+    /**
+     * @brief Returns the flag set once every number is generated.
+     */
+    [[nodiscard]] const std::atomic_bool& completed() const noexcept { return m_completed; }
+
+    /**
+     * @brief Returns the storage the consumers record into.
+     */
+    [[nodiscard]] core::NumberStorage& storage() noexcept { return *m_storage; }
+
+    /**
+     * @brief Returns the producers.
+     */
+    [[nodiscard]] const std::vector<Producer<Queue>>& producers() const noexcept
+    {
+        return m_producers;
+    }
+
+   private:
+    Queue m_queue;                             ///< The queue shared by all the workers.
+    core::NumberStorage m_ownStorage;          ///< Storage used when none is given.
+    core::NumberStorage* m_storage;            ///< The storage the consumers record into.
+    core::OutputSink m_sink;                   ///< Sink discarding the numbers.
+    std::atomic_bool m_completed{false};       ///< Set once every number is generated.
+    std::vector<Producer<Queue>> m_producers;  ///< The producers.
+    std::vector<Consumer<Queue>> m_consumers;  ///< The consumers.
+    std::vector<std::thread> m_threads;        ///< Threads of the running workers.
+};
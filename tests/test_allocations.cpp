@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "lock_free_queue.h"
+#include "number_storage.h"
+#include "output_sink.h"
+#include "pipeline_harness.h"
+#include "thread_safe_queue.h"
+
+namespace
+{
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic_bool g_counting{false};    ///< Whether allocations are counted.
+std::atomic<size_t> g_allocations{0};  ///< Allocations counted so far.
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/**
+ * @brief Allocates for the replaced operator new, counting the call while counting is on.
+ */
+void* countedAllocate(size_t size, size_t alignment)
+{
+    if (g_counting.load(std::memory_order_relaxed))
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    size = size == 0 ? 1 : size;
+    // aligned_alloc wants a multiple of the alignment
+    const size_t alignedSize = (size + alignment - 1) / alignment * alignment;
+    void* pointer = alignment <= alignof(std::max_align_t)
+                        ? std::malloc(size)
+                        : std::aligned_alloc(alignment, alignedSize);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+/**
+ * @class AllocationCounter
+ * @brief Counts the heap allocations of every thread made during its lifetime.
+ */
+class AllocationCounter
+{
+   public:
+    AllocationCounter()
+    {
+        g_allocations = 0;
+        g_counting = true;
+    }
+    ~AllocationCounter() { g_counting = false; }
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    /**
+     * @brief Returns the number of allocations so far.
+     */
+    [[nodiscard]] size_t count() const noexcept { return g_allocations.load(); }
+};
+
+}  // namespace
+
+// The counting allocator hook: every operator new of the test binary goes through it
+void* operator new(size_t size)
+{
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return countedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t /*size*/) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t /*alignment*/) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+    std::free(pointer);
+}
+
+// Test Case 1: filling and draining the mutex-protected queue does not allocate
+TEST(Allocations, ThreadSafeQueueTest)
+{
+    core::ThreadSafeQueue<int> queue(1000);
+    std::array<int, 64> batch{};
+
+    AllocationCounter counter;
+    for (int round = 0; round < 100; ++round)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            ASSERT_TRUE(queue.tryPush(i));
+        }
+        int value = 0;
+        for (int i = 0; i < 500; ++i)
+        {
+            ASSERT_TRUE(queue.tryPop(value));
+        }
+        while (queue.tryPopBulk(std::span<int>(batch)) != 0)
+        {
+        }
+        ASSERT_EQ(queue.tryPushBulk(std::span<const int>(batch)), batch.size());
+        ASSERT_EQ(queue.tryPopBulk(std::span<int>(batch)), batch.size());
+    }
+    EXPECT_EQ(counter.count(), 0U);
+}
+
+// Test Case 2: formatting records into a writer's buffer does not allocate
+TEST(Allocations, WriterTest)
+{
+    for (auto format : {core::OutputFormat::Text, core::OutputFormat::Csv,
+                        core::OutputFormat::Binary, core::OutputFormat::Quiet})
+    {
+        const int fd = ::open("/dev/null", O_WRONLY);
+        ASSERT_GE(fd, 0);
+        {
+            core::OutputSink sink(format, fd);
+            core::OutputSink::Writer writer(sink);
+
+            AllocationCounter counter;
+            // Fewer records than fill a buffer, so none is handed over
+            for (uint64_t number = 1; number <= 500; ++number)
+            {
+                writer.write(number, number, 1234567);
+            }
+            EXPECT_EQ(counter.count(), 0U);
+        }
+        ::close(fd);
+    }
+}
+
+// Test Case 3: a running pipeline does not allocate between its start and its completion
+TEST(Allocations, PipelineSteadyStateTest)
+{
+    using Queue = core::ThreadSafeQueue<int>;
+    const int elements = 20000;
+    for (size_t batchSize : {size_t{1}, size_t{64}})
+    {
+        PipelineSetup setup;
+        setup.m_batchSize = batchSize;
+        TestPipeline<Queue> pipeline(elements, setup);
+
+        // Creating the threads allocates their states, so counting starts right after
+        pipeline.start();
+        size_t allocations = 0;
+        {
+            AllocationCounter counter;
+            while (!pipeline.completed().load())
+            {
+                std::this_thread::yield();
+            }
+            allocations = counter.count();
+        }
+        pipeline.join();
+        EXPECT_EQ(allocations, 0U) << "batch size " << batchSize;
+    }
+}
+
+// Test Case 4: the queue and the storage of a run can live in an arena
+TEST(Allocations, ArenaTest)
+{
+    std::vector<std::byte> buffer(1 << 16);
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                              std::pmr::null_memory_resource());
+
+    AllocationCounter counter;
+    core::ThreadSafeQueue<int> queue(1000, &arena);
+    core::NumberStorage storage(1000, true, true, &arena);
+    ASSERT_TRUE(queue.tryPush(42));
+    int value = 0;
+    ASSERT_TRUE(queue.tryPop(value));
+    ASSERT_TRUE(storage.tryMark(value));
+    storage.record(value, 1, 0);
+    EXPECT_EQ(storage.order(value), 1U);
+    EXPECT_EQ(counter.count(), 0U);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "blocking_queue.h"
+
+using namespace std::chrono_literals;
+
+// Test Case 1: push and pop success
+TEST(BlockingQueue, PushAndPopSuccessTest)
+{
+    core::BlockingQueue<int> queue(4);
+    int value;
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+
+    // Popping elements and verifying FIFO order
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+// Test Case 2: popFor times out on an empty queue
+TEST(BlockingQueue, PopForTimeoutTest)
+{
+    core::BlockingQueue<int> queue(4);
+    int value;
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(queue.popFor(value, 20ms));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+
+    EXPECT_TRUE(queue.tryPush(5));
+    EXPECT_TRUE(queue.popFor(value, 20ms));
+    EXPECT_EQ(value, 5);
+}
+
+// Test Case 3: a parked pop is woken by a push from another thread
+TEST(BlockingQueue, PopWaitsForPushTest)
+{
+    core::BlockingQueue<int> queue(4);
+    int value = 0;
+
+    std::thread consumer([&]() { EXPECT_TRUE(queue.pop(value)); });
+    // Give the consumer time to exhaust its backoff and park
+    std::this_thread::sleep_for(20ms);
+    EXPECT_TRUE(queue.push(42));
+    consumer.join();
+
+    EXPECT_EQ(value, 42);
+}
+
+// Test Case 4: a parked push is woken by a pop from another thread
+TEST(BlockingQueue, PushWaitsForPopTest)
+{
+    core::BlockingQueue<int> queue(2);
+    int value;
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_FALSE(queue.tryPush(3));
+
+    std::thread producer([&]() { EXPECT_TRUE(queue.push(3)); });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_TRUE(queue.pop(value));
+    producer.join();
+
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 3);
+}
+
+// Test Case 5: close wakes parked threads and makes blocking calls fail
+TEST(BlockingQueue, CloseWakesParkedThreadsTest)
+{
+    core::BlockingQueue<int> queue(2);
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+
+    core::BlockingQueue<int> emptyQueue(2);
+    std::thread producer([&]() { EXPECT_FALSE(queue.push(3)); });
+    std::thread consumer(
+        [&]()
+        {
+            int value;
+            EXPECT_FALSE(emptyQueue.pop(value));
+        });
+    std::this_thread::sleep_for(20ms);
+    queue.close();
+    emptyQueue.close();
+    producer.join();
+    consumer.join();
+
+    // Values queued before closing can still be popped
+    int value;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_FALSE(queue.pop(value));
+}
+
+// Test Case 6: stress test with blocking operations, every value is popped exactly once
+TEST(BlockingQueue, MultiProducerMultiConsumerStressTest)
+{
+    core::BlockingQueue<int> queue(16);
+    const int numProducers = 4;
+    const int numConsumers = 4;
+    const int numPushesPerThread = 20000;
+    const int totalValues = numProducers * numPushesPerThread;
+
+    std::vector<std::atomic<int>> seen(totalValues);
+    std::atomic<int> popped(0);
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < numProducers; ++p)
+    {
+        threads.emplace_back(
+            [&, p]()
+            {
+                for (int i = 0; i < numPushesPerThread; ++i)
+                {
+                    EXPECT_TRUE(queue.push(p * numPushesPerThread + i));
+                }
+            });
+    }
+    for (int c = 0; c < numConsumers; ++c)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                int value;
+                while (queue.pop(value))
+                {
+                    seen[value]++;
+                    if (++popped == totalValues)
+                    {
+                        queue.close();
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(popped.load(), totalValues);
+    for (int i = 0; i < totalValues; ++i)
+    {
+        ASSERT_EQ(seen[i].load(), 1) << "value " << i;
+    }
+}
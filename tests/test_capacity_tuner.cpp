@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+
+#include "capacity_tuner.h"
+#include "thread_safe_queue.h"
+
+namespace
+{
+
+/// Operations per window of the tuners of these tests.
+constexpr size_t kWindow = 100;
+
+/**
+ * @brief Returns tuning options whose decisions do not depend on the residency.
+ */
+core::CapacityTuning tuningOptions(size_t initial, size_t minimum, size_t maximum)
+{
+    core::CapacityTuning tuning;
+    tuning.m_initialCapacity = initial;
+    tuning.m_minCapacity = minimum;
+    tuning.m_maxCapacity = maximum;
+    tuning.m_maxResidency = std::chrono::hours(1);
+    tuning.m_window = kWindow;
+    return tuning;
+}
+
+/**
+ * @brief Feeds a tuner one window of calls.
+ *
+ * @param tuner The tuner.
+ * @param full Whether the pushes are cut short.
+ * @param empty Whether the pops find nothing.
+ */
+void runWindow(core::CapacityTuner& tuner, bool full, bool empty)
+{
+    for (size_t i = 0; i < kWindow; i += 2)
+    {
+        (void)tuner.onPush(full, 10);
+        (void)tuner.onPop(empty ? 0 : 1, 10);
+    }
+}
+
+}  // namespace
+
+// Test Case 1: a queue flipping between full and empty grows up to the largest capacity
+TEST(CapacityTuner, BurstsGrowTest)
+{
+    core::CapacityTuner tuner(tuningOptions(16, 8, 64));
+    runWindow(tuner, true, true);
+    EXPECT_EQ(tuner.capacity(), 32U);
+    runWindow(tuner, true, true);
+    runWindow(tuner, true, true);
+    EXPECT_EQ(tuner.capacity(), 64U);
+
+    const core::CapacityTuner::Summary summary = tuner.summary();
+    EXPECT_EQ(summary.m_initialCapacity, 16U);
+    EXPECT_EQ(summary.m_resizes, 2U);
+    EXPECT_EQ(summary.m_windows, 3U);
+    EXPECT_DOUBLE_EQ(summary.m_fullRate, 1.0);
+    EXPECT_DOUBLE_EQ(summary.m_emptyRate, 1.0);
+}
+
+// Test Case 2: a queue the consumers keep draining slower than it fills shrinks to the smallest
+TEST(CapacityTuner, SlowConsumersShrinkTest)
+{
+    core::CapacityTuner tuner(tuningOptions(1000, 16, 1 << 16));
+    runWindow(tuner, true, false);
+    EXPECT_EQ(tuner.capacity(), 500U);
+    for (int window = 0; window < 10; ++window)
+    {
+        runWindow(tuner, true, false);
+    }
+    EXPECT_EQ(tuner.capacity(), 16U);
+
+    // A balanced window keeps the capacity
+    runWindow(tuner, false, false);
+    EXPECT_EQ(tuner.capacity(), 16U);
+}
+
+// Test Case 3: right after growing, the capacity does not shrink below the capacity it grew to
+TEST(CapacityTuner, FloorAfterGrowTest)
+{
+    core::CapacityTuner tuner(tuningOptions(100, 16, 1000));
+    runWindow(tuner, true, true);
+    ASSERT_EQ(tuner.capacity(), 200U);
+    runWindow(tuner, true, false);
+    runWindow(tuner, true, false);
+    EXPECT_EQ(tuner.capacity(), 200U);
+    EXPECT_EQ(tuner.summary().m_resizes, 1U);
+}
+
+// Test Case 4: the floor left by an early burst is lifted once the bursts stop
+TEST(CapacityTuner, FloorDecayTest)
+{
+    core::CapacityTuning tuning = tuningOptions(100, 16, 1000);
+    tuning.m_floorWindows = 4;
+    core::CapacityTuner tuner(tuning);
+    runWindow(tuner, true, true);
+    ASSERT_EQ(tuner.capacity(), 200U);
+    for (int window = 0; window < 4; ++window)
+    {
+        runWindow(tuner, true, false);
+    }
+    EXPECT_EQ(tuner.capacity(), 200U);
+
+    runWindow(tuner, true, false);
+    EXPECT_EQ(tuner.capacity(), 100U);
+    for (int window = 0; window < 10; ++window)
+    {
+        runWindow(tuner, true, false);
+    }
+    EXPECT_EQ(tuner.capacity(), 16U);
+}
+
+// Test Case 5: a largest capacity below the smallest bounds growth at the smallest
+TEST(CapacityTuner, InvertedBoundsTest)
+{
+    core::CapacityTuner tuner(tuningOptions(16, 64, 32));
+    EXPECT_EQ(tuner.capacity(), 64U);
+    runWindow(tuner, true, true);
+    EXPECT_EQ(tuner.capacity(), 64U);
+    runWindow(tuner, true, false);
+    EXPECT_EQ(tuner.capacity(), 64U);
+    EXPECT_EQ(tuner.summary().m_resizes, 0U);
+}
+
+// Test Case 6: a residency above the target shrinks the capacity, even if the queue is never full
+TEST(CapacityTuner, ResidencyShrinkTest)
+{
+    core::CapacityTuning tuning = tuningOptions(100, 16, 1000);
+    tuning.m_maxResidency = std::chrono::microseconds(0);
+    core::CapacityTuner tuner(tuning);
+    runWindow(tuner, false, false);
+    EXPECT_EQ(tuner.capacity(), 50U);
+    EXPECT_GT(tuner.summary().m_residency.count(), 0);
+}
+
+// Test Case 7: a tuned queue lets in as many elements as its current capacity
+TEST(CapacityTuner, TunedQueueTest)
+{
+    core::ThreadSafeQueue<int> fixed(10);
+    EXPECT_EQ(fixed.capacity(), 10U);
+    EXPECT_FALSE(fixed.tuningSummary().has_value());
+
+    core::CapacityTuning tuning = tuningOptions(20, 8, 64);
+    tuning.m_window = 4096;
+    core::ThreadSafeQueue<int> queue(tuning);
+    EXPECT_EQ(queue.capacity(), 20U);
+    int pushed = 0;
+    while (queue.tryPush(pushed))
+    {
+        ++pushed;
+    }
+    EXPECT_EQ(pushed, 20);
+    ASSERT_TRUE(queue.tuningSummary().has_value());
+    EXPECT_EQ(queue.tuningSummary()->m_initialCapacity, 20U);
+
+    int value = -1;
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 0);
+}
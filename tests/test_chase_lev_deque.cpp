@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "chase_lev_deque.h"
+
+// Test Case 1: the owner pops in LIFO order, thieves steal in FIFO order
+TEST(ChaseLevDeque, OrderTest)
+{
+    core::ChaseLevDeque<int> deque(4);
+    for (int i = 1; i <= 4; ++i)
+    {
+        EXPECT_TRUE(deque.push(i));
+    }
+    EXPECT_FALSE(deque.push(5));
+
+    EXPECT_EQ(deque.steal(), 1);
+    EXPECT_EQ(deque.pop(), 4);
+    EXPECT_EQ(deque.steal(), 2);
+    EXPECT_EQ(deque.pop(), 3);
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(deque.pop(), std::nullopt);
+    EXPECT_EQ(deque.steal(), std::nullopt);
+
+    // The slots of the taken values are reused
+    EXPECT_TRUE(deque.push(6));
+    EXPECT_EQ(deque.pop(), 6);
+}
+
+// Test Case 2: every value is taken exactly once by the owner or by one of the thieves
+TEST(ChaseLevDeque, ConcurrentStealTest)
+{
+    const int valuesNr = 100000;
+    const int thievesNr = 3;
+    core::ChaseLevDeque<int> deque(valuesNr);
+    for (int i = 0; i < valuesNr; ++i)
+    {
+        ASSERT_TRUE(deque.push(i));
+    }
+
+    std::vector<std::atomic<int>> taken(valuesNr);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < thievesNr; ++t)
+    {
+        thieves.emplace_back(
+            [&]()
+            {
+                while (!deque.empty())
+                {
+                    if (auto value = deque.steal())
+                    {
+                        taken[*value]++;
+                    }
+                }
+            });
+    }
+    while (auto value = deque.pop())
+    {
+        taken[*value]++;
+    }
+    for (auto& thief : thieves)
+    {
+        thief.join();
+    }
+
+    for (int i = 0; i < valuesNr; ++i)
+    {
+        ASSERT_EQ(taken[i].load(), 1) << "value " << i;
+    }
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "async_queue.h"
+#include "generator.h"
+#include "thread_pool.h"
+#include "unique_numbers.h"
+
+namespace
+{
+
+/**
+ * @brief Yields the squares of 1..count.
+ */
+core::Generator<int> squares(int count)
+{
+    for (int i = 1; i <= count; ++i)
+    {
+        co_yield i * i;
+    }
+}
+
+/**
+ * @brief Pushes 1..count into a queue, then reports its end.
+ */
+core::Task pushAll(core::AsyncQueue<int>& queue, int count, std::atomic<int>& done)
+{
+    for (int i = 1; i <= count; ++i)
+    {
+        if (!co_await queue.push(i))
+        {
+            break;
+        }
+    }
+    done.fetch_add(1);
+}
+
+}  // namespace
+
+// Test Case 1: the generator runs lazily and yields its values in order
+TEST(Coroutines, GeneratorTest)
+{
+    std::vector<int> values;
+    for (const int value : squares(5))
+    {
+        values.push_back(value);
+    }
+    EXPECT_EQ(values, (std::vector<int>{1, 4, 9, 16, 25}));
+}
+
+// Test Case 2: a pusher suspended on a full queue is resumed by the pops, and close() wakes it
+TEST(Coroutines, AsyncQueueTest)
+{
+    core::ThreadPool pool(2);
+    core::AsyncQueue<int> queue(4, pool);
+    std::atomic<int> done(0);
+    pushAll(queue, 100, done).start(pool);
+
+    for (int i = 1; i <= 50; ++i)
+    {
+        EXPECT_EQ(queue.popWait(), i);
+    }
+    // The pusher is parked on the full queue, holding no thread of the pool
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(done.load(), 0);
+
+    queue.close();
+    while (done.load() == 0)
+    {
+        std::this_thread::yield();
+    }
+    // The values pushed before closing are still drained
+    int drained = 0;
+    while (queue.popWait())
+    {
+        ++drained;
+    }
+    EXPECT_EQ(drained, 4);
+}
+
+// Test Case 3: uniqueNumbers() yields a permutation of the range
+TEST(Coroutines, UniqueNumbersTest)
+{
+    const uint64_t elements = 20000;
+    core::UniqueNumbersOptions options;
+    options.m_elements = elements;
+    options.m_producersNr = 3;
+    options.m_consumersNr = 2;
+    options.m_queueCapacity = 64;
+    options.m_seed = 42;
+
+    std::vector<uint64_t> values;
+    for (const uint64_t value : core::uniqueNumbers(options))
+    {
+        values.push_back(value);
+    }
+    ASSERT_EQ(values.size(), elements);
+    std::sort(values.begin(), values.end());
+    for (uint64_t i = 0; i < elements; ++i)
+    {
+        EXPECT_EQ(values[i], i + 1);
+    }
+}
+
+// Test Case 4: leaving the loop early stops the stages and the pool
+TEST(Coroutines, EarlyBreakTest)
+{
+    core::UniqueNumbersOptions options;
+    options.m_elements = 1'000'000;
+    options.m_queueCapacity = 16;
+
+    size_t taken = 0;
+    for (const uint64_t value : core::uniqueNumbers(options))
+    {
+        EXPECT_GE(value, 1U);
+        EXPECT_LE(value, options.m_elements);
+        if (++taken == 100)
+        {
+            break;
+        }
+    }
+    EXPECT_EQ(taken, 100U);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "dedup_kernel.h"
+#include "number_storage.h"
+
+namespace
+{
+
+/**
+ * @brief Runs a kernel and the scalar kernel over the same batches and compares the results.
+ *
+ * The batches are drawn from a small range so that they hold duplicates,
+ * both within a batch and with the bits set by earlier batches.
+ *
+ * @param kernel The kernel to check.
+ * @param elements The number of elements.
+ */
+template <core::NumberType T>
+void expectSameAsScalar(core::DedupKernel kernel, size_t elements)
+{
+    std::vector<std::atomic<uint64_t>> expectedBits((elements + 63) / 64);
+    std::vector<std::atomic<uint64_t>> bits((elements + 63) / 64);
+    std::mt19937_64 engine(7);
+    std::uniform_int_distribution<uint64_t> distribution(1, elements);
+
+    // Batch sizes around the vector widths, tails included
+    for (size_t size : {0, 1, 3, 4, 7, 8, 9, 17, 64, 100, 1000})
+    {
+        std::vector<T> expected(size);
+        for (T& value : expected)
+        {
+            value = static_cast<T>(distribution(engine));
+        }
+        std::vector<T> values = expected;
+
+        const size_t expectedFresh =
+            core::markNew(core::DedupKernel::Scalar, expectedBits.data(), std::span<T>(expected));
+        const size_t fresh = core::markNew(kernel, bits.data(), std::span<T>(values));
+        ASSERT_EQ(fresh, expectedFresh) << "batch size " << size;
+        for (size_t i = 0; i < fresh; ++i)
+        {
+            ASSERT_EQ(values[i], expected[i]) << "batch size " << size << ", index " << i;
+        }
+    }
+    for (size_t word = 0; word < bits.size(); ++word)
+    {
+        EXPECT_EQ(bits[word].load(), expectedBits[word].load()) << "word " << word;
+    }
+}
+
+}  // namespace
+
+// Test Case 1: every supported kernel keeps the same numbers, in the same order, as the scalar one
+TEST(DedupKernel, SameAsScalarTest)
+{
+    EXPECT_TRUE(core::dedupKernelSupported(core::DedupKernel::Scalar));
+    EXPECT_TRUE(core::dedupKernelSupported(core::bestDedupKernel()));
+    for (auto kernel : {core::DedupKernel::Avx2, core::DedupKernel::Avx512})
+    {
+        if (!core::dedupKernelSupported(kernel))
+        {
+            continue;
+        }
+        for (size_t elements : {size_t{1}, size_t{70}, size_t{500}, size_t{100000}})
+        {
+            expectSameAsScalar<int>(kernel, elements);
+            expectSameAsScalar<uint64_t>(kernel, elements);
+        }
+    }
+}
+
+// Test Case 2: threads marking overlapping batches accept every number exactly once
+TEST(DedupKernel, ConcurrentBatchesTest)
+{
+    constexpr int kElements = 50000;
+    constexpr size_t kThreadsNr = 4;
+    core::NumberStorage storage(kElements);
+    std::vector<std::vector<int>> accepted(kThreadsNr);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreadsNr; ++t)
+    {
+        threads.emplace_back(
+            [&storage, &accepted, t]()
+            {
+                // Every thread walks all the numbers, from another start
+                std::vector<int> batch(64);
+                for (int i = 0; i < kElements; i += static_cast<int>(batch.size()))
+                {
+                    for (size_t j = 0; j < batch.size(); ++j)
+                    {
+                        const auto offset = static_cast<int>(t) * kElements / 4;
+                        batch[j] = (offset + i + static_cast<int>(j)) % kElements + 1;
+                    }
+                    const size_t fresh = storage.tryMarkBatch(std::span<int>(batch));
+                    accepted[t].insert(accepted[t].end(), batch.begin(),
+                                       batch.begin() + static_cast<std::ptrdiff_t>(fresh));
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<int> counts(kElements + 1, 0);
+    for (const auto& values : accepted)
+    {
+        for (const int value : values)
+        {
+            ++counts[static_cast<size_t>(value)];
+        }
+    }
+    for (int value = 1; value <= kElements; ++value)
+    {
+        ASSERT_EQ(counts[static_cast<size_t>(value)], 1) << "number " << value;
+        EXPECT_TRUE(storage.isMarked(value));
+    }
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include "deterministic_pipeline.h"
+
+namespace
+{
+
+/**
+ * @brief Runs the deterministic pipeline and returns the order of every number.
+ *
+ * @param elements The number of elements.
+ * @param engine The random engine of the producers.
+ * @param seed The seed of the run.
+ * @param producersNr The number of producers.
+ * @return The order of number i at index i, index 0 unused.
+ */
+std::vector<size_t> runOrders(int elements,
+                              core::RandomEngine engine,
+                              uint64_t seed,
+                              size_t producersNr)
+{
+    core::NumberStorage storage(static_cast<size_t>(elements));
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+    DeterministicPipeline pipeline(storage, sink, elements, engine, seed, producersNr);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < producersNr; ++i)
+    {
+        threads.emplace_back([&pipeline, i]() { pipeline.produce(i); });
+    }
+    threads.emplace_back([&pipeline]() { pipeline.merge(); });
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<size_t> orders(static_cast<size_t>(elements) + 1);
+    for (int value = 1; value <= elements; ++value)
+    {
+        orders[value] = storage.order(value);
+    }
+    return orders;
+}
+
+}  // namespace
+
+// Test Case 1: every number is generated exactly once and the orders are 1..N
+TEST(DeterministicPipeline, GeneratesAllNumbersTest)
+{
+    const int elements = 5000;
+    const std::vector<size_t> orders = runOrders(elements, core::RandomEngine::Xoshiro256, 1, 3);
+
+    std::vector<int> counts(elements + 1);
+    for (int value = 1; value <= elements; ++value)
+    {
+        ASSERT_GE(orders[value], 1U);
+        ASSERT_LE(orders[value], static_cast<size_t>(elements));
+        counts[orders[value]]++;
+    }
+    for (int order = 1; order <= elements; ++order)
+    {
+        EXPECT_EQ(counts[order], 1) << "order " << order;
+    }
+}
+
+// Test Case 2: the same seed and producer count replay the same sequence, whatever the engine
+TEST(DeterministicPipeline, ReproducibleTest)
+{
+    const int elements = 20000;
+    for (auto engine : {core::RandomEngine::Standard, core::RandomEngine::Xoshiro256x4,
+                        core::RandomEngine::Philox})
+    {
+        const std::vector<size_t> first = runOrders(elements, engine, 12345, 4);
+        EXPECT_EQ(runOrders(elements, engine, 12345, 4), first);
+        EXPECT_NE(runOrders(elements, engine, 12346, 4), first);
+        EXPECT_NE(runOrders(elements, engine, 12345, 3), first);
+    }
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "feistel_permutation.h"
+#include "permutation_worker.h"
+
+// Test Case 1: the permutation is a bijection of 0..size-1 for all kinds of sizes
+TEST(FeistelPermutation, BijectionTest)
+{
+    for (uint64_t size : {1ULL, 2ULL, 3ULL, 4ULL, 5ULL, 17ULL, 64ULL, 100ULL, 1000ULL, 65537ULL})
+    {
+        const core::FeistelPermutation permutation(size, 12345);
+        std::vector<int> seen(size);
+        for (uint64_t index = 0; index < size; ++index)
+        {
+            const uint64_t value = permutation(index);
+            ASSERT_LT(value, size);
+            seen[value]++;
+        }
+        for (uint64_t value = 0; value < size; ++value)
+        {
+            ASSERT_EQ(seen[value], 1) << "size " << size << ", value " << value;
+        }
+    }
+}
+
+// Test Case 2: different keys give different permutations, the same key the same one
+TEST(FeistelPermutation, KeyTest)
+{
+    const uint64_t size = 1000;
+    const core::FeistelPermutation first(size, 1);
+    const core::FeistelPermutation same(size, 1);
+    const core::FeistelPermutation second(size, 2);
+
+    int fixedPoints = 0;
+    int differences = 0;
+    for (uint64_t index = 0; index < size; ++index)
+    {
+        EXPECT_EQ(first(index), same(index));
+        fixedPoints += first(index) == index ? 1 : 0;
+        differences += first(index) != second(index) ? 1 : 0;
+    }
+    // A random permutation has one fixed point on average
+    EXPECT_LT(fixedPoints, 10);
+    EXPECT_GT(differences, 900);
+}
+
+// Test Case 3: workers over disjoint ranges emit every number once, ordered by index
+TEST(FeistelPermutation, WorkersCoverRangeTest)
+{
+    const uint64_t elements = 300;
+    const uint64_t workersNr = 3;
+    const core::FeistelPermutation permutation(elements, 7);
+    core::NumberStorage storage(elements);
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+
+    std::vector<PermutationWorker> workers;
+    for (uint64_t i = 0; i < workersNr; ++i)
+    {
+        workers.emplace_back(permutation, &storage, sink, elements * i / workersNr,
+                             elements * (i + 1) / workersNr);
+    }
+    std::vector<std::thread> threads;
+    for (auto& worker : workers)
+    {
+        threads.emplace_back([&worker]() { worker.generate(); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (uint64_t index = 0; index < elements; ++index)
+    {
+        const auto value = static_cast<int>(permutation(index) + 1);
+        EXPECT_TRUE(storage.isMarked(value));
+        EXPECT_EQ(storage.order(value), index + 1);
+    }
+}
+
+// Test Case 4: without a storage, a worker streams numbers of a range far beyond INT_MAX
+TEST(FeistelPermutation, StreamWithoutStorageTest)
+{
+    const uint64_t elements = uint64_t{1} << 40;
+    const uint64_t emitted = 1000;
+    const core::FeistelPermutation permutation(elements, 11);
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    {
+        core::OutputSink sink(core::OutputFormat::Csv, fileno(file));
+        PermutationWorker(permutation, nullptr, sink, 0, emitted).generate();
+        sink.close();
+    }
+
+    std::rewind(file);
+    char header[64];
+    ASSERT_NE(std::fgets(header, sizeof(header), file), nullptr);
+    std::set<uint64_t> seen;
+    unsigned long long number = 0;
+    unsigned long long order = 0;
+    long long time = 0;
+    while (std::fscanf(file, "%llu,%llu,%lld\n", &number, &order, &time) == 3)
+    {
+        EXPECT_EQ(number, permutation(order - 1) + 1);
+        EXPECT_LE(number, elements);
+        seen.insert(number);
+    }
+    std::fclose(file);
+    EXPECT_EQ(seen.size(), emitted);
+    EXPECT_GT(*seen.rbegin(), uint64_t{1} << 32);
+}
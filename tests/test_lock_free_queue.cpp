@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "lock_free_queue.h"
+
+// Test Case 1: tryPush and tryPop success
+TEST(LockFreeQueue, PushAndPopSuccessTest)
+{
+    core::LockFreeQueue<int> queue(4);
+    int value;
+
+    // Pushing elements successfully
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_TRUE(queue.tryPush(3));
+
+    // Popping elements and verifying FIFO order
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 3);
+}
+
+// Test Case 2: capacity is rounded up to a power of two
+TEST(LockFreeQueue, CapacityRoundingTest)
+{
+    EXPECT_EQ(core::LockFreeQueue<int>(0).capacity(), 2);
+    EXPECT_EQ(core::LockFreeQueue<int>(2).capacity(), 2);
+    EXPECT_EQ(core::LockFreeQueue<int>(3).capacity(), 4);
+    EXPECT_EQ(core::LockFreeQueue<int>(1000).capacity(), 1024);
+}
+
+// Test Case 3: tryPush and tryPop until failure
+TEST(LockFreeQueue, PushAndPopUntilFailureTest)
+{
+    core::LockFreeQueue<int> queue(2);
+    int value;
+
+    // Pushing more elements than the queue size is
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_FALSE(queue.tryPush(3));
+
+    // Popping elements even if the queue is empty
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+// Test Case 4: the ring wraps around many times and keeps FIFO order
+TEST(LockFreeQueue, WrapAroundTest)
+{
+    core::LockFreeQueue<int> queue(4);
+    int value;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(queue.tryPush(i));
+        EXPECT_TRUE(queue.tryPush(i + 1));
+        EXPECT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+        EXPECT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i + 1);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+// Test Case 5: single producer and single consumer keep FIFO order under concurrency
+TEST(LockFreeQueue, ConcurrentFifoOrderTest)
+{
+    core::LockFreeQueue<int> queue(16);
+    const int numValues = 100000;
+
+    std::thread producer(
+        [&]()
+        {
+            for (int i = 0; i < numValues; ++i)
+            {
+                while (!queue.tryPush(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    int expected = 0;
+    int value;
+    while (expected < numValues)
+    {
+        if (queue.tryPop(value))
+        {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+// Test Case 6: stress test, every pushed value is popped exactly once
+TEST(LockFreeQueue, MultiProducerMultiConsumerStressTest)
+{
+    core::LockFreeQueue<int> queue(64);
+    const int numProducers = 4;
+    const int numConsumers = 4;
+    const int numPushesPerThread = 50000;
+    const int totalValues = numProducers * numPushesPerThread;
+
+    std::vector<std::atomic<int>> seen(totalValues);
+    std::atomic<int> popped(0);
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < numProducers; ++p)
+    {
+        threads.emplace_back(
+            [&, p]()
+            {
+                for (int i = 0; i < numPushesPerThread; ++i)
+                {
+                    while (!queue.tryPush(p * numPushesPerThread + i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+    for (int c = 0; c < numConsumers; ++c)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                int value;
+                while (popped.load() < totalValues)
+                {
+                    if (queue.tryPop(value))
+                    {
+                        seen[value]++;
+                        popped++;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(popped.load(), totalValues);
+    for (int i = 0; i < totalValues; ++i)
+    {
+        ASSERT_EQ(seen[i].load(), 1) << "value " << i;
+    }
+    int value;
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+// Test Case 7: full queue under concurrent push test
+TEST(LockFreeQueue, FullQueueConcurrentPushTest)
+{
+    const size_t queueSize = 8;
+    core::LockFreeQueue<int> queue(queueSize);
+
+    for (size_t i = 0; i < queueSize; ++i)
+    {
+        EXPECT_TRUE(queue.tryPush(static_cast<int>(i)));
+    }
+
+    const size_t numThreads = 5;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> failedPushes(0);
+
+    // Create and launch producer threads
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                if (!queue.tryPush(10))
+                {
+                    failedPushes++;
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // All pushes should fail
+    EXPECT_EQ(failedPushes.load(), numThreads);
+}
+
+// Test Case 8: tryPushBulk and tryPopBulk across the ring boundary
+TEST(LockFreeQueue, BulkPushAndPopWrapAroundTest)
+{
+    core::LockFreeQueue<int> queue(8);
+    std::vector<int> input{1, 2, 3, 4, 5, 6};
+    std::vector<int> output(8);
+
+    for (int round = 0; round < 10; ++round)
+    {
+        EXPECT_EQ(queue.tryPushBulk(input), input.size());
+        // Only two slots are left
+        EXPECT_EQ(queue.tryPushBulk(input), 2);
+        EXPECT_EQ(queue.tryPopBulk(output), 8);
+        EXPECT_EQ(output[5], 6);
+        EXPECT_EQ(output[6], 1);
+        EXPECT_EQ(output[7], 2);
+        EXPECT_EQ(queue.tryPopBulk(output), 0);
+    }
+}
+
+// Test Case 9: stress test with bulk operations, every value is popped exactly once
+TEST(LockFreeQueue, BulkMultiProducerMultiConsumerStressTest)
+{
+    core::LockFreeQueue<int> queue(64);
+    const int numProducers = 4;
+    const int numConsumers = 4;
+    const int numPushesPerThread = 50000;
+    const int batchSize = 16;
+    const int totalValues = numProducers * numPushesPerThread;
+
+    std::vector<std::atomic<int>> seen(totalValues);
+    std::atomic<int> popped(0);
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < numProducers; ++p)
+    {
+        threads.emplace_back(
+            [&, p]()
+            {
+                std::vector<int> batch(batchSize);
+                for (int i = 0; i < numPushesPerThread; i += batchSize)
+                {
+                    for (int j = 0; j < batchSize; ++j)
+                    {
+                        batch[j] = p * numPushesPerThread + i + j;
+                    }
+                    std::span<const int> pending(batch);
+                    while (!pending.empty())
+                    {
+                        const size_t pushed = queue.tryPushBulk(pending);
+                        if (pushed == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                        pending = pending.subspan(pushed);
+                    }
+                }
+            });
+    }
+    for (int c = 0; c < numConsumers; ++c)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                std::vector<int> batch(batchSize);
+                while (popped.load() < totalValues)
+                {
+                    const size_t count = queue.tryPopBulk(batch);
+                    if (count == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        seen[batch[i]]++;
+                    }
+                    popped += static_cast<int>(count);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(popped.load(), totalValues);
+    for (int i = 0; i < totalValues; ++i)
+    {
+        ASSERT_EQ(seen[i].load(), 1) << "value " << i;
+    }
+}
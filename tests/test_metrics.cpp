@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "latency_histogram.h"
+#include "lock_free_queue.h"
+#include "metrics.h"
+#include "pipeline_harness.h"
+#include "thread_safe_queue.h"
+
+namespace
+{
+
+/**
+ * @brief Runs two producers and two consumers over a queue, recording into metrics.
+ *
+ * @param prefilter Whether the producers drop the draws already generated.
+ */
+template <typename Queue>
+void runPipeline(core::Metrics& metrics, int elements, bool prefilter = false)
+{
+    PipelineSetup setup;
+    setup.m_capacity = 64;
+    setup.m_staggeredBatches = true;
+    setup.m_metrics = &metrics;
+    setup.m_prefilter = prefilter;
+    TestPipeline<Queue> pipeline(elements, setup);
+    pipeline.run();
+}
+
+}  // namespace
+
+// Test Case 1: every value falls into a bucket at most 1/16 wider than the value
+TEST(Metrics, HistogramBucketsTest)
+{
+    for (uint64_t value : {uint64_t{0}, uint64_t{15}, uint64_t{16}, uint64_t{17}, uint64_t{1000},
+                           uint64_t{123456789}, ~uint64_t{0}})
+    {
+        const size_t bucket = core::LatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, core::LatencyHistogram::kBuckets);
+        const uint64_t highest = core::LatencyHistogram::highestOf(bucket);
+        EXPECT_GE(highest, value);
+        EXPECT_LE(highest - value, value / core::LatencyHistogram::kSubBuckets);
+    }
+}
+
+// Test Case 2: percentiles, merge and the summary statistics
+TEST(Metrics, HistogramPercentilesTest)
+{
+    core::LatencyHistogram first;
+    core::LatencyHistogram second;
+    for (uint64_t value = 1; value <= 1000; ++value)
+    {
+        (value % 2 == 0 ? first : second).record(value);
+    }
+    first.merge(second);
+
+    EXPECT_EQ(first.count(), 1000U);
+    EXPECT_EQ(first.max(), 1000U);
+    EXPECT_DOUBLE_EQ(first.mean(), 500.5);
+    EXPECT_NEAR(static_cast<double>(first.percentile(50)), 500.0, 500.0 / 16);
+    EXPECT_NEAR(static_cast<double>(first.percentile(99)), 990.0, 990.0 / 16);
+    EXPECT_EQ(first.percentile(100), 1000U);
+    EXPECT_EQ(core::LatencyHistogram().percentile(50), 0U);
+}
+
+// Test Case 3: the counters of a complete run add up, over queues of int and of uint64_t
+TEST(Metrics, PipelineCountersTest)
+{
+    const int elements = 2000;
+    for (bool wide : {false, true})
+    {
+        core::Metrics metrics(elements);
+        if (wide)
+        {
+            runPipeline<core::LockFreeQueue<uint64_t>>(metrics, elements);
+        }
+        else
+        {
+            runPipeline<core::ThreadSafeQueue<int>>(metrics, elements);
+        }
+
+        const auto total = metrics.total();
+        EXPECT_EQ(total->m_accepted.value(), static_cast<uint64_t>(elements));
+        EXPECT_EQ(total->m_accepted.value() + total->m_duplicates.value(), total->m_pops.value());
+        EXPECT_GE(total->m_pushes.value(), 1U);
+        EXPECT_GT(total->m_residency.count(), 0U);
+        EXPECT_GT(total->m_acceptLatency.count(), 0U);
+
+        std::ostringstream summary;
+        metrics.printSummary(summary);
+        EXPECT_NE(summary.str().find("queue residency"), std::string::npos) << summary.str();
+    }
+}
+
+// Test Case 4: producers filtering their draws keep duplicates out of the queue
+TEST(Metrics, PrefilterTest)
+{
+    const int elements = 5000;
+    core::Metrics unfiltered(elements);
+    runPipeline<core::LockFreeQueue<int>>(unfiltered, elements);
+    core::Metrics filtered(elements);
+    runPipeline<core::LockFreeQueue<int>>(filtered, elements, true);
+
+    const auto before = unfiltered.total();
+    const auto after = filtered.total();
+    EXPECT_EQ(before->m_filtered.value(), 0U);
+    EXPECT_GT(after->m_filtered.value(), 0U);
+    // The consumers still accept every number exactly once
+    EXPECT_EQ(after->m_accepted.value(), static_cast<uint64_t>(elements));
+    EXPECT_LT(after->m_duplicates.value(), before->m_duplicates.value());
+
+    std::ostringstream summary;
+    filtered.printSummary(summary);
+    EXPECT_NE(summary.str().find("Filtered by producers"), std::string::npos) << summary.str();
+}
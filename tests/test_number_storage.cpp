@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "number_storage.h"
+#include "page_memory.h"
+
+// Test Case 1: a number is marked only once and its columns are recorded
+TEST(NumberStorage, MarkAndRecordTest)
+{
+    core::NumberStorage storage(130);
+
+    EXPECT_FALSE(storage.isMarked(64));
+    EXPECT_TRUE(storage.tryMark(64));
+    EXPECT_FALSE(storage.tryMark(64));
+    EXPECT_TRUE(storage.isMarked(64));
+
+    // Neighbours in the same and in the next bitset word are not affected
+    EXPECT_FALSE(storage.isMarked(63));
+    EXPECT_FALSE(storage.isMarked(65));
+    EXPECT_TRUE(storage.tryMark(65));
+    EXPECT_TRUE(storage.tryMark(130));
+
+    // The owner-only mark sees the same bits
+    EXPECT_FALSE(storage.tryMarkOwned(65));
+    EXPECT_TRUE(storage.tryMarkOwned(66));
+    EXPECT_FALSE(storage.tryMark(66));
+
+    storage.record(64, 1, 10);
+    storage.record(65, 2, 20);
+    EXPECT_EQ(storage.order(64), 1);
+    EXPECT_EQ(storage.order(65), 2);
+    EXPECT_EQ(storage.order(1), 0);
+    EXPECT_EQ(storage.generationTime(65), 20);
+    EXPECT_EQ(storage.totalGenerationTime(), 30);
+}
+
+// Test Case 2: the time column can be left out
+TEST(NumberStorage, WithoutTimesTest)
+{
+    core::NumberStorage storage(10, false);
+
+    EXPECT_FALSE(storage.recordsTimes());
+    EXPECT_TRUE(storage.tryMark(3));
+    storage.record(3, 1, 42);
+    EXPECT_EQ(storage.order(3), 1);
+    EXPECT_EQ(storage.generationTime(3), 0);
+    EXPECT_EQ(storage.totalGenerationTime(), 0);
+}
+
+// Test Case 3: concurrent marks of the same numbers succeed exactly once per number
+TEST(NumberStorage, ConcurrentMarkTest)
+{
+    const int numThreads = 4;
+    const int elements = 10000;
+    core::NumberStorage storage(elements);
+    std::atomic<int> marked(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (int value = 1; value <= elements; ++value)
+                {
+                    if (storage.tryMark(value))
+                    {
+                        ++marked;
+                    }
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(marked.load(), elements);
+}
+
+// Test Case 4: columns mapped from zero-filled pages start empty and survive the first touch
+TEST(NumberStorage, PageMemoryTest)
+{
+    for (bool hugePages : {false, true})
+    {
+        // Large enough for the time column to get an aligned huge block
+        const size_t elements = core::PageMemoryResource::kHugePageSize / sizeof(long long) + 100;
+        core::PageMemoryResource memory(hugePages);
+        core::NumberStorage storage(elements, true, true, &memory);
+
+        EXPECT_TRUE(storage.tryMark(elements));
+        storage.record(elements, 1, 5);
+        // Touching marked pages again is not allowed, so only the other parts are touched
+        for (size_t part = 0; part < 3; ++part)
+        {
+            storage.firstTouch(part, 4);
+        }
+        EXPECT_EQ(storage.unmarked().size(), elements - 1);
+        EXPECT_FALSE(storage.isMarked(1));
+        EXPECT_EQ(storage.order(1), 0U);
+        EXPECT_EQ(storage.order(elements), 1U);
+        EXPECT_EQ(storage.totalGenerationTime(), 5);
+    }
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "output_sink.h"
+
+namespace
+{
+
+/**
+ * @brief Writes records through a sink of the given format and returns the written bytes.
+ */
+template <typename Function>
+std::string writeThroughSink(core::OutputFormat format, Function&& writeRecords)
+{
+    std::FILE* file = std::tmpfile();
+    EXPECT_NE(file, nullptr);
+    {
+        core::OutputSink sink(format, fileno(file));
+        writeRecords(sink);
+        sink.close();
+    }
+    std::string contents;
+    std::rewind(file);
+    char chunk[4096];
+    size_t read = 0;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        contents.append(chunk, read);
+    }
+    std::fclose(file);
+    return contents;
+}
+
+}  // namespace
+
+// Test Case 1: text and csv records match the expected lines
+TEST(OutputSink, TextAndCsvTest)
+{
+    auto writeTwo = [](core::OutputSink& sink)
+    {
+        core::OutputSink::Writer writer(sink);
+        writer.write(42, 7, 12);
+        writer.write(3, 8, 0);
+    };
+
+    EXPECT_EQ(writeThroughSink(core::OutputFormat::Text, writeTwo),
+              "number = 00042, order = 00007, generation_time = 0000000012\n"
+              "number = 00003, order = 00008, generation_time = 0000000000\n");
+    EXPECT_EQ(writeThroughSink(core::OutputFormat::Csv, writeTwo),
+              "number,order,generation_time\n42,7,12\n3,8,0\n");
+    EXPECT_TRUE(writeThroughSink(core::OutputFormat::Quiet, writeTwo).empty());
+}
+
+// Test Case 2: binary records round trip
+TEST(OutputSink, BinaryTest)
+{
+    const std::string contents =
+        writeThroughSink(core::OutputFormat::Binary,
+                         [](core::OutputSink& sink)
+                         {
+                             core::OutputSink::Writer writer(sink);
+                             writer.write(5, 1, 100);
+                             writer.write(9, 2, 200);
+                         });
+
+    ASSERT_EQ(contents.size(), 2 * sizeof(core::BinaryRecord));
+    core::BinaryRecord records[2];
+    std::memcpy(records, contents.data(), contents.size());
+    EXPECT_EQ(records[0].m_number, 5);
+    EXPECT_EQ(records[0].m_order, 1U);
+    EXPECT_EQ(records[0].m_generationTime, 100);
+    EXPECT_EQ(records[1].m_number, 9);
+    EXPECT_EQ(records[1].m_order, 2U);
+    EXPECT_EQ(records[1].m_generationTime, 200);
+}
+
+// Test Case 3: records of concurrent writers all arrive, across many buffer handovers
+TEST(OutputSink, ConcurrentWritersTest)
+{
+    const int writersNr = 4;
+    const int recordsPerWriter = 20000;
+    const std::string contents =
+        writeThroughSink(core::OutputFormat::Binary,
+                         [&](core::OutputSink& sink)
+                         {
+                             std::vector<std::thread> threads;
+                             for (int w = 0; w < writersNr; ++w)
+                             {
+                                 threads.emplace_back(
+                                     [&sink, w]()
+                                     {
+                                         core::OutputSink::Writer writer(sink);
+                                         for (int i = 0; i < recordsPerWriter; ++i)
+                                         {
+                                             writer.write(w * recordsPerWriter + i, i, 0);
+                                         }
+                                     });
+                             }
+                             for (auto& thread : threads)
+                             {
+                                 thread.join();
+                             }
+                         });
+
+    ASSERT_EQ(contents.size(), writersNr * recordsPerWriter * sizeof(core::BinaryRecord));
+    std::vector<core::BinaryRecord> records(writersNr * recordsPerWriter);
+    std::memcpy(records.data(), contents.data(), contents.size());
+    std::vector<bool> seen(records.size());
+    for (const auto& record : records)
+    {
+        ASSERT_GE(record.m_number, 0);
+        ASSERT_LT(record.m_number, static_cast<int>(records.size()));
+        EXPECT_FALSE(seen[record.m_number]);
+        seen[record.m_number] = true;
+    }
+}
+
+// Test Case 4: the sink notes when the number of order 1 is written
+TEST(OutputSink, FirstNumberTimeTest)
+{
+    writeThroughSink(core::OutputFormat::Quiet,
+                     [](core::OutputSink& sink)
+                     {
+                         core::OutputSink::Writer writer(sink);
+                         writer.write(5, 2, 0);
+                         EXPECT_FALSE(sink.firstNumberTime().has_value());
+
+                         const auto before = std::chrono::steady_clock::now();
+                         writer.write(9, 1, 0);
+                         const auto firstNumberTime = sink.firstNumberTime();
+                         ASSERT_TRUE(firstNumberTime.has_value());
+                         EXPECT_GE(*firstNumberTime, before);
+                         EXPECT_LE(*firstNumberTime, std::chrono::steady_clock::now());
+                     });
+}
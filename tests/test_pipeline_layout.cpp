@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "completion_poll.h"
+#include "consumer.h"
+#include "lock_free_queue.h"
+#include "pipeline_harness.h"
+#include "producer.h"
+
+namespace
+{
+
+using Queue = core::LockFreeQueue<int>;
+
+/**
+ * @brief Returns whether two objects share a cache line.
+ */
+bool shareCacheLine(const void* first, const void* second)
+{
+    const auto firstLine = reinterpret_cast<uintptr_t>(first) / core::kCacheLineSize;
+    const auto secondLine = reinterpret_cast<uintptr_t>(second) / core::kCacheLineSize;
+    return firstLine == secondLine;
+}
+
+}  // namespace
+
+// Test Case 1: producers and consumers kept in a vector never share a cache line
+TEST(PipelineLayout, WorkersOnSeparateLinesTest)
+{
+    static_assert(alignof(Producer<Queue>) >= core::kCacheLineSize);
+    static_assert(alignof(Consumer<Queue>) >= core::kCacheLineSize);
+
+    Queue queue(16);
+    core::NumberStorage storage(16);
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+    std::atomic_bool complete(false);
+
+    std::vector<Producer<Queue>> producers;
+    std::vector<Consumer<Queue>> consumers;
+    for (size_t i = 0; i < 2; ++i)
+    {
+        producers.emplace_back(queue, core::RandomSource(core::RandomEngine::Standard, 16, 1, i),
+                               complete);
+        consumers.emplace_back(queue, storage, sink, 16, complete);
+    }
+
+    const auto* lastProducerByte = reinterpret_cast<const char*>(&producers[0] + 1) - 1;
+    EXPECT_FALSE(shareCacheLine(lastProducerByte, &producers[1]));
+    const auto* lastConsumerByte = reinterpret_cast<const char*>(&consumers[0] + 1) - 1;
+    EXPECT_FALSE(shareCacheLine(lastConsumerByte, &consumers[1]));
+}
+
+// Test Case 2: a poll sees the flag within kInterval calls, and keeps seeing it
+TEST(PipelineLayout, CompletionPollTest)
+{
+    std::atomic_bool flag(false);
+    core::CompletionPoll poll(flag);
+    EXPECT_FALSE(poll.done());
+
+    flag.store(true);
+    unsigned calls = 1;
+    while (!poll.done())
+    {
+        ++calls;
+    }
+    EXPECT_LE(calls, core::CompletionPoll::kInterval);
+
+    flag.store(false);
+    EXPECT_TRUE(poll.done());
+    EXPECT_TRUE(poll.doneNow());
+}
+
+// Test Case 3: batched consumers claim blocks of orders and still give each order exactly once
+TEST(PipelineLayout, BatchedOrdersTest)
+{
+    const int elements = 20000;
+    PipelineSetup setup;
+    setup.m_capacity = 1024;
+    setup.m_seed = 7;
+    setup.m_batchSize = 64;
+    TestPipeline<Queue> pipeline(elements, setup);
+    pipeline.run();
+
+    const core::NumberStorage& storage = pipeline.storage();
+    std::vector<int> counts(elements + 1);
+    for (int value = 1; value <= elements; ++value)
+    {
+        const size_t order = storage.order(value);
+        ASSERT_GE(order, 1U);
+        ASSERT_LE(order, static_cast<size_t>(elements));
+        counts[order]++;
+    }
+    for (int order = 1; order <= elements; ++order)
+    {
+        EXPECT_EQ(counts[order], 1) << "order " << order;
+    }
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "random_engines.h"
+#include "random_source.h"
+
+namespace
+{
+
+constexpr std::array<core::RandomEngine, 5> kEngines = {
+    core::RandomEngine::Standard, core::RandomEngine::Xoshiro256, core::RandomEngine::Pcg64,
+    core::RandomEngine::Xoshiro256x4, core::RandomEngine::Philox};
+
+}  // namespace
+
+// Test Case 1: xoshiro256** matches the reference implementation
+TEST(RandomSource, XoshiroReferenceTest)
+{
+    core::Xoshiro256StarStar generator(std::array<uint64_t, 4>{1, 2, 3, 4});
+
+    // rotl(2 * 5, 7) * 9
+    EXPECT_EQ(generator(), 11520);
+    // rotl(s1 * 5, 7) * 9 with s1 = 2 ^ (3 ^ 1) = 0 after the first step
+    EXPECT_EQ(generator(), 0);
+}
+
+// Test Case 2: the SIMD lanes produce the jump() streams of the scalar generator
+TEST(RandomSource, SimdLanesMatchScalarStreamsTest)
+{
+    const uint64_t seed = 99;
+    core::Xoshiro256x4 simd(seed, 1);
+    std::vector<uint64_t> values(4 * 10);
+    simd.fill(values);
+
+    core::Xoshiro256StarStar scalar(seed);
+    for (size_t i = 0; i < core::Xoshiro256x4::kLanes; ++i)
+    {
+        scalar.jump();
+    }
+    for (size_t lane = 0; lane < core::Xoshiro256x4::kLanes; ++lane)
+    {
+        core::Xoshiro256StarStar stream = scalar;
+        for (size_t i = 0; i < 10; ++i)
+        {
+            ASSERT_EQ(values[i * core::Xoshiro256x4::kLanes + lane], stream())
+                << "lane " << lane << ", output " << i;
+        }
+        scalar.jump();
+    }
+}
+
+// Test Case 3: every engine covers 1..elements and nothing else
+TEST(RandomSource, RangeTest)
+{
+    const int elements = 10;
+    for (auto engine : kEngines)
+    {
+        core::RandomSource random(engine, elements, 5, 0);
+        std::vector<int> counts(elements + 1);
+        for (int i = 0; i < 10000; ++i)
+        {
+            const int value = random.next();
+            ASSERT_GE(value, 1);
+            ASSERT_LE(value, elements);
+            counts[value]++;
+        }
+        for (int value = 1; value <= elements; ++value)
+        {
+            // 1000 expected, far more than 5 standard deviations away
+            EXPECT_GT(counts[value], 800) << "value " << value;
+            EXPECT_LT(counts[value], 1200) << "value " << value;
+        }
+    }
+}
+
+// Test Case 4: streams of the same seed differ, the same stream repeats
+TEST(RandomSource, StreamsTest)
+{
+    for (auto engine : kEngines)
+    {
+        std::vector<int> first(100);
+        std::vector<int> same(100);
+        std::vector<int> other(100);
+        core::RandomSource(engine, 1 << 30, 7, 0).fill(first);
+        core::RandomSource(engine, 1 << 30, 7, 0).fill(same);
+        core::RandomSource(engine, 1 << 30, 7, 1).fill(other);
+
+        EXPECT_EQ(first, same);
+        EXPECT_NE(first, other);
+    }
+}
+
+// Test Case 5: 64-bit numbers cover ranges beyond 2^32 and stay within them
+TEST(RandomSource, WideRangeTest)
+{
+    const uint64_t elements = (uint64_t{3} << 40) + 7;
+    for (auto engine : kEngines)
+    {
+        core::RandomSource random(engine, elements, 5, 0);
+        uint64_t largest = 0;
+        for (int i = 0; i < 10000; ++i)
+        {
+            const uint64_t value = random.next<uint64_t>();
+            ASSERT_GE(value, 1U);
+            ASSERT_LE(value, elements);
+            largest = std::max(largest, value);
+        }
+        // The largest of 10000 draws is within 0.1% of the top with overwhelming probability
+        EXPECT_GT(largest, elements / 1000 * 999);
+
+        core::RandomSource small(engine, 10, 5, 1);
+        std::vector<int> counts(11);
+        for (int i = 0; i < 10000; ++i)
+        {
+            const uint64_t value = small.next<uint64_t>();
+            ASSERT_GE(value, 1U);
+            ASSERT_LE(value, 10U);
+            counts[value]++;
+        }
+        for (int value = 1; value <= 10; ++value)
+        {
+            EXPECT_GT(counts[value], 800) << "value " << value;
+            EXPECT_LT(counts[value], 1200) << "value " << value;
+        }
+    }
+}
+
+// Test Case 6: Philox4x32-10 matches the Random123 known answers, and seek() jumps to a block
+TEST(RandomSource, PhiloxReferenceTest)
+{
+    EXPECT_EQ(core::Philox4x32::block({0, 0}, {0, 0, 0, 0}),
+              (core::Philox4x32::Block{0x6627E8D5, 0xE169C58D, 0xBC57AC4C, 0x9B00DBD8}));
+    EXPECT_EQ(core::Philox4x32::block({0xFFFFFFFF, 0xFFFFFFFF},
+                                      {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}),
+              (core::Philox4x32::Block{0x408F276D, 0x41C83B0E, 0xA20BC7C6, 0x6D5451FD}));
+
+    core::Philox4x32 generator(0, 0);
+    EXPECT_EQ(generator(), 0xE169C58D6627E8D5ULL);
+    EXPECT_EQ(generator(), 0x9B00DBD8BC57AC4CULL);
+
+    core::Philox4x32 sequential(42, 3);
+    std::vector<uint64_t> outputs(20);
+    for (auto& output : outputs)
+    {
+        output = sequential();
+    }
+    core::Philox4x32 seeking(42, 3);
+    seeking.seek(7);
+    EXPECT_EQ(seeking(), outputs[14]);
+    EXPECT_EQ(seeking(), outputs[15]);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "pipeline_harness.h"
+#include "remaining_sampler.h"
+#include "thread_safe_queue.h"
+
+// Test Case 1: the slices hold every missing number exactly once
+TEST(RemainingSampler, SlicesCoverMissingNumbersTest)
+{
+    const int elements = 1000;
+    core::NumberStorage storage(elements);
+    for (int value = 1; value <= elements; ++value)
+    {
+        if (value % 7 != 0)
+        {
+            (void)storage.tryMark(value);
+        }
+    }
+
+    const size_t producersNr = 3;
+    core::RemainingSampler sampler(storage, producersNr, 0.9, 1);
+    EXPECT_FALSE(sampler.active());
+    std::vector<uint64_t> taken;
+    for (size_t i = 0; i < producersNr; ++i)
+    {
+        const std::vector<uint64_t> slice = sampler.takeSlice();
+        taken.insert(taken.end(), slice.begin(), slice.end());
+    }
+    EXPECT_TRUE(sampler.active());
+    EXPECT_TRUE(sampler.takeSlice().empty());
+
+    std::sort(taken.begin(), taken.end());
+    ASSERT_EQ(taken.size(), static_cast<size_t>(elements / 7));
+    for (size_t i = 0; i < taken.size(); ++i)
+    {
+        EXPECT_EQ(taken[i], 7 * (i + 1));
+    }
+}
+
+// Test Case 2: the sampler switches after a window of probes that mostly miss
+TEST(RemainingSampler, SwitchesOnMissRateTest)
+{
+    const int elements = 100;
+    core::NumberStorage storage(elements);
+    for (int value = 1; value <= 80; ++value)
+    {
+        (void)storage.tryMark(value);
+    }
+    core::RemainingSampler sampler(storage, 1, 0.9, 1);
+    core::RemainingSampler::Monitor monitor;
+    const unsigned drawsPerWindow =
+        core::RemainingSampler::kProbeInterval * core::RemainingSampler::kWindow;
+
+    // 80% misses stay below the threshold
+    for (unsigned i = 0; i < drawsPerWindow; ++i)
+    {
+        sampler.observe(monitor, static_cast<int>(i % elements) + 1);
+    }
+    EXPECT_FALSE(sampler.active());
+
+    // Only misses switch it
+    for (unsigned i = 0; i < drawsPerWindow; ++i)
+    {
+        sampler.observe(monitor, 1);
+    }
+    EXPECT_TRUE(sampler.active());
+}
+
+// Test Case 3: adaptive producers complete the run with far fewer draws
+TEST(RemainingSampler, AdaptiveProducersTest)
+{
+    const int elements = 20000;
+    core::NumberStorage storage(elements);
+    core::RemainingSampler sampler(storage, 2, 0.5, 1);
+    PipelineSetup setup;
+    setup.m_capacity = 256;
+    setup.m_seed = 9;
+    setup.m_remaining = &sampler;
+    TestPipeline<core::ThreadSafeQueue<int>> pipeline(elements, setup, &storage);
+    pipeline.run();
+
+    EXPECT_TRUE(sampler.active());
+    EXPECT_TRUE(storage.unmarked().empty());
+    // Uniform draws alone would take about ln(20000) ~ 10 draws per number
+    const uint64_t draws = pipeline.producers()[0].draws() + pipeline.producers()[1].draws();
+    EXPECT_LT(draws, 3U * elements);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "output_sink.h"
+#include "result_file.h"
+
+namespace
+{
+
+/**
+ * @brief Returns a path for a temporary result file, unique to the process.
+ */
+std::string temporaryPath(const char* name)
+{
+    return std::format("{}/{}_{}.bin", ::testing::TempDir(), name, ::getpid());
+}
+
+}  // namespace
+
+// Test Case 1: numbers stored by concurrent writers round trip as a complete permutation
+TEST(MappedResultFile, WriteAndVerifyTest)
+{
+    const std::string path = temporaryPath("result_file");
+    constexpr size_t kElements = 10000;
+    {
+        auto file = core::MappedResultFile::create(path, kElements, true);
+        ASSERT_TRUE(file.has_value());
+        {
+            core::OutputSink sink(*file);
+            EXPECT_EQ(sink.format(), core::OutputFormat::Mapped);
+
+            // Two writers emit the odd and even orders, number = N + 1 - order
+            std::vector<std::thread> threads;
+            for (size_t parity = 0; parity < 2; ++parity)
+            {
+                threads.emplace_back(
+                    [&sink, parity]()
+                    {
+                        core::OutputSink::Writer writer(sink);
+                        for (size_t order = 1 + parity; order <= kElements; order += 2)
+                        {
+                            writer.write(static_cast<int>(kElements + 1 - order), order, 2);
+                        }
+                    });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+        // Not finished yet
+        EXPECT_TRUE(file->verify().has_value());
+        file->finish(kElements);
+    }
+
+    const auto file = core::MappedResultFile::open(path);
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->elements(), kElements);
+    EXPECT_EQ(file->emitted(), kElements);
+    EXPECT_FALSE(file->verify().has_value());
+    EXPECT_EQ(file->sequence()[0], static_cast<int>(kElements));
+    EXPECT_EQ(file->orders()[0], kElements);
+    EXPECT_EQ(file->totalGenerationTime(), 2 * static_cast<long long>(kElements));
+    std::remove(path.c_str());
+}
+
+// Test Case 2: duplicates are reported, and files without a valid header are rejected
+TEST(MappedResultFile, RejectTest)
+{
+    const std::string path = temporaryPath("result_file_duplicate");
+    {
+        auto file = core::MappedResultFile::create(path, 3, false);
+        ASSERT_TRUE(file.has_value());
+        EXPECT_FALSE(file->recordsTimes());
+        EXPECT_TRUE(file->times().empty());
+        file->record(1, 1, 0);
+        file->record(2, 2, 0);
+        file->record(2, 3, 0);
+        file->finish(3);
+        const auto problem = file->verify();
+        ASSERT_TRUE(problem.has_value());
+        EXPECT_EQ(problem->rfind("number 2 ", 0), 0U);
+    }
+
+    // Truncated to a size the header does not describe
+    ASSERT_EQ(::truncate(path.c_str(), 40), 0);
+    EXPECT_FALSE(core::MappedResultFile::open(path).has_value());
+    std::remove(path.c_str());
+    EXPECT_FALSE(core::MappedResultFile::open(path).has_value());
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "sharded_pipeline.h"
+
+// Test Case 1: the shards are disjoint and cover the whole range
+TEST(ShardedPipeline, ShardSizeTest)
+{
+    for (size_t consumers = 1; consumers <= 5; ++consumers)
+    {
+        ShardedQueues queues(1, consumers, 4);
+        for (size_t elements : {1UL, 3UL, 4UL, 17UL, 1000UL, 5000UL})
+        {
+            std::vector<size_t> expected(consumers);
+            for (size_t value = 1; value <= elements; ++value)
+            {
+                expected[queues.shardOf(static_cast<int>(value))]++;
+            }
+            for (size_t consumer = 0; consumer < consumers; ++consumer)
+            {
+                EXPECT_EQ(queues.shardSize(consumer, elements), expected[consumer])
+                    << consumers << " consumers, " << elements << " elements";
+            }
+        }
+    }
+}
+
+// Test Case 2: every number is generated exactly once and the orders are 1..N
+TEST(ShardedPipeline, GeneratesAllNumbersTest)
+{
+    const int elements = 5000;
+    ShardedQueues queues(2, 3, 16);
+    core::NumberStorage storage(elements);
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+    std::atomic_bool completed(false);
+
+    std::vector<ShardedProducer> producers;
+    std::vector<ShardedConsumer> consumers;
+    for (size_t i = 0; i < queues.producersNr(); ++i)
+    {
+        producers.emplace_back(queues, i,
+                               core::RandomSource(core::RandomEngine::Xoshiro256, elements, 1, i),
+                               completed);
+    }
+    for (size_t i = 0; i < queues.consumersNr(); ++i)
+    {
+        consumers.emplace_back(queues, i, storage, sink, elements, completed, 4);
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& producer : producers)
+    {
+        threads.emplace_back([&producer]() { producer.produce(); });
+    }
+    for (auto& consumer : consumers)
+    {
+        threads.emplace_back([&consumer]() { consumer.consume(); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_TRUE(completed.load());
+    std::vector<int> orders(elements + 1);
+    for (int value = 1; value <= elements; ++value)
+    {
+        const size_t order = storage.order(value);
+        ASSERT_GE(order, 1);
+        ASSERT_LE(order, elements);
+        orders[order]++;
+    }
+    for (int order = 1; order <= elements; ++order)
+    {
+        EXPECT_EQ(orders[order], 1) << "order " << order;
+    }
+}
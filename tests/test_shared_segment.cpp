@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdio>
+#include <format>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "output_sink.h"
+#include "result_file.h"
+#include "shared_pipeline.h"
+#include "shared_segment.h"
+
+namespace
+{
+
+/**
+ * @brief Returns a name for a shared segment, unique to the process.
+ */
+std::string segmentName(const char* name)
+{
+    return std::format("/{}_{}", name, ::getpid());
+}
+
+}  // namespace
+
+// Test Case 1: two mappings of a segment see the same ring and bitset, and the creator removes it
+TEST(SharedSegment, CreateAndOpenTest)
+{
+    const std::string name = segmentName("shared_segment");
+    {
+        auto creator = core::SharedSegment::create(name, 1000, 100);
+        ASSERT_TRUE(creator.has_value());
+        EXPECT_EQ(creator->capacity(), 128U);
+        EXPECT_FALSE(core::SharedSegment::create(name, 1000, 100).has_value());
+
+        // A second mapping, at another address, as another process would have
+        auto other = core::SharedSegment::open(name);
+        ASSERT_TRUE(other.has_value());
+        EXPECT_EQ(other->elements(), 1000U);
+        EXPECT_EQ(other->capacity(), 128U);
+
+        const std::array<int, 3> pushed = {7, 8, 9};
+        EXPECT_EQ(creator->tryPushBulk(pushed), pushed.size());
+        std::array<int, 8> popped{};
+        ASSERT_EQ(other->tryPopBulk(popped), pushed.size());
+        EXPECT_EQ(popped[0], 7);
+        EXPECT_EQ(popped[2], 9);
+        EXPECT_EQ(creator->tryPopBulk(popped), 0U);
+
+        EXPECT_TRUE(other->tryMark(1000));
+        EXPECT_FALSE(creator->tryMark(1000));
+
+        // The ring is bounded
+        std::vector<int> values(200, 1);
+        EXPECT_EQ(creator->tryPushBulk(values), 128U);
+        EXPECT_EQ(other->tryPushBulk(values), 0U);
+    }
+    EXPECT_FALSE(core::SharedSegment::open(name).has_value());
+}
+
+// Test Case 2: forked producer and consumer processes generate a complete permutation
+TEST(SharedSegment, ForkedWorkersTest)
+{
+    constexpr size_t kElements = 20000;
+    constexpr size_t kProducersNr = 2;
+    constexpr size_t kConsumersNr = 2;
+    const std::string path = std::format("{}/shared_segment_{}.bin", ::testing::TempDir(),
+                                         ::getpid());
+    auto file = core::MappedResultFile::create(path, kElements, false);
+    ASSERT_TRUE(file.has_value());
+    auto segment = core::SharedSegment::create(segmentName("forked_workers"), kElements, 256);
+    ASSERT_TRUE(segment.has_value());
+    initializeSharedStartTime(*segment);
+
+    std::vector<pid_t> children;
+    for (size_t i = 0; i < kProducersNr + kConsumersNr; ++i)
+    {
+        const pid_t pid = ::fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0)
+        {
+            if (i < kProducersNr)
+            {
+                produceShared(*segment,
+                              core::RandomSource(core::RandomEngine::Xoshiro256, kElements, 5, i),
+                              32);
+            }
+            else
+            {
+                core::OutputSink sink(*file);
+                consumeShared(*segment, sink, 32);
+            }
+            ::_exit(0);
+        }
+        children.push_back(pid);
+    }
+    for (const pid_t child : children)
+    {
+        int status = 0;
+        ASSERT_EQ(::waitpid(child, &status, 0), child);
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    EXPECT_TRUE(segment->completed().load());
+    file->finish(kElements);
+    const auto problem = file->verify();
+    EXPECT_FALSE(problem.has_value()) << *problem;
+    std::remove(path.c_str());
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "spsc_queue.h"
+
+// Test Case 1: tryPush and tryPop success
+TEST(SpscQueue, PushAndPopSuccessTest)
+{
+    core::SpscQueue<int> queue(4);
+    int value;
+
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+
+    // Popping elements and verifying FIFO order
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+// Test Case 2: tryPush fails on a full queue
+TEST(SpscQueue, PushUntilFailureTest)
+{
+    core::SpscQueue<int> queue(3);
+    int value;
+
+    EXPECT_EQ(queue.capacity(), 4);
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_TRUE(queue.tryPush(4));
+}
+
+// Test Case 3: bulk operations are partial on a nearly full or nearly empty ring
+TEST(SpscQueue, BulkPushAndPopWrapAroundTest)
+{
+    core::SpscQueue<int> queue(4);
+    std::vector<int> input{1, 2, 3};
+    std::vector<int> output(3);
+
+    for (int round = 0; round < 10; ++round)
+    {
+        EXPECT_EQ(queue.tryPushBulk(std::span<const int>(input)), 3);
+        EXPECT_EQ(queue.tryPushBulk(std::span<const int>(input)), 1);
+        EXPECT_EQ(queue.tryPopBulk(std::span<int>(output)), 3);
+        EXPECT_EQ(output, input);
+        EXPECT_EQ(queue.tryPopBulk(std::span<int>(output)), 1);
+        EXPECT_EQ(output[0], 1);
+    }
+}
+
+// Test Case 4: one producer and one consumer keep FIFO order under concurrency
+TEST(SpscQueue, ConcurrentFifoOrderTest)
+{
+    core::SpscQueue<int> queue(16);
+    const int numValues = 100000;
+
+    std::thread producer(
+        [&]()
+        {
+            for (int i = 0; i < numValues; ++i)
+            {
+                while (!queue.tryPush(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    int expected = 0;
+    std::vector<int> batch(8);
+    while (expected < numValues)
+    {
+        const size_t popped = queue.tryPopBulk(std::span<int>(batch));
+        for (size_t i = 0; i < popped; ++i)
+        {
+            ASSERT_EQ(batch[i], expected);
+            ++expected;
+        }
+        if (popped == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "thread_pinning.h"
+
+// Test Case 1: CPU lists with single numbers and ranges
+TEST(ThreadPinning, ParseCpuListTest)
+{
+    EXPECT_EQ(core::parseCpuList("3"), std::vector<int>({3}));
+    EXPECT_EQ(core::parseCpuList("0,2,4-7"), std::vector<int>({0, 2, 4, 5, 6, 7}));
+    EXPECT_EQ(core::parseCpuList("8-9,1\n"), std::vector<int>({8, 9, 1}));
+}
+
+// Test Case 2: invalid CPU lists
+TEST(ThreadPinning, ParseInvalidCpuListTest)
+{
+    EXPECT_TRUE(core::parseCpuList("").empty());
+    EXPECT_TRUE(core::parseCpuList("1,").empty());
+    EXPECT_TRUE(core::parseCpuList("5-3").empty());
+    EXPECT_TRUE(core::parseCpuList("a").empty());
+    EXPECT_TRUE(core::parseCpuList("-1").empty());
+}
+
+// Test Case 3: pinning specifications
+TEST(ThreadPinning, ParseSpecificationTest)
+{
+    EXPECT_FALSE(core::ThreadPinning().enabled());
+    EXPECT_FALSE(core::ThreadPinning::parse("sockets").has_value());
+    EXPECT_FALSE(core::ThreadPinning::parse("cores:").has_value());
+
+    const auto pinning = core::ThreadPinning::parse("cores:2,5");
+    ASSERT_TRUE(pinning.has_value());
+    EXPECT_TRUE(pinning->enabled());
+    // Workers are assigned round robin to the listed CPUs
+    EXPECT_EQ(pinning->describe(0), "2");
+    EXPECT_EQ(pinning->describe(1), "5");
+    EXPECT_EQ(pinning->describe(2), "2");
+
+    const auto numa = core::ThreadPinning::parse("numa");
+    ASSERT_TRUE(numa.has_value());
+    EXPECT_TRUE(numa->enabled());
+}
+
+// Test Case 4: the calling thread can be pinned to a CPU it may run on
+TEST(ThreadPinning, PinCurrentThreadTest)
+{
+    const auto pinning = core::ThreadPinning::parse("cores");
+    ASSERT_TRUE(pinning.has_value());
+#ifdef __linux__
+    // Pin a separate thread, threads started later by the tests inherit the affinity
+    std::thread worker([&]() { EXPECT_TRUE(pinning->pinCurrentThread(0)); });
+    worker.join();
+#endif
+}
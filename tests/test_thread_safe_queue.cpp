@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <thread>
+#include <vector>
 
 #include "thread_safe_queue.h"
 
@@ -203,4 +204,42 @@ TEST(ThreadSafeQueue, FullQueueConcurrentPushTest)
 
     // All pushes should fail
     EXPECT_EQ(failedPushes.load(), numThreads);
-}
\ No newline at end of file
+}
+
+// Test Case 9: tryPushBulk and tryPopBulk success
+TEST(ThreadSafeQueue, BulkPushAndPopSuccessTest)
+{
+    core::ThreadSafeQueue<int> queue(8);
+    const std::vector<int> input{1, 2, 3, 4, 5};
+    std::vector<int> output(8);
+
+    EXPECT_EQ(queue.tryPushBulk(input), input.size());
+
+    // Popping more than available returns only what was in the queue, in FIFO order
+    EXPECT_EQ(queue.tryPopBulk(output), input.size());
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        EXPECT_EQ(output[i], input[i]);
+    }
+    EXPECT_EQ(queue.tryPopBulk(output), 0);
+}
+
+// Test Case 10: tryPushBulk only pushes the prefix that fits
+TEST(ThreadSafeQueue, BulkPushPartialTest)
+{
+    core::ThreadSafeQueue<int> queue(4);
+    const std::vector<int> input{1, 2, 3, 4, 5, 6};
+    int value;
+
+    EXPECT_TRUE(queue.tryPush(0));
+    EXPECT_EQ(queue.tryPushBulk(input), 3);
+    EXPECT_EQ(queue.tryPushBulk(input), 0);
+    EXPECT_FALSE(queue.tryPush(7));
+
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 0);
+    std::vector<int> output(2);
+    EXPECT_EQ(queue.tryPopBulk(output), 2);
+    EXPECT_EQ(output[0], 1);
+    EXPECT_EQ(output[1], 2);
+}
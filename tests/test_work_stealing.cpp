@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include "work_stealing.h"
+
+// Test Case 1: every number is generated once, with the orders 1..N, on an uneven split
+TEST(WorkStealing, GeneratesAllNumbersTest)
+{
+    // Neither the chunk size nor the 3 workers divide the range
+    const int elements = 5 * static_cast<int>(WorkStealingScheduler::kChunkSize) + 123;
+    core::NumberStorage storage(elements);
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+    WorkStealingScheduler scheduler(storage, sink, elements, core::RandomEngine::Xoshiro256, 11,
+                                    3);
+    EXPECT_EQ(scheduler.chunksNr(), 6U);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < scheduler.workersNr(); ++i)
+    {
+        threads.emplace_back([&scheduler, i]() { scheduler.work(i); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    size_t chunksRun = 0;
+    for (size_t i = 0; i < scheduler.workersNr(); ++i)
+    {
+        chunksRun += scheduler.chunksRun(i);
+    }
+    EXPECT_EQ(chunksRun, scheduler.chunksNr());
+
+    std::vector<bool> orders(elements + 1);
+    for (int value = 1; value <= elements; ++value)
+    {
+        ASSERT_TRUE(storage.isMarked(value)) << "value " << value;
+        const size_t order = storage.order(value);
+        ASSERT_GE(order, 1U);
+        ASSERT_LE(order, static_cast<size_t>(elements));
+        EXPECT_FALSE(orders[order]);
+        orders[order] = true;
+    }
+}
+
+// Test Case 2: a worker that starts late finds its chunks stolen
+TEST(WorkStealing, StealsFromSlowWorkerTest)
+{
+    const int elements = 8 * static_cast<int>(WorkStealingScheduler::kChunkSize);
+    core::NumberStorage storage(elements);
+    core::OutputSink sink(core::OutputFormat::Quiet, STDOUT_FILENO);
+    WorkStealingScheduler scheduler(storage, sink, elements, core::RandomEngine::Pcg64, 5, 2);
+
+    // Worker 0 runs alone to the end, then worker 1 finds nothing left
+    std::thread([&scheduler]() { scheduler.work(0); }).join();
+    std::thread([&scheduler]() { scheduler.work(1); }).join();
+
+    EXPECT_EQ(scheduler.chunksRun(0), 8U);
+    EXPECT_EQ(scheduler.chunksStolen(0), 4U);
+    EXPECT_EQ(scheduler.chunksRun(1), 0U);
+    for (int value = 1; value <= elements; ++value)
+    {
+        ASSERT_TRUE(storage.isMarked(value)) << "value " << value;
+    }
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <latch>
+#include <thread>
+#include <vector>
+
+#include "worker_pool.h"
+
+// Test Case 1: the workers of a round run at the same time, each on a thread of its own
+TEST(WorkerPool, ConcurrentWorkersTest)
+{
+    constexpr size_t kWorkersNr = 4;
+    core::WorkerPool pool;
+    // Every worker waits for all the others, so running them one after the other would hang
+    std::latch started(kWorkersNr);
+    std::atomic<size_t> finished(0);
+    for (size_t i = 0; i < kWorkersNr; ++i)
+    {
+        EXPECT_EQ(pool.startedNr(), i);
+        pool.start(
+            [&started, &finished]()
+            {
+                started.arrive_and_wait();
+                ++finished;
+            });
+    }
+    pool.wait();
+
+    EXPECT_EQ(finished.load(), kWorkersNr);
+    EXPECT_EQ(pool.startedNr(), 0U);
+    EXPECT_EQ(pool.threadsNr(), kWorkersNr);
+}
+
+// Test Case 2: worker i of every round runs on the same thread, created once
+TEST(WorkerPool, ThreadsKeptAcrossRoundsTest)
+{
+    core::WorkerPool pool;
+    std::vector<std::thread::id> firstRound(3);
+    for (size_t i = 0; i < firstRound.size(); ++i)
+    {
+        pool.start([&firstRound, i]() { firstRound[i] = std::this_thread::get_id(); });
+    }
+    pool.wait();
+
+    for (int round = 0; round < 100; ++round)
+    {
+        // Rounds with fewer workers leave the other threads parked
+        const size_t workersNr = 1 + static_cast<size_t>(round) % firstRound.size();
+        std::vector<std::thread::id> ids(workersNr);
+        for (size_t i = 0; i < workersNr; ++i)
+        {
+            pool.start([&ids, i]() { ids[i] = std::this_thread::get_id(); });
+        }
+        pool.wait();
+        for (size_t i = 0; i < workersNr; ++i)
+        {
+            ASSERT_EQ(ids[i], firstRound[i]) << "round " << round << ", worker " << i;
+        }
+    }
+    EXPECT_EQ(pool.threadsNr(), firstRound.size());
+
+    // A larger round adds threads
+    for (size_t i = 0; i < 5; ++i)
+    {
+        pool.start([]() {});
+    }
+    pool.wait();
+    EXPECT_EQ(pool.threadsNr(), 5U);
+}
@@ -0,0 +1,51 @@
+#include <format>
+#include <iostream>
+#include <string>
+
+#include "result_file.h"
+
+/**
+ * @brief Checks that result files written with --format=mapped hold complete permutations.
+ *
+ * Usage: verify_result_file PATH...
+ * Returns 0 if every file is complete, 1 otherwise.
+ */
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " PATH...\n";
+        return 1;
+    }
+
+    int status = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string path = argv[i];
+        const auto file = core::MappedResultFile::open(path);
+        if (!file)
+        {
+            std::cout << std::format("{}: not a result file.\n", path);
+            status = 1;
+            continue;
+        }
+        if (const auto problem = file->verify())
+        {
+            std::cout << std::format("{}: incomplete, {}.\n", path, *problem);
+            status = 1;
+            continue;
+        }
+        if (file->recordsTimes())
+        {
+            std::cout << std::format(
+                "{}: complete permutation of 1..{}, total generation time {} microseconds.\n",
+                path, file->elements(), file->totalGenerationTime());
+        }
+        else
+        {
+            std::cout << std::format("{}: complete permutation of 1..{}.\n", path,
+                                     file->elements());
+        }
+    }
+    return status;
+}